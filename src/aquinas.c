@@ -18,37 +18,118 @@
 
 #include "state.h"
 #include "tests.h"
+#include "benchmarks.h"
+#include "runner.h"
 
-void run_tests(void) {
-//    test_expi();
-//    test_lni();
-//    test_log10i();
-//    test_sigbits();
-//    test_digits();
-//    test_to_digits();
-//    test_bittrie();
-//    test_binary_trie();
-//    test_map();
-//    test_cpuid();
-//    test_dynarray();
-//    test_umap();
-//    test_square_wave();
-//    test_udiv();
-//    test_umod();
-//    test_fp_math();
-//    test_data_byte_order();
-//    test_w32_memory_allocator();
-//    test_m_pointer_offset();
-    test_w32_stack_allocator();
-}
+static runner_entry const entries[] = {
+        RUNNER_TEST("expi", test_expi),
+        RUNNER_TEST("lni", test_lni),
+        RUNNER_TEST("log10i", test_log10i),
+        RUNNER_TEST("sigbits", test_sigbits),
+        RUNNER_TEST("digits", test_digits),
+        RUNNER_TEST("to_digits", test_to_digits),
+        RUNNER_TEST("map", test_map),
+        RUNNER_TEST("cpuid", test_cpuid),
+        RUNNER_TEST("cpu_topology", test_cpu_topology),
+        RUNNER_TEST("timer", test_timer),
+        RUNNER_TEST("perf_counters", test_perf_counters),
+        RUNNER_TEST("runner", test_runner),
+        RUNNER_TEST("baseline", test_baseline),
+        RUNNER_TEST("dynarray", test_dynarray),
+        RUNNER_TEST("square_wave", test_square_wave),
+        RUNNER_TEST("udiv", test_udiv),
+        RUNNER_TEST("umod", test_umod),
+        RUNNER_TEST("fp_math", test_fp_math),
+        RUNNER_TEST("frc_literals", test_frc_literals),
+        RUNNER_TEST("frc_pack", test_frc_pack),
+        RUNNER_TEST("fix_math", test_fix_math),
+        RUNNER_TEST("batch_math", test_batch_math),
+        RUNNER_TEST("logger", test_logger),
+        RUNNER_TEST("context_stack", test_context_stack),
+        RUNNER_TEST("trace", test_trace),
+        RUNNER_TEST("compiler_metrics", test_compiler_metrics),
+        RUNNER_TEST("tasks", test_tasks),
+        RUNNER_TEST("queues", test_queues),
+        RUNNER_TEST("epoch", test_epoch),
+        RUNNER_TEST("workload", test_workload),
+        RUNNER_TEST("pipeline", test_pipeline),
+        RUNNER_TEST("file_reader", test_file_reader),
+        RUNNER_TEST("emitter", test_emitter),
+        RUNNER_TEST("dictionary", test_dictionary),
+        RUNNER_TEST("allocation_profile", test_allocation_profile),
+        RUNNER_TEST("profile", test_profile),
+        RUNNER_TEST("data_byte_order", test_data_byte_order),
+        RUNNER_TEST("w32_memory_allocator", test_w32_memory_allocator),
+        RUNNER_TEST("m_pointer_offset", test_m_pointer_offset),
+        RUNNER_TEST("w32_stack_allocator", test_w32_stack_allocator),
 
+        RUNNER_BENCHMARK("sigbits", bench_sigbits),
+        RUNNER_BENCHMARK("btt_read", bench_btt_read),
+        RUNNER_BENCHMARK("fix_mul", bench_fix_mul),
+        RUNNER_BENCHMARK("fix_div", bench_fix_div),
+        RUNNER_BENCHMARK("frc_add", bench_frc_add),
+        RUNNER_BENCHMARK("fix_batch_add", bench_fix_batch_add),
+        RUNNER_BENCHMARK("context_push_pop", bench_context_push_pop),
+        RUNNER_BENCHMARK("context_metrics", bench_context_metrics),
+        RUNNER_BENCHMARK("spsc_batch", bench_spsc_batch),
+        RUNNER_BENCHMARK("mpmc_batch", bench_mpmc_batch),
+        RUNNER_BENCHMARK("epoch_enter_exit", bench_epoch_enter_exit),
+        RUNNER_BENCHMARK("epoch_retire", bench_epoch_retire),
+        RUNNER_BENCHMARK("task_spawn", bench_task_spawn),
+        RUNNER_BENCHMARK("task_parallel_for", bench_task_parallel_for),
+        RUNNER_BENCHMARK("trace_scope", bench_trace_scope),
+        RUNNER_BENCHMARK("p_get_time", bench_p_get_time),
+        RUNNER_BENCHMARK("e2e/generate", bench_e2e_generate),
+        RUNNER_BENCHMARK("e2e/tokenize", bench_e2e_tokenize),
+        RUNNER_BENCHMARK("e2e/pipeline", bench_e2e_pipeline),
+        RUNNER_BENCHMARK("e2e/build", bench_e2e_build),
+        RUNNER_BENCHMARK("e2e/convert", bench_e2e_convert),
+        RUNNER_BENCHMARK("file_read/uring", bench_file_read_uring),
+        RUNNER_BENCHMARK("file_read/threads", bench_file_read_threads),
+        RUNNER_BENCHMARK("emit/stdio", bench_emit_stdio),
+        RUNNER_BENCHMARK("emit/writev", bench_emit_writev),
+        RUNNER_BENCHMARK("emit/mmap", bench_emit_mmap),
+        BENCH_BIT_MATH,
+};
 
+/*
+ * Runs the tests and benchmarks selected on the command line (every test by default); see runner_parse.
+ */
 int main(int argc, char **argv) {
     info(__func__, "Running\n");
+    runner_options options;
+    runner_parse(&options, argc, argv);
+
+    // AQUINAS_TRACE=<file> records the run as Chrome trace JSON
+    char const *trace_path = getenv("AQUINAS_TRACE");
+    if (trace_path != NULL)
+        trace_start();
+    // AQUINAS_ALLOCATION_PROFILE=<file> samples allocations as folded stacks, one every AQUINAS_ALLOCATION_PERIOD bytes
+    char const *profile_path = getenv("AQUINAS_ALLOCATION_PROFILE");
+    if (profile_path != NULL) {
+        char const *period = getenv("AQUINAS_ALLOCATION_PERIOD");
+        m_profile_start(period != NULL ? strtoull(period, NULL, 10) : 524288);
+    }
+    // --profile=<file> samples the stacks of the run
+    if (options.profile != NULL && !profile_start(options.profile_frequency))
+        options.profile = NULL;
 #define PROJECT_AQUINAS_TEST_WIN32_MEMORY_ALLOCATOR 0
-    run_tests();
+    bool const passed = runner_run(entries, sizeof(entries) / sizeof(entries[0]), &options);
+    if (options.profile != NULL) {
+        profile_stop();
+        if (!profile_write(options.profile))
+            warnf(__func__, "unable to write profile to %s\n", options.profile);
+    }
+    if (trace_path != NULL && !trace_write(trace_path))
+        warnf(__func__, "unable to write trace to %s\n", trace_path);
+    if (profile_path != NULL) {
+        m_profile_stop();
+        if (!m_profile_write(profile_path))
+            warnf(__func__, "unable to write allocation profile to %s\n", profile_path);
+    }
     
-    return R_SUCCESS;
+    task_stop();
+    return passed ? R_SUCCESS : R_FAILURE;
 }
 
 //// 0111 01
@@ -0,0 +1,363 @@
+/*
+ * Module: baseline
+ * File: baseline.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "state.h"
+#include "baseline.h"
+
+#ifndef __VERSION__
+  #define __VERSION__ "unknown"
+#endif
+
+static void baseline_string(FILE *file, char const *string) {
+    fputc('"', file);
+    for (; *string != '\0'; string++) {
+        unsigned char const c = (unsigned char) *string;
+        if (c == '"' || c == '\\')
+            fprintf(file, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(file, "\\u%04x", c);
+        else
+            fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+static void baseline_environment(FILE *file, runner_options const *options) {
+    p_cpu_topology const *cpu = p_get_cpu_topology();
+
+    fputs("  \"environment\": {\n    \"platform\": ", file);
+    baseline_string(file, PLATFORM_NAME);
+    fputs(",\n    \"compiler\": ", file);
+    baseline_string(file, __VERSION__);
+    fprintf(file, ",\n    \"timestamp\": %lld,\n", (long long) time(NULL));
+    fprintf(file, "    \"repetitions\": %u,\n    \"warmup\": %u,\n    \"min_time_ns\": %llu\n  },\n",
+            options->repetitions, options->warmup, (unsigned long long) options->repetition_nanoseconds);
+
+    fputs("  \"cpu\": {\n    \"name\": ", file);
+    baseline_string(file, cpu->name);
+    fprintf(file, ",\n    \"logical_cores\": %u,\n    \"physical_cores\": %u,\n    \"packages\": %u,\n",
+            cpu->logical_cores, cpu->physical_cores, cpu->packages);
+    fprintf(file, "    \"l1d_bytes\": %llu,\n    \"l2_bytes\": %llu,\n    \"l3_bytes\": %llu,\n",
+            (unsigned long long) cpu->caches[P_CACHE_L1_DATA].size, (unsigned long long) cpu->caches[P_CACHE_L2].size,
+            (unsigned long long) cpu->caches[P_CACHE_L3].size);
+    fprintf(file, "    \"cycle_frequency\": %llu,\n    \"invariant_cycles\": %s\n  },\n",
+            (unsigned long long) p_get_cycle_frequency(), p_get_cycles_invariant() ? "true" : "false");
+}
+
+static void baseline_benchmark(FILE *file, runner_result const *result) {
+    fputs("    {\n      \"name\": ", file);
+    baseline_string(file, result->entry->name);
+    fprintf(file, ",\n      \"iterations\": %llu,\n      \"repetitions\": %u,\n",
+            (unsigned long long) result->iterations, result->repetitions);
+    fprintf(file, "      \"median_ns\": %.6g,\n      \"p99_ns\": %.6g,\n      \"mad_ns\": %.6g,\n"
+                  "      \"throughput\": %.6g,\n", result->median, result->p99, result->mad, result->throughput);
+    fprintf(file, "      \"bytes_per_second\": %.6g,\n      \"items_per_second\": %.6g,\n"
+                  "      \"peak_rss_growth_bytes\": %llu,\n", result->bytes_per_second, result->items_per_second,
+            (unsigned long long) result->peak_resident_growth);
+
+    fputs("      \"counters\": {", file);
+    bool first = true;
+    for (ubyte counter = 0; counter < PERF_COUNTERS; counter++) {
+        if (!result->counters.valid[counter])
+            continue;
+        fprintf(file, "%s\"%s\": %.6g", first ? "" : ", ", perf_counter_name(counter),
+                (double) result->counters.values[counter] / (double) result->counted_iterations);
+        first = false;
+    }
+
+    fputs("},\n      \"samples_ns\": [", file);
+    for (udword i = 0; i < result->repetitions; i++)
+        fprintf(file, "%s%.6g", i == 0 ? "" : ", ", result->samples[i]);
+    fputs("]\n    }", file);
+}
+
+bool baseline_write(char const *path, runner_result const *results, udword count, runner_options const *options) {
+    bool const standard = strcmp(path, "-") == 0;
+    FILE      *file = standard ? stdout : fopen(path, "w");
+    if (file == NULL) {
+        warnf(__func__, "unable to open %s\n", path);
+        return false;
+    }
+
+    fputs("{\n", file);
+    baseline_environment(file, options);
+    fputs("  \"benchmarks\": [", file);
+    bool first = true;
+    for (udword i = 0; i < count; i++) {
+        if (results[i].entry->kind != RUNNER_BENCHMARK || !results[i].passed)
+            continue;
+        fputs(first ? "\n" : ",\n", file);
+        baseline_benchmark(file, &results[i]);
+        first = false;
+    }
+    fputs("\n  ]\n}\n", file);
+
+    bool const written = !ferror(file);
+    if (standard)
+        fflush(file);
+    else if (fclose(file) != 0)
+        return false;
+    return written;
+}
+
+static char *baseline_load(char const *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+
+    uqword size = 0, capacity = 4096;
+    char  *text = malloc(capacity);
+    while (text != NULL) {
+        size += fread(text + size, 1, capacity - size - 1, file);
+        if (size < capacity - 1)
+            break;
+        capacity *= 2;
+        char *grown = realloc(text, capacity);
+        if (grown == NULL)
+            free(text);
+        text = grown;
+    }
+    fclose(file);
+    if (text != NULL)
+        text[size] = '\0';
+    return text;
+}
+
+/*
+ * Returns the value following `"key":` after `from` and before `end`, or NULL.
+ */
+static char const *baseline_value(char const *from, char const *end, char const *key) {
+    char quoted[BASELINE_NAME_LENGTH + 2];
+    snprintf(quoted, sizeof(quoted), "\"%s\"", key);
+    char const *found = strstr(from, quoted);
+    if (found == NULL || (end != NULL && found >= end))
+        return NULL;
+
+    found += strlen(quoted);
+    while (*found == ' ' || *found == '\t' || *found == '\r' || *found == '\n' || *found == ':')
+        found++;
+    return found;
+}
+
+bool baseline_read(char const *path, baseline *baseline) {
+    char *text = baseline_load(path);
+    if (text == NULL) {
+        warnf(__func__, "unable to read %s\n", path);
+        return false;
+    }
+
+    // the reader only understands the layout baseline_write produces: a name, then the samples, per benchmark
+    udword      read = 0;
+    char const *cursor = baseline_value(text, NULL, "benchmarks");
+    while (cursor != NULL && (cursor = baseline_value(cursor, NULL, "name")) != NULL && *cursor == '"') {
+        char        name[BASELINE_NAME_LENGTH];
+        char const *close = strchr(cursor + 1, '"');
+        if (close == NULL || (uqword) (close - cursor - 1) >= sizeof(name))
+            break;
+        memcpy(name, cursor + 1, (uqword) (close - cursor - 1));
+        name[close - cursor - 1] = '\0';
+
+        char const *next = strstr(close, "\"name\"");
+        char const *samples = baseline_value(close, next, "samples_ns");
+        cursor = close;
+        if (samples == NULL || *samples != '[')
+            continue;
+
+        udword count = 0, capacity = 64;
+        double *values = malloc(capacity * sizeof(double));
+        if (values == NULL)
+            fatalf(__func__, "unable to allocate samples\n");
+        for (char *number_end; *samples != ']'; samples = number_end) {
+            samples++;
+            double const value = strtod(samples, &number_end);
+            if (number_end == samples)
+                break;
+            if (count == capacity) {
+                capacity *= 2;
+                values = realloc(values, capacity * sizeof(double));
+                if (values == NULL)
+                    fatalf(__func__, "unable to allocate samples\n");
+            }
+            values[count++] = value;
+            while (*number_end == ' ' || *number_end == '\n')
+                number_end++;
+        }
+
+        baseline_add(baseline, name, values, count);
+        free(values);
+        read++;
+    }
+
+    free(text);
+    if (read == 0)
+        warnf(__func__, "%s holds no benchmarks\n", path);
+    return read != 0;
+}
+
+void baseline_add(baseline *baseline, char const *name, double const *samples, udword count) {
+    baseline_entry *entry = (baseline_entry *) baseline_find(baseline, name);
+    if (entry == NULL) {
+        if (baseline->count == baseline->capacity) {
+            baseline->capacity = baseline->capacity != 0 ? baseline->capacity * 2 : 16;
+            baseline->entries = realloc(baseline->entries, baseline->capacity * sizeof(baseline_entry));
+            if (baseline->entries == NULL)
+                fatalf(__func__, "unable to allocate baseline entries\n");
+        }
+        entry = &baseline->entries[baseline->count++];
+        *entry = (baseline_entry) {0};
+        snprintf(entry->name, sizeof(entry->name), "%s", name);
+    }
+
+    if (entry->count + count > entry->capacity) {
+        entry->capacity = entry->count + count;
+        entry->samples = realloc(entry->samples, entry->capacity * sizeof(double));
+        if (entry->samples == NULL)
+            fatalf(__func__, "unable to allocate samples\n");
+    }
+    memcpy(entry->samples + entry->count, samples, count * sizeof(double));
+    entry->count += count;
+}
+
+baseline_entry const *baseline_find(baseline const *baseline, char const *name) {
+    for (udword i = 0; i < baseline->count; i++)
+        if (strcmp(baseline->entries[i].name, name) == 0)
+            return &baseline->entries[i];
+    return NULL;
+}
+
+void baseline_free(baseline *baseline) {
+    for (udword i = 0; i < baseline->count; i++)
+        free(baseline->entries[i].samples);
+    free(baseline->entries);
+    *baseline = (struct baseline) {0};
+}
+
+typedef struct baseline_rank {
+    double value;
+    bool   after;
+} baseline_rank;
+
+static int baseline_rank_compare(void const *a, void const *b) {
+    double const x = ((baseline_rank const *) a)->value, y = ((baseline_rank const *) b)->value;
+    return (x > y) - (x < y);
+}
+
+static int baseline_double_compare(void const *a, void const *b) {
+    double const x = *(double const *) a, y = *(double const *) b;
+    return (x > y) - (x < y);
+}
+
+static double baseline_median(baseline_entry const *entry) {
+    double *sorted = malloc(entry->count * sizeof(double));
+    if (sorted == NULL)
+        fatalf(__func__, "unable to allocate samples\n");
+    memcpy(sorted, entry->samples, entry->count * sizeof(double));
+    qsort(sorted, entry->count, sizeof(double), baseline_double_compare);
+
+    udword const half = entry->count / 2;
+    double const median = entry->count & 1u ? sorted[half] : (sorted[half - 1] + sorted[half]) / 2;
+    free(sorted);
+    return median;
+}
+
+/*
+ * Two-sided p-value of the Mann-Whitney U test through the normal approximation, with midranks and the variance
+ * corrected for ties; with the dozens of samples a benchmark takes the approximation is close to the exact test.
+ */
+static double baseline_mann_whitney(baseline_entry const *before, baseline_entry const *after) {
+    udword const   n = before->count + after->count;
+    baseline_rank *ranks = malloc(n * sizeof(baseline_rank));
+    if (ranks == NULL)
+        fatalf(__func__, "unable to allocate ranks\n");
+    for (udword i = 0; i < before->count; i++)
+        ranks[i] = (baseline_rank) {before->samples[i], false};
+    for (udword i = 0; i < after->count; i++)
+        ranks[before->count + i] = (baseline_rank) {after->samples[i], true};
+    qsort(ranks, n, sizeof(baseline_rank), baseline_rank_compare);
+
+    double rank_sum = 0, ties = 0;
+    for (udword i = 0; i < n;) {
+        udword j = i;
+        while (j < n && ranks[j].value == ranks[i].value)
+            j++;
+        // samples i..j-1 are tied and share the mean of ranks i+1..j
+        double const rank = (i + 1 + j) / 2.0, tied = j - i;
+        for (udword k = i; k < j; k++)
+            if (ranks[k].after)
+                rank_sum += rank;
+        ties += tied * tied * tied - tied;
+        i = j;
+    }
+    free(ranks);
+
+    double const n1 = after->count, n2 = before->count;
+    double const u = rank_sum - n1 * (n1 + 1) / 2;
+    double const variance = n1 * n2 / 12 * ((n + 1) - ties / ((double) n * (n - 1)));
+    if (variance <= 0)
+        return 1;
+
+    // continuity correction towards the mean
+    double const deviation = fabs(u - n1 * n2 / 2);
+    double const z = (deviation > 0.5 ? deviation - 0.5 : 0) / sqrt(variance);
+    return erfc(z / sqrt(2));
+}
+
+baseline_comparison baseline_compare(baseline_entry const *before, baseline_entry const *after) {
+    baseline_comparison comparison = {.p = 1};
+    if (before->count == 0 || after->count == 0)
+        return comparison;
+
+    comparison.before = baseline_median(before);
+    comparison.after = baseline_median(after);
+    comparison.ratio = comparison.before > 0 ? comparison.after / comparison.before : 1;
+    comparison.p = baseline_mann_whitney(before, after);
+    return comparison;
+}
+
+bool baseline_report(baseline const *before, baseline const *after, double alpha, double threshold) {
+    udword regressions = 0, improvements = 0, compared = 0;
+
+    for (udword i = 0; i < after->count; i++) {
+        baseline_entry const *now = &after->entries[i];
+        baseline_entry const *then = baseline_find(before, now->name);
+        if (then == NULL) {
+            infof(__func__, "%s: not in the baseline\n", now->name);
+            continue;
+        }
+
+        baseline_comparison const comparison = baseline_compare(then, now);
+        bool const significant = comparison.p < alpha;
+        double const change = (comparison.ratio - 1) * 100;
+        compared++;
+
+        if (significant && comparison.ratio > 1 + threshold) {
+            warnf(__func__, "%s: REGRESSED %.3f ns -> %.3f ns (%+.2f%%, p = %.2g)\n", now->name, comparison.before,
+                  comparison.after, change, comparison.p);
+            regressions++;
+        } else if (significant && comparison.ratio < 1 - threshold) {
+            infof(__func__, "%s: improved %.3f ns -> %.3f ns (%+.2f%%, p = %.2g)\n", now->name, comparison.before,
+                  comparison.after, change, comparison.p);
+            improvements++;
+        } else {
+            infof(__func__, "%s: unchanged %.3f ns -> %.3f ns (%+.2f%%, p = %.2g)\n", now->name, comparison.before,
+                  comparison.after, change, comparison.p);
+        }
+    }
+
+    infof(__func__, "%u compared, %u regressed, %u improved\n", compared, regressions, improvements);
+    return regressions == 0;
+}
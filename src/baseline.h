@@ -0,0 +1,75 @@
+/*
+ * Module: baseline
+ * File: baseline.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Benchmark results as JSON (the environment, the processor, and for each benchmark its statistics, counters and raw
+ * samples), and the comparison of two sets of samples. A benchmark has regressed when its median is slower by more
+ * than a threshold and a two-sided Mann-Whitney U test rejects equal distributions at the chosen significance level;
+ * the test uses ranks, so it holds up against the long right tails which preemption and frequency changes give timings.
+ */
+
+#ifndef PROJECT_AQUINAS_BASELINE_H
+#define PROJECT_AQUINAS_BASELINE_H
+
+#include <stdbool.h>
+#include <platform.h>
+#include "runner.h"
+
+#define BASELINE_NAME_LENGTH 64
+
+typedef struct baseline_entry {
+    char    name[BASELINE_NAME_LENGTH];
+    // nanoseconds per iteration of every repetition
+    double *samples;
+    udword  count;
+    udword  capacity;
+} baseline_entry;
+
+typedef struct baseline {
+    baseline_entry *entries;
+    udword          count;
+    udword          capacity;
+} baseline;
+
+typedef struct baseline_comparison {
+    double before;
+    double after;
+    // median after over median before
+    double ratio;
+    // two-sided p-value of the Mann-Whitney U test
+    double p;
+} baseline_comparison;
+
+/*
+ * Writes the benchmarks among `results` with the environment they ran in. A path of "-" writes to stdout.
+ */
+bool baseline_write(char const *path, runner_result const *results, udword count, runner_options const *options);
+
+/*
+ * Adds the samples of a file written by baseline_write to `baseline`, pooling them with those of an entry of the same
+ * name. Returns false if the file cannot be read or holds no benchmarks.
+ */
+bool baseline_read(char const *path, baseline *baseline);
+
+void baseline_add(baseline *baseline, char const *name, double const *samples, udword count);
+
+baseline_entry const *baseline_find(baseline const *baseline, char const *name);
+
+void baseline_free(baseline *baseline);
+
+baseline_comparison baseline_compare(baseline_entry const *before, baseline_entry const *after);
+
+/*
+ * Logs the comparison of every benchmark in `after` which is also in `before`, warning about each regression, and
+ * returns whether there were none. `threshold` is the fraction by which a median must be slower to count.
+ */
+bool baseline_report(baseline const *before, baseline const *after, double alpha, double threshold);
+
+#endif //PROJECT_AQUINAS_BASELINE_H
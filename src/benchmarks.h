@@ -0,0 +1,595 @@
+/*
+ * Module: benchmarks
+ * File: benchmarks.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Benchmark bodies for the runner. Each runs the measured operation `iterations` times; inputs and results pass
+ * through runner_keep so that the work is neither folded into constants nor discarded.
+ */
+
+#ifndef PROJECT_AQUINAS_BENCHMARKS_H
+#define PROJECT_AQUINAS_BENCHMARKS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "state.h"
+#include "runner.h"
+#include "trace.h"
+#include "compiler.h"
+#include "task.h"
+#include "file_reader.h"
+#include "emitter.h"
+#include "queue.h"
+#include "memory/m_epoch.h"
+#include "fix_math.h"
+#include "frc_math.h"
+#include "batch_math.h"
+#include "bit_math.h"
+#include "bit_trie.h"
+#include "workload.h"
+#include "pipeline.h"
+#include "dictionary.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+
+static void bench_sigbits(uqword iterations) {
+    uqword value = 0x9E3779B97F4A7C15u;
+    for (uqword i = 0; i < iterations; i++) {
+        uqword bits = sigbits(value >> (i & 63u));
+        runner_keep(bits);
+    }
+}
+
+/*
+ * Reads pseudo-random addresses of a trie of depth 16 (16 KiB of bits, resident in L1 or L2).
+ */
+static void bench_btt_read(uqword iterations) {
+    static bit_trie *trie = NULL;
+    if (trie == NULL) {
+        uqword_pair pairs[256];
+        for (uqword i = 0; i < 256; i++)
+            pairs[i] = (uqword_pair) {(i * 0x9E3779B97F4A7C15u) >> 48, i & 1u};
+        trie = btt_create(pairs, 16, 256);
+    }
+
+    uqword address = 1;
+    for (uqword i = 0; i < iterations; i++) {
+        // xorshift keeps the addresses from being predicted
+        address ^= address << 13;
+        address ^= address >> 7;
+        address ^= address << 17;
+        uqword bit = btt_read(trie, address >> 48);
+        runner_keep(bit);
+    }
+}
+
+static void bench_fix_mul(uqword iterations) {
+    fix_t value = fix_from_parts(1, 0x0000000100000000);
+    fix_t factor = fix_from_parts(0, 0xFFFFFFFF00000000);
+    runner_keep(factor);
+    for (uqword i = 0; i < iterations; i++) {
+        value = fix_mul(value, factor);
+        runner_keep(value);
+    }
+}
+
+static void bench_fix_div(uqword iterations) {
+    fix_t value = fix_from_int(1000000);
+    fix_t divisor = fix_from_parts(1, 0x0000000100000000);
+    runner_keep(divisor);
+    for (uqword i = 0; i < iterations; i++) {
+        value = fix_div(value, divisor);
+        runner_keep(value);
+    }
+}
+
+static void bench_frc_add(uqword iterations) {
+    frac_t const third = frc_pack(1, 3);
+    frac_t       value = frc_pack(1, 7);
+    for (uqword i = 0; i < iterations; i++) {
+        frac_t sum = frc_add(value, third);
+        runner_keep(sum);
+        value = frc_pack((qword) (i & 1023u), 7);
+    }
+}
+
+/*
+ * One iteration is one element of a 1024 element array.
+ */
+static void bench_fix_batch_add(uqword iterations) {
+    static fix_t a[1024], b[1024], out[1024];
+    for (uqword i = 0; i < 1024; i++) {
+        a[i] = fix_from_int((qword) i);
+        b[i] = fix_from_parts(0, i * 0x9E3779B97F4A7C15u);
+    }
+
+    for (uqword done = 0; done < iterations; done += 1024) {
+        uqword const count = iterations - done < 1024 ? iterations - done : 1024;
+        fix_t       *result = out;
+        fix_batch_add(result, a, b, count);
+        runner_keep(result);
+    }
+}
+
+static void bench_context_push_pop(uqword iterations) {
+    for (uqword i = 0; i < iterations; i++) {
+        push_context("benchmark");
+        pop_context();
+    }
+}
+
+/*
+ * Measures moving one item through an SPSC ring and back out, in batches of 32 on one thread.
+ */
+static void bench_spsc_batch(uqword iterations) {
+    spsc_queue *queue = spsc_create(1024);
+    void       *batch[32] = {0};
+    for (uqword i = 0; i < iterations; i += 32) {
+        spsc_enqueue(queue, batch, 32);
+        uqword count = spsc_dequeue(queue, batch, 32);
+        runner_keep(count);
+    }
+    spsc_free(queue);
+}
+
+static void bench_mpmc_batch(uqword iterations) {
+    mpmc_queue *queue = mpmc_create(1024);
+    void       *batch[32] = {0};
+    for (uqword i = 0; i < iterations; i += 32) {
+        mpmc_enqueue(queue, batch, 32);
+        uqword count = mpmc_dequeue(queue, batch, 32);
+        runner_keep(count);
+    }
+    mpmc_free(queue);
+}
+
+static void bench_epoch_enter_exit(uqword iterations) {
+    for (uqword i = 0; i < iterations; i++) {
+        m_epoch_enter();
+        m_epoch_exit();
+    }
+}
+
+static void bench_epoch_release(void *owner, void **objects, uqword count) {
+    *(uqword *) owner += count;
+    runner_keep(objects);
+}
+
+/*
+ * Measures retiring an object and releasing it in a batch once the epoch has advanced past it.
+ */
+static void bench_epoch_retire(uqword iterations) {
+    uqword released = 0;
+    for (uqword i = 0; i < iterations; i++)
+        m_epoch_retire(&released, bench_epoch_release, &released);
+    m_epoch_synchronize();
+    runner_keep(released);
+}
+
+static void bench_task_nothing(void *argument) {
+    (void) argument;
+}
+
+/*
+ * Measures spawning a task and running it through the pool, in batches of 64 per sync.
+ */
+static void bench_task_spawn(uqword iterations) {
+    for (uqword i = 0; i < iterations; i += 64) {
+        task_group group = TASK_GROUP_INIT;
+        for (uqword j = 0; j < 64; j++)
+            task_spawn(&group, bench_task_nothing, NULL);
+        task_sync(&group);
+    }
+}
+
+static void bench_task_sum(uqword from, uqword to, void *argument) {
+    uqword sum = 0;
+    for (uqword i = from; i < to; i++)
+        sum += i * i;
+    atomic_fetch_add_explicit((_Atomic uqword *) argument, sum, memory_order_relaxed);
+}
+
+/*
+ * Measures a parallel sum of squares per index, split with the default grain.
+ */
+static void bench_task_parallel_for(uqword iterations) {
+    _Atomic uqword sum = 0;
+    task_parallel_for(0, iterations, 0, bench_task_sum, &sum);
+    uqword result = atomic_load(&sum);
+    runner_keep(result);
+}
+
+/*
+ * Measures a counter increment and a phase timing in a context, the per-event cost of compiler metrics.
+ */
+static void bench_context_metrics(uqword iterations) {
+    context c;
+    context_init(&c);
+    for (uqword i = 0; i < iterations; i++) {
+        context_count(&c, C_TOKENS_LEXED, 1);
+        context_time(&c, C_PHASE_LEX, i & 0xFFFu);
+    }
+    context_free(&c);
+}
+
+/*
+ * Measures the cost of trace calls while recording is off (unless the run is traced).
+ */
+static void bench_trace_scope(uqword iterations) {
+    for (uqword i = 0; i < iterations; i++) {
+        trace_scope("benchmark");
+        trace_counter("benchmark", (qword) i);
+    }
+}
+
+static void bench_p_get_time(uqword iterations) {
+    for (uqword i = 0; i < iterations; i++) {
+        uqword now = p_get_time(NANOSECONDS);
+        runner_keep(now);
+    }
+}
+
+/*
+ * End-to-end stages over one synthetic workload, set by AQUINAS_WORKLOAD (see workload_parse); one iteration processes
+ * the whole dictionary and operand text. The dictionary build, conversion and emission stages register here as they
+ * are implemented, against the same workload.
+ */
+static workload_options bench_workload_options;
+static workload_text    bench_workload_dictionary, bench_workload_operands;
+
+static void bench_workload_prepare(void) {
+    if (bench_workload_dictionary.data != NULL)
+        return;
+    workload_defaults(&bench_workload_options);
+    char const *list = getenv("AQUINAS_WORKLOAD");
+    if (list != NULL)
+        workload_parse(&bench_workload_options, list);
+    workload_dictionary(&bench_workload_options, &bench_workload_dictionary);
+    workload_operands(&bench_workload_options, &bench_workload_operands);
+}
+
+static void bench_e2e_generate(uqword iterations) {
+    bench_workload_prepare();
+    workload_text dictionary = {0}, operands = {0};
+    for (uqword i = 0; i < iterations; i++) {
+        workload_dictionary(&bench_workload_options, &dictionary);
+        workload_operands(&bench_workload_options, &operands);
+        runner_processed(dictionary.length + operands.length, dictionary.tokens + operands.tokens);
+    }
+    workload_text_free(&dictionary);
+    workload_text_free(&operands);
+}
+
+static void bench_e2e_tokenize(uqword iterations) {
+    bench_workload_prepare();
+    for (uqword i = 0; i < iterations; i++) {
+        uqword tokens = workload_tokenize(bench_workload_dictionary.data, bench_workload_dictionary.length);
+        tokens += workload_tokenize(bench_workload_operands.data, bench_workload_operands.length);
+        runner_keep(tokens);
+        runner_processed(bench_workload_dictionary.length + bench_workload_operands.length, tokens);
+    }
+}
+
+/*
+ * Lexes, parses and re-emits the workload through the four-stage pipeline, in 64 KiB batches with 8 per link.
+ */
+static void bench_e2e_pipeline(uqword iterations) {
+    bench_workload_prepare();
+    for (uqword i = 0; i < iterations; i++) {
+        pipeline_text_result dictionary = pipeline_text(bench_workload_dictionary.data, bench_workload_dictionary.length,
+                                                        65536, 8, NULL, NULL);
+        pipeline_text_result operands = pipeline_text(bench_workload_operands.data, bench_workload_operands.length,
+                                                      65536, 8, NULL, NULL);
+        runner_processed(bench_workload_dictionary.length + bench_workload_operands.length,
+                         dictionary.tokens + operands.tokens);
+    }
+}
+
+static void bench_e2e_build(uqword iterations) {
+    bench_workload_prepare();
+    for (uqword i = 0; i < iterations; i++) {
+        dictionary_image *image = dictionary_build(bench_workload_dictionary.data, bench_workload_dictionary.length);
+        runner_keep(image);
+        dictionary_image_free(image);
+        runner_processed(bench_workload_dictionary.length, bench_workload_dictionary.tokens);
+    }
+}
+
+/*
+ * Converts the operands against the published dictionary, entering an epoch critical section per statement.
+ */
+static void bench_e2e_convert(uqword iterations) {
+    bench_workload_prepare();
+    dictionary dict;
+    dictionary_init(&dict, dictionary_build(bench_workload_dictionary.data, bench_workload_dictionary.length));
+    for (uqword i = 0; i < iterations; i++) {
+        uqword converted = dictionary_convert_text(&dict, bench_workload_operands.data, bench_workload_operands.length,
+                                                   NULL);
+        runner_keep(converted);
+        runner_processed(bench_workload_operands.length, bench_workload_operands.tokens);
+    }
+    dictionary_free(&dict);
+}
+
+#define BENCH_FILE_READER_FILES 256
+#define BENCH_FILE_READER_LENGTH 4096
+
+/*
+ * Reads 256 files of 4 KiB into a queue and drains it, per iteration; the files are written before the first
+ * repetition and removed after the last.
+ */
+static void bench_file_read(uqword iterations, enum file_reader_mode mode) {
+    static char names[BENCH_FILE_READER_FILES][40];
+    char const *paths[BENCH_FILE_READER_FILES];
+    char        data[BENCH_FILE_READER_LENGTH];
+    memset(data, 'a', sizeof(data));
+    for (udword i = 0; i < BENCH_FILE_READER_FILES; i++) {
+        snprintf(names[i], sizeof(names[i]), "bench_file_reader_%u.ad", i);
+        paths[i] = names[i];
+        FILE *file = fopen(names[i], "wb");
+        if (!file || fwrite(data, 1, sizeof(data), file) != sizeof(data))
+            fatalf(__func__, "unable to write %s\n", names[i]);
+        fclose(file);
+    }
+
+    mpmc_queue *queue = mpmc_create(BENCH_FILE_READER_FILES);
+    for (uqword i = 0; i < iterations; i++) {
+        file_read_all(paths, BENCH_FILE_READER_FILES, 64, mode, queue);
+        void *buffers[BENCH_FILE_READER_FILES];
+        for (uqword j = mpmc_dequeue(queue, buffers, BENCH_FILE_READER_FILES); j != 0; j--)
+            file_buffer_free(buffers[j - 1]);
+        runner_processed(BENCH_FILE_READER_FILES * BENCH_FILE_READER_LENGTH, BENCH_FILE_READER_FILES);
+    }
+    mpmc_free(queue);
+    for (udword i = 0; i < BENCH_FILE_READER_FILES; i++)
+        remove(names[i]);
+}
+
+static void bench_file_read_uring(uqword iterations) {
+    bench_file_read(iterations, FILE_READER_AUTO);
+}
+
+static void bench_file_read_threads(uqword iterations) {
+    bench_file_read(iterations, FILE_READER_THREADS);
+}
+
+/*
+ * Writes every token of the operand text to a file, with a space or line break after each, per iteration: through
+ * fwrite once per token as a baseline, and through an emitter stream in each mode.
+ */
+static void bench_emit_stdio(uqword iterations) {
+    bench_workload_prepare();
+    char const  *text = bench_workload_operands.data;
+    uqword const length = bench_workload_operands.length;
+    for (uqword i = 0; i < iterations; i++) {
+        FILE *file = fopen("bench_emit.out", "wb");
+        if (!file)
+            fatalf(__func__, "unable to open bench_emit.out\n");
+        for (uqword at = 0; at < length;) {
+            uqword end = at;
+            while (end < length && text[end] != ' ' && text[end] != '\n')
+                end++;
+            fwrite(text + at, 1, end - at, file);
+            fwrite(end < length ? text + end : "\n", 1, 1, file);
+            at = end + 1;
+        }
+        fclose(file);
+        runner_processed(length, bench_workload_operands.tokens);
+    }
+    remove("bench_emit.out");
+}
+
+static void bench_emit(uqword iterations, enum emitter_mode mode) {
+    bench_workload_prepare();
+    char const  *text = bench_workload_operands.data;
+    uqword const length = bench_workload_operands.length;
+    for (uqword i = 0; i < iterations; i++) {
+        emitter *output = emitter_open("bench_emit.out", mode);
+        if (!output)
+            fatalf(__func__, "unable to open bench_emit.out\n");
+        emitter_stream *stream = emitter_stream_create(output);
+        for (uqword at = 0; at < length;) {
+            uqword end = at;
+            while (end < length && text[end] != ' ' && text[end] != '\n')
+                end++;
+            emitter_put(stream, text + at, end - at);
+            emitter_put(stream, end < length ? text + end : "\n", 1);
+            at = end + 1;
+        }
+        emitter_stream_free(stream);
+        emitter_close(output);
+        runner_processed(length, bench_workload_operands.tokens);
+    }
+    remove("bench_emit.out");
+}
+
+static void bench_emit_writev(uqword iterations) {
+    bench_emit(iterations, EMITTER_WRITEV);
+}
+
+static void bench_emit_mmap(uqword iterations) {
+    bench_emit(iterations, EMITTER_MMAP);
+}
+
+/*
+ * bit_math primitives, each in two modes. In latency mode every call takes the previous result as its input, so an
+ * iteration costs the latency of the primitive plus that of the rotate and xor which mix the result back in (measured
+ * alone as bit_math/chain); in throughput mode the inputs are independent and calls overlap as far as the processor
+ * allows. The bit counts and the division run through each of their paths: the compiler builtin, the instruction
+ * through asm.h, and the portable fallback.
+ */
+
+#define BENCH_BIT_MATH_SEED 0x9E3779B97F4A7C15u
+
+#define BENCH_BIT_MATH_UNARY(name, function)                                    \
+    static void bench_##name##_latency(uqword iterations) {                     \
+        uqword value = BENCH_BIT_MATH_SEED;                                     \
+        for (uqword i = 0; i < iterations; i++)                                 \
+            value = (value << 1u | value >> 63u) ^ function(value);             \
+        runner_keep(value);                                                     \
+    }                                                                           \
+    static void bench_##name##_throughput(uqword iterations) {                  \
+        uqword input = BENCH_BIT_MATH_SEED;                                     \
+        for (uqword i = 0; i < iterations; i++) {                               \
+            uqword result = function(input);                                    \
+            runner_keep(result);                                                \
+            input += BENCH_BIT_MATH_SEED;                                       \
+        }                                                                       \
+    }
+
+// the second operand is hidden from the optimizer so that it is not folded into the function
+#define BENCH_BIT_MATH_BINARY(name, function, operand)                          \
+    static void bench_##name##_latency(uqword iterations) {                     \
+        uqword value = BENCH_BIT_MATH_SEED, other = (operand);                  \
+        runner_keep(other);                                                     \
+        for (uqword i = 0; i < iterations; i++)                                 \
+            value = (value << 1u | value >> 63u) ^ function(value, other);      \
+        runner_keep(value);                                                     \
+    }                                                                           \
+    static void bench_##name##_throughput(uqword iterations) {                  \
+        uqword input = BENCH_BIT_MATH_SEED, other = (operand);                  \
+        runner_keep(other);                                                     \
+        for (uqword i = 0; i < iterations; i++) {                               \
+            uqword result = function(input, other);                             \
+            runner_keep(result);                                                \
+            input += BENCH_BIT_MATH_SEED;                                       \
+        }                                                                       \
+    }
+
+#define BENCH_BIT_MATH_ENTRIES(name, label)                                     \
+    RUNNER_BENCHMARK("bit_math/" label "/latency", bench_##name##_latency),     \
+    RUNNER_BENCHMARK("bit_math/" label "/throughput", bench_##name##_throughput)
+
+static inline uqword bench_chain(uqword value) {
+    return value;
+}
+
+static inline uqword bench_sigbits_builtin(uqword value) {
+    return 64u - (uqword) __builtin_clzll(value | 1u);
+}
+
+static inline uqword bench_cntlz_builtin(uqword value) {
+    return value ? (uqword) __builtin_clzll(value) : 64u;
+}
+
+static inline uqword bench_cnttz_builtin(uqword value) {
+    return value ? (uqword) __builtin_ctzll(value) : 64u;
+}
+
+static inline uqword bench_ones_builtin(uqword value) {
+    return (uqword) __builtin_popcountll(value);
+}
+
+static inline uqword bench_udivq_builtin(uqword dividend, uqword divisor) {
+    return dividend / divisor;
+}
+
+static inline uqword bench_umodq_builtin(uqword x, uqword modulus) {
+    return x % modulus;
+}
+
+#if ARCH == ARCH_X86_64
+
+static inline uqword bench_sigbits_asm(uqword value) {
+    return 64u - __x64_lzcnt(value | 1u);
+}
+
+#define bench_cntlz_asm __x64_lzcnt
+#define bench_cnttz_asm __x64_tzcnt
+#define bench_ones_asm __x64_popcnt
+
+#endif
+
+// the exponent is kept small so that the loop in powni runs a varying but short number of times
+static inline uqword bench_powni(uqword base, uqword exponent) {
+    return powni(base, exponent & 15u);
+}
+
+static inline uqword bench_bin_index(uqword address) {
+    return bin_index(address >> 40u);
+}
+
+static uqword bench_bit_array[1024];
+
+static inline uqword bench_get_bita(uqword bit_index) {
+    return get_bita(bench_bit_array, 1024, bit_index & (1024u * 64u - 1u));
+}
+
+static inline uqword bench_set_bita(uqword bit_index) {
+    set_bita(bench_bit_array, 1024, bit_index & (1024u * 64u - 1u), bit_index >> 63u);
+    return bit_index >> 1u;
+}
+
+BENCH_BIT_MATH_UNARY(chain, bench_chain)
+BENCH_BIT_MATH_UNARY(sigbits_builtin, bench_sigbits_builtin)
+BENCH_BIT_MATH_UNARY(sigbits_portable, sigbits_portable)
+BENCH_BIT_MATH_UNARY(cntlz_builtin, bench_cntlz_builtin)
+BENCH_BIT_MATH_UNARY(cntlz_portable, cntlz_portable)
+BENCH_BIT_MATH_UNARY(cnttz_builtin, bench_cnttz_builtin)
+BENCH_BIT_MATH_UNARY(cnttz_portable, cnttz_portable)
+BENCH_BIT_MATH_UNARY(ones_builtin, bench_ones_builtin)
+BENCH_BIT_MATH_UNARY(ones_portable, ones_portable)
+BENCH_BIT_MATH_BINARY(udivq_builtin, bench_udivq_builtin, 0x2545F4914F6CDD1Du >> 20u)
+BENCH_BIT_MATH_BINARY(udivq, udivq, 0x2545F4914F6CDD1Du >> 20u)
+BENCH_BIT_MATH_BINARY(udivq_portable, udivq_portable, 0x2545F4914F6CDD1Du >> 20u)
+BENCH_BIT_MATH_BINARY(umodq_builtin, bench_umodq_builtin, 0x2545F4914F6CDD1Du >> 20u)
+BENCH_BIT_MATH_BINARY(umodq, umodq, 0x2545F4914F6CDD1Du >> 20u)
+BENCH_BIT_MATH_BINARY(umodq_portable, umodq_portable, 0x2545F4914F6CDD1Du >> 20u)
+BENCH_BIT_MATH_UNARY(floor_log10i, floor_log10i)
+BENCH_BIT_MATH_BINARY(powni, bench_powni, 3u)
+BENCH_BIT_MATH_UNARY(bin_index, bench_bin_index)
+BENCH_BIT_MATH_UNARY(get_bita, bench_get_bita)
+BENCH_BIT_MATH_UNARY(set_bita, bench_set_bita)
+
+#if ARCH == ARCH_X86_64
+BENCH_BIT_MATH_UNARY(sigbits_asm, bench_sigbits_asm)
+BENCH_BIT_MATH_UNARY(cntlz_asm, bench_cntlz_asm)
+BENCH_BIT_MATH_UNARY(cnttz_asm, bench_cnttz_asm)
+BENCH_BIT_MATH_UNARY(ones_asm, bench_ones_asm)
+
+  #define BENCH_BIT_MATH_ASM_ENTRIES                                            \
+    BENCH_BIT_MATH_ENTRIES(sigbits_asm, "sigbits/asm"),                         \
+    BENCH_BIT_MATH_ENTRIES(cntlz_asm, "cntlz/asm"),                             \
+    BENCH_BIT_MATH_ENTRIES(cnttz_asm, "cnttz/asm"),                             \
+    BENCH_BIT_MATH_ENTRIES(ones_asm, "ones/asm"),
+#else
+  #define BENCH_BIT_MATH_ASM_ENTRIES
+#endif
+
+/*
+ * Registry entries of the bit_math suite, named bit_math/<primitive>[/<path>]/<mode>.
+ */
+#define BENCH_BIT_MATH                                                          \
+    BENCH_BIT_MATH_ENTRIES(chain, "chain"),                                     \
+    BENCH_BIT_MATH_ENTRIES(sigbits_builtin, "sigbits/builtin"),                 \
+    BENCH_BIT_MATH_ENTRIES(sigbits_portable, "sigbits/portable"),               \
+    BENCH_BIT_MATH_ENTRIES(cntlz_builtin, "cntlz/builtin"),                     \
+    BENCH_BIT_MATH_ENTRIES(cntlz_portable, "cntlz/portable"),                   \
+    BENCH_BIT_MATH_ENTRIES(cnttz_builtin, "cnttz/builtin"),                     \
+    BENCH_BIT_MATH_ENTRIES(cnttz_portable, "cnttz/portable"),                   \
+    BENCH_BIT_MATH_ENTRIES(ones_builtin, "ones/builtin"),                       \
+    BENCH_BIT_MATH_ENTRIES(ones_portable, "ones/portable"),                     \
+    BENCH_BIT_MATH_ASM_ENTRIES                                                  \
+    BENCH_BIT_MATH_ENTRIES(udivq_builtin, "udivq/builtin"),                     \
+    BENCH_BIT_MATH_ENTRIES(udivq, "udivq/bit_math"),                            \
+    BENCH_BIT_MATH_ENTRIES(udivq_portable, "udivq/portable"),                   \
+    BENCH_BIT_MATH_ENTRIES(umodq_builtin, "umodq/builtin"),                     \
+    BENCH_BIT_MATH_ENTRIES(umodq, "umodq/bit_math"),                            \
+    BENCH_BIT_MATH_ENTRIES(umodq_portable, "umodq/portable"),                   \
+    BENCH_BIT_MATH_ENTRIES(floor_log10i, "floor_log10i"),                       \
+    BENCH_BIT_MATH_ENTRIES(powni, "powni"),                                     \
+    BENCH_BIT_MATH_ENTRIES(bin_index, "bin_index"),                             \
+    BENCH_BIT_MATH_ENTRIES(get_bita, "get_bita"),                               \
+    BENCH_BIT_MATH_ENTRIES(set_bita, "set_bita")
+
+#pragma GCC diagnostic pop
+
+#endif //PROJECT_AQUINAS_BENCHMARKS_H
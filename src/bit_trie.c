@@ -13,6 +13,8 @@
 #include "bit_trie.h"
 #include "bit_math.h"
 #include "state.h"
+#include "memory/m_profile.h"
+#include "memory/m_epoch.h"
 
 uqword btt_read(bit_trie *trie, uqword address) {
     return get_bita(trie->binodes, (2u << trie->depth) / BITS, bin_index(address));
@@ -30,6 +32,7 @@ bit_trie *btt_create(uqword_pair const *pairs, uqword depth, uqword length) {
     }
     
     result->binodes = calloc((2u << depth) / BITS, sizeof(uqword));
+    m_profile_allocation("btt_create", sizeof(bit_trie) + (2u << depth) / BITS * sizeof(uqword));
     result->depth   = depth;
     
     if (!result->binodes) {
@@ -48,3 +51,13 @@ void btt_free(bit_trie *trie) {
     free(trie->binodes);
     free(trie);
 }
+
+static void btt_release(void *owner, void **tries, uqword count) {
+    (void) owner;
+    for (uqword i = 0; i < count; i++)
+        btt_free(tries[i]);
+}
+
+void btt_retire(bit_trie *trie) {
+    m_epoch_retire(trie, btt_release, NULL);
+}
@@ -32,4 +32,9 @@ bit_trie *btt_create(uqword_pair const *pairs, uqword depth, uqword length);
 
 void btt_free(bit_trie *trie);
 
+/*
+ * Frees `trie` once no reader inside an epoch critical section can still hold it; see m_epoch.h.
+ */
+void btt_retire(bit_trie *trie);
+
 #endif //PROJECT_AQUINAS_BIT_TRIE_H
@@ -5,7 +5,129 @@
  *      Author: Andrew Thomas Porter (AMDG)
  */
 
+#include <stdio.h>
+#include <stdlib.h>
 #include "compiler.h"
 
+_Thread_local uqword c_shard_context;
+_Thread_local c_metrics_shard *c_shard;
+
+// identifies the calling thread by the address of one of its thread-locals
+static _Thread_local char c_thread;
+static _Atomic uqword c_contexts;
+
+static char const *const c_phase_names[C_PHASES] = {
+	[C_PHASE_LEX]     = "lex",
+	[C_PHASE_LOOKUP]  = "lookup",
+	[C_PHASE_CONVERT] = "convert",
+	[C_PHASE_EMIT]    = "emit",
+};
+
+static struct {
+	char const *name;
+	char const *help;
+} const c_counter_names[C_COUNTERS] = {
+	[C_TOKENS_LEXED]       = {"aquinas_tokens_lexed_total", "Tokens produced by the lexer."},
+	[C_DICTIONARY_LOOKUPS] = {"aquinas_dictionary_lookups_total", "Identifiers looked up in the dictionary."},
+	[C_DICTIONARY_HITS]    = {"aquinas_dictionary_hits_total", "Dictionary lookups which found a definition."},
+	[C_DICTIONARY_MISSES]  = {"aquinas_dictionary_misses_total", "Dictionary lookups which found none."},
+	[C_CONVERSIONS]        = {"aquinas_conversions_total", "Operands converted."},
+	[C_BYTES_EMITTED]      = {"aquinas_bytes_emitted_total", "Bytes of output emitted."},
+};
+
+void context_init(context *c) {
+	c->id = atomic_fetch_add_explicit(&c_contexts, 1, memory_order_relaxed) + 1;
+	atomic_init(&c->shards, NULL);
+}
+
+void context_free(context *c) {
+	c_metrics_shard *shard = atomic_exchange(&c->shards, NULL);
+	while (shard != NULL) {
+		c_metrics_shard *next = shard->next;
+		free(shard);
+		shard = next;
+	}
+	if (c_shard_context == c->id)
+		c_shard_context = 0;
+}
+
+c_metrics_shard *context_find_shard(context *c) {
+	c_metrics_shard *shard = atomic_load_explicit(&c->shards, memory_order_acquire);
+	while (shard != NULL && shard->thread != &c_thread)
+		shard = shard->next;
+
+	if (shard == NULL) {
+		shard = calloc(1, sizeof(c_metrics_shard));
+		if (shard == NULL)
+			fatalf(__func__, "unable to allocate %zu bytes of metrics\n", sizeof(c_metrics_shard));
+		shard->thread = &c_thread;
+		shard->next = atomic_load_explicit(&c->shards, memory_order_relaxed);
+		while (!atomic_compare_exchange_weak_explicit(&c->shards, &shard->next, shard, memory_order_release,
+		                                              memory_order_relaxed));
+	}
+	c_shard_context = c->id;
+	return c_shard = shard;
+}
+
+void context_metrics(context *c, c_metrics *total) {
+	*total = (c_metrics) {0};
+	for (c_metrics_shard *shard = atomic_load_explicit(&c->shards, memory_order_acquire); shard != NULL;
+	     shard = shard->next) {
+		for (udword i = 0; i < C_COUNTERS; i++)
+			total->counters[i] += atomic_load_explicit(&shard->counters[i], memory_order_relaxed);
+		for (udword phase = 0; phase < C_PHASES; phase++) {
+			for (udword i = 0; i < C_LATENCY_BUCKETS; i++)
+				total->latency[phase][i] += atomic_load_explicit(&shard->latency[phase][i], memory_order_relaxed);
+			total->latency_nanoseconds[phase] +=
+					atomic_load_explicit(&shard->latency_nanoseconds[phase], memory_order_relaxed);
+		}
+	}
+}
+
+bool context_write_prometheus(context *c, char const *path) {
+	c_metrics metrics;
+	context_metrics(c, &metrics);
+
+	char temporary[4096];
+	snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+	FILE *file = fopen(temporary, "w");
+	if (file == NULL)
+		return false;
+
+	for (udword i = 0; i < C_COUNTERS; i++)
+		fprintf(file, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", c_counter_names[i].name, c_counter_names[i].help,
+		        c_counter_names[i].name, c_counter_names[i].name, (unsigned long long) metrics.counters[i]);
+
+	fputs("# HELP aquinas_phase_duration_seconds Latency of each run of a compiler phase.\n"
+	      "# TYPE aquinas_phase_duration_seconds histogram\n", file);
+	for (udword phase = 0; phase < C_PHASES; phase++) {
+		char const *name = c_phase_names[phase];
+		uqword count = 0;
+		// buckets are cumulative; the last has no bound of its own and is only part of +Inf
+		for (udword i = 0; i < C_LATENCY_BUCKETS - 1; i++) {
+			count += metrics.latency[phase][i];
+			fprintf(file, "aquinas_phase_duration_seconds_bucket{phase=\"%s\",le=\"%.9g\"} %llu\n", name,
+			        (double) (1ull << i) / 1e9, (unsigned long long) count);
+		}
+		count += metrics.latency[phase][C_LATENCY_BUCKETS - 1];
+		fprintf(file, "aquinas_phase_duration_seconds_bucket{phase=\"%s\",le=\"+Inf\"} %llu\n", name,
+		        (unsigned long long) count);
+		fprintf(file, "aquinas_phase_duration_seconds_sum{phase=\"%s\"} %.9f\n", name,
+		        (double) metrics.latency_nanoseconds[phase] / 1e9);
+		fprintf(file, "aquinas_phase_duration_seconds_count{phase=\"%s\"} %llu\n", name, (unsigned long long) count);
+	}
+
+	bool const written = !ferror(file);
+	if (fclose(file) != 0 || !written) {
+		remove(temporary);
+		return false;
+	}
+#if PLATFORM == P_WINDOWS || ENVIRONMENT == P_WINDOWS
+	// rename does not replace an existing file on Windows
+	remove(path);
+#endif
+	return rename(temporary, path) == 0;
+}
+
 
 
@@ -10,9 +10,11 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 
 #include "state.h"
 #include "pattern_tree.h"
+#include "bit_math.h"
 
 typedef enum c_command {
 	// Opens a pattern_tree and makes it the current context (isomorphic)
@@ -23,9 +25,104 @@ typedef enum c_command {
 	LINK,
 } behavior;
 
+// phases of a compile; each is timed into a histogram of its latencies
+enum c_phase {
+	C_PHASE_LEX,
+	C_PHASE_LOOKUP,
+	C_PHASE_CONVERT,
+	C_PHASE_EMIT,
+	C_PHASES
+};
+
+enum c_counter {
+	C_TOKENS_LEXED,
+	C_DICTIONARY_LOOKUPS,
+	C_DICTIONARY_HITS,
+	C_DICTIONARY_MISSES,
+	C_CONVERSIONS,
+	C_BYTES_EMITTED,
+	C_COUNTERS
+};
+
+// latency bucket i counts phases which took at most 2^i nanoseconds; the last also counts everything longer (34 s)
+#define C_LATENCY_BUCKETS 36
+
+// metrics of a context summed over its threads
+typedef struct c_metrics {
+	uqword counters[C_COUNTERS];
+	uqword latency[C_PHASES][C_LATENCY_BUCKETS];
+	uqword latency_nanoseconds[C_PHASES];
+} c_metrics;
+
+// metrics recorded by one thread in one context; only that thread writes them, and readers sum them on demand
+typedef struct c_metrics_shard {
+	_Atomic uqword counters[C_COUNTERS];
+	_Atomic uqword latency[C_PHASES][C_LATENCY_BUCKETS];
+	_Atomic uqword latency_nanoseconds[C_PHASES];
+	void const *thread;
+	struct c_metrics_shard *next;
+} c_metrics_shard;
+
 typedef struct context {
+	// distinguishes this context from any earlier one at the same address
+	uqword id;
+	// shards of the threads which recorded metrics in this context
+	_Atomic(c_metrics_shard *) shards;
 } context;
 
+// the context of the last shard the calling thread recorded into
+extern _Thread_local uqword c_shard_context;
+extern _Thread_local c_metrics_shard *c_shard;
+
+void context_init(context *c);
+
+/*
+ * Frees the shards of the context. Must not run concurrently with recording.
+ */
+void context_free(context *c);
+
+/*
+ * Finds or creates the calling thread's shard; called through context_shard.
+ */
+c_metrics_shard *context_find_shard(context *c);
+
+static inline c_metrics_shard *context_shard(context *c) {
+	return c_shard_context == c->id ? c_shard : context_find_shard(c);
+}
+
+/*
+ * Adds to a counter of the calling thread. Plain relaxed loads and stores suffice, since only the owner writes.
+ */
+static inline void context_count(context *c, enum c_counter counter, uqword amount) {
+	_Atomic uqword *value = &context_shard(c)->counters[counter];
+	atomic_store_explicit(value, atomic_load_explicit(value, memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+/*
+ * Records that one run of a phase took `nanoseconds`.
+ */
+static inline void context_time(context *c, enum c_phase phase, uqword nanoseconds) {
+	c_metrics_shard *shard = context_shard(c);
+	uqword bucket = nanoseconds > 1 ? sigbits(nanoseconds - 1) : 0;
+	if (bucket >= C_LATENCY_BUCKETS)
+		bucket = C_LATENCY_BUCKETS - 1;
+	_Atomic uqword *count = &shard->latency[phase][bucket];
+	_Atomic uqword *total = &shard->latency_nanoseconds[phase];
+	atomic_store_explicit(count, atomic_load_explicit(count, memory_order_relaxed) + 1, memory_order_relaxed);
+	atomic_store_explicit(total, atomic_load_explicit(total, memory_order_relaxed) + nanoseconds, memory_order_relaxed);
+}
+
+/*
+ * Sums the metrics of every thread of the context into `total`; may run while threads record.
+ */
+void context_metrics(context *c, c_metrics *total);
+
+/*
+ * Writes the metrics in the Prometheus text format to `path`, through a temporary file renamed over it so that the
+ * node exporter's textfile collector never reads a partial file. Returns false if the file cannot be written.
+ */
+bool context_write_prometheus(context *c, char const *path);
+
 #endif /* COMPILER_H_ */
 
 
@@ -10,12 +10,14 @@
 #include <stdlib.h>
 #include <state.h>
 #include "dynarray.h"
+#include "memory/m_profile.h"
 
 dynarray *dynarray_create(uint32_t data_length) {
     // ensure alignment of uqword for array
     if (data_length % sizeof(uqword))
         data_length = data_length - (data_length % sizeof(uqword)) + sizeof(uqword);
     dynarray *array = calloc(1, sizeof(*array) + data_length);
+    m_profile_allocation("dynarray_create", sizeof(*array) + data_length);
     array->data_length = data_length;
     return array;
 }
@@ -60,6 +62,7 @@ dynarray *dynarray_resize(dynarray *restrict array, uint32_t size) {
         fatalf(__func__, "array is NULL\n");
     
     array = realloc(array, size);
+    m_profile_allocation("dynarray_resize", size);
     
     if (!array)
         fatalf(__func__, "failed to reallocate memory to resize array\n");
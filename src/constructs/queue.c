@@ -0,0 +1,159 @@
+/*
+ * Module: queue
+ * File: queue.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <stdlib.h>
+#include <state.h>
+#include "queue.h"
+
+static uqword queue_capacity(uqword capacity) {
+    uqword rounded = 2;
+    while (rounded < capacity)
+        rounded <<= 1u;
+    return rounded;
+}
+
+/* SPSC */
+
+spsc_queue *spsc_create(uqword capacity) {
+    capacity = queue_capacity(capacity);
+    spsc_queue *queue = calloc(1, sizeof(spsc_queue) + capacity * sizeof(void *));
+    if (!queue)
+        fatalf(__func__, "failed to allocate a queue of %llu slots\n", (unsigned long long) capacity);
+    queue->mask = capacity - 1;
+    return queue;
+}
+
+void spsc_free(spsc_queue *queue) {
+    free(queue);
+}
+
+uqword spsc_enqueue(spsc_queue *restrict queue, void *const *restrict items, uqword count) {
+    uqword const tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uqword       room = queue->mask + 1 - (tail - queue->head_cache);
+    if (room < count) {
+        queue->head_cache = atomic_load_explicit(&queue->head, memory_order_acquire);
+        room = queue->mask + 1 - (tail - queue->head_cache);
+    }
+    if (count > room)
+        count = room;
+
+    for (uqword i = 0; i < count; i++)
+        queue->slots[(tail + i) & queue->mask] = items[i];
+    atomic_store_explicit(&queue->tail, tail + count, memory_order_release);
+    return count;
+}
+
+uqword spsc_dequeue(spsc_queue *restrict queue, void **restrict items, uqword count) {
+    uqword const head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uqword       available = queue->tail_cache - head;
+    if (available < count) {
+        queue->tail_cache = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        available = queue->tail_cache - head;
+    }
+    if (count > available)
+        count = available;
+
+    for (uqword i = 0; i < count; i++)
+        items[i] = queue->slots[(head + i) & queue->mask];
+    atomic_store_explicit(&queue->head, head + count, memory_order_release);
+    return count;
+}
+
+/* MPMC */
+
+mpmc_queue *mpmc_create(uqword capacity) {
+    capacity = queue_capacity(capacity);
+    mpmc_queue *queue = calloc(1, sizeof(mpmc_queue) + capacity * sizeof(mpmc_cell));
+    if (!queue)
+        fatalf(__func__, "failed to allocate a queue of %llu cells\n", (unsigned long long) capacity);
+    queue->mask = capacity - 1;
+    for (uqword i = 0; i < capacity; i++)
+        atomic_init(&queue->cells[i].sequence, i);
+    return queue;
+}
+
+void mpmc_free(mpmc_queue *queue) {
+    free(queue);
+}
+
+/*
+ * Counts the cells from `position` onwards, up to `count`, whose sequence is their position plus `offset`: free cells
+ * for producers (offset 0) or full ones for consumers (offset 1). Stores the difference at the first cell in `first`.
+ */
+static uqword mpmc_ready(mpmc_queue *queue, uqword position, uqword count, uqword offset, qword *first) {
+    uqword ready = 0;
+    for (; ready < count; ready++) {
+        uqword const expected = position + ready + offset;
+        qword const  difference = (qword) (atomic_load_explicit(&queue->cells[(position + ready) & queue->mask].sequence,
+                                                                 memory_order_acquire) - expected);
+        if (ready == 0)
+            *first = difference;
+        if (difference != 0)
+            break;
+    }
+    return ready;
+}
+
+uqword mpmc_enqueue(mpmc_queue *restrict queue, void *const *restrict items, uqword count) {
+    if (count == 0)
+        return 0;
+    uqword tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    for (;;) {
+        qword        first;
+        uqword const ready = mpmc_ready(queue, tail, count, 0, &first);
+        if (ready == 0) {
+            // behind: the cell still holds the item of the previous lap, so the queue is full
+            if (first < 0)
+                return 0;
+            // ahead: another producer claimed the position first
+            tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+            continue;
+        }
+        if (!atomic_compare_exchange_weak_explicit(&queue->tail, &tail, tail + ready, memory_order_relaxed,
+                                                   memory_order_relaxed))
+            continue;
+
+        for (uqword i = 0; i < ready; i++) {
+            mpmc_cell *cell = &queue->cells[(tail + i) & queue->mask];
+            cell->item = items[i];
+            atomic_store_explicit(&cell->sequence, tail + i + 1, memory_order_release);
+        }
+        return ready;
+    }
+}
+
+uqword mpmc_dequeue(mpmc_queue *restrict queue, void **restrict items, uqword count) {
+    if (count == 0)
+        return 0;
+    uqword head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    for (;;) {
+        qword        first;
+        uqword const ready = mpmc_ready(queue, head, count, 1, &first);
+        if (ready == 0) {
+            // behind: the cell has not been filled for this lap, so the queue is empty
+            if (first < 0)
+                return 0;
+            head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+            continue;
+        }
+        if (!atomic_compare_exchange_weak_explicit(&queue->head, &head, head + ready, memory_order_relaxed,
+                                                   memory_order_relaxed))
+            continue;
+
+        for (uqword i = 0; i < ready; i++) {
+            mpmc_cell *cell = &queue->cells[(head + i) & queue->mask];
+            items[i] = cell->item;
+            atomic_store_explicit(&cell->sequence, head + i + queue->mask + 1, memory_order_release);
+        }
+        return ready;
+    }
+}
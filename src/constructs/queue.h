@@ -0,0 +1,100 @@
+/*
+ * Module: queue
+ * File: queue.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Bounded lock-free queues of pointers for passing work between threads: an SPSC ring for one producer and one
+ * consumer, and an MPMC queue for any number of either. Neither blocks; enqueue and dequeue move as many items of a
+ * batch as there is room or data for and return how many they moved, so callers choose between spinning, yielding
+ * and doing other work when a queue is full or empty.
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#ifndef PROJECT_AQUINAS_QUEUE_H
+#define PROJECT_AQUINAS_QUEUE_H
+
+#include <stdatomic.h>
+#include <platform.h>
+
+/*
+ * Ring with one producer and one consumer. Each side keeps a copy of the other's index and only reloads it when the
+ * copy says the ring is full (or empty), so a batch costs one acquire load at most and one release store; the indices
+ * live on cache lines of their own.
+ */
+typedef struct spsc_queue {
+    uqword         mask;
+    char           mask_padding[P_CACHE_LINE_SIZE - sizeof(uqword)];
+    // written by the producer only, with its copy of head
+    _Atomic uqword tail;
+    uqword         head_cache;
+    char           tail_padding[P_CACHE_LINE_SIZE - 2 * sizeof(uqword)];
+    // written by the consumer only, with its copy of tail
+    _Atomic uqword head;
+    uqword         tail_cache;
+    char           head_padding[P_CACHE_LINE_SIZE - 2 * sizeof(uqword)];
+    void          *slots[];
+} spsc_queue;
+
+/*
+ * Creates a ring of at least `capacity` slots (rounded up to a power of two). The process terminates if the ring
+ * cannot be allocated.
+ */
+spsc_queue *spsc_create(uqword capacity);
+
+void spsc_free(spsc_queue *queue);
+
+/*
+ * Appends up to `count` items in order; returns how many there was room for. Producer only.
+ */
+uqword spsc_enqueue(spsc_queue *restrict queue, void *const *restrict items, uqword count);
+
+/*
+ * Removes up to `count` items in order into `items`; returns how many there were. Consumer only.
+ */
+uqword spsc_dequeue(spsc_queue *restrict queue, void **restrict items, uqword count);
+
+typedef struct mpmc_cell {
+    // the position the cell expects next: equal to it when free for that position, one more when holding its item
+    _Atomic uqword sequence;
+    void          *item;
+} mpmc_cell;
+
+/*
+ * Dmitry Vyukov's bounded MPMC queue: producers and consumers claim positions with a compare-and-swap on their index,
+ * and each cell's sequence number tells whether the cell is ready for the position claimed, so neither side waits for
+ * the other's index. A batch claims as many consecutive ready cells as it can with one compare-and-swap.
+ */
+typedef struct mpmc_queue {
+    uqword         mask;
+    char           mask_padding[P_CACHE_LINE_SIZE - sizeof(uqword)];
+    _Atomic uqword tail;
+    char           tail_padding[P_CACHE_LINE_SIZE - sizeof(uqword)];
+    _Atomic uqword head;
+    char           head_padding[P_CACHE_LINE_SIZE - sizeof(uqword)];
+    mpmc_cell      cells[];
+} mpmc_queue;
+
+/*
+ * Creates a queue of at least `capacity` cells (rounded up to a power of two, and at least 2). The process terminates
+ * if the queue cannot be allocated.
+ */
+mpmc_queue *mpmc_create(uqword capacity);
+
+void mpmc_free(mpmc_queue *queue);
+
+/*
+ * Appends up to `count` items; returns how many there was room for. Items of one batch stay consecutive.
+ */
+uqword mpmc_enqueue(mpmc_queue *restrict queue, void *const *restrict items, uqword count);
+
+/*
+ * Removes up to `count` items into `items`; returns how many there were.
+ */
+uqword mpmc_dequeue(mpmc_queue *restrict queue, void **restrict items, uqword count);
+
+#endif //PROJECT_AQUINAS_QUEUE_H
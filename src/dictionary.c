@@ -0,0 +1,225 @@
+/*
+ * Module: dictionary
+ * File: dictionary.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "state.h"
+#include "dictionary.h"
+#include "memory/m_profile.h"
+
+/*
+ * FNV-1a, finished with a multiply-xorshift so that the low bits used for the slot depend on every byte.
+ */
+static uqword dictionary_hash(char const *name, uqword length) {
+    uqword hash = 0xCBF29CE484222325u;
+    for (uqword i = 0; i < length; i++)
+        hash = (hash ^ (ubyte) name[i]) * 0x100000001B3u;
+    hash ^= hash >> 32u;
+    hash *= 0xD6E8FEB86659FD93u;
+    return hash ^ hash >> 32u;
+}
+
+static bool dictionary_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+/*
+ * Finds the next token at or after `*offset`: a word, ';' or ":=". Stores its start in `*start`, moves `*offset` past
+ * it and returns its length, or 0 at the end of the text.
+ */
+static uqword dictionary_token(char const *text, uqword length, uqword *offset, uqword *start) {
+    uqword i = *offset;
+    while (i < length && dictionary_space(text[i]))
+        i++;
+    *start = i;
+    if (i == length)
+        return *offset = i, 0;
+    if (text[i] == ';')
+        return *offset = i + 1, 1;
+    if (text[i] == ':' && i + 1 < length && text[i + 1] == '=')
+        return *offset = i + 2, 2;
+    while (i < length && !dictionary_space(text[i]) && text[i] != ';' &&
+           !(text[i] == ':' && i + 1 < length && text[i + 1] == '='))
+        i++;
+    *offset = i;
+    return i - *start;
+}
+
+static bool dictionary_word(char const *token, uqword length) {
+    return length != 0 && !(length == 1 && token[0] == ';') && !(length == 2 && token[0] == ':' && token[1] == '=');
+}
+
+static udword dictionary_find_hashed(dictionary_image const *image, char const *name, uqword length, uqword hash) {
+    for (udword slot = (udword) hash & image->mask;; slot = (slot + 1) & image->mask) {
+        udword const index = image->slots[slot];
+        if (index == 0)
+            return DICTIONARY_NONE;
+        dictionary_entry const *entry = &image->entries[index - 1];
+        if (entry->hash == hash && entry->length == length && memcmp(image->names + entry->name, name, length) == 0)
+            return index - 1;
+    }
+}
+
+udword dictionary_find(dictionary_image const *image, char const *name, uqword length) {
+    return dictionary_find_hashed(image, name, length, dictionary_hash(name, length));
+}
+
+// images built and not yet freed
+static _Atomic uqword dictionary_images;
+
+uqword dictionary_image_count(void) {
+    return atomic_load_explicit(&dictionary_images, memory_order_relaxed);
+}
+
+typedef struct dictionary_span {
+    uqword start;
+    uqword length;
+} dictionary_span;
+
+dictionary_image *dictionary_build(char const *text, uqword length) {
+    // every identifier is defined by a statement, so there are no more of either than there are ';'
+    udword statements = 0;
+    for (uqword i = 0; i < length; i++)
+        statements += text[i] == ';';
+    udword slots = 2;
+    while (slots < 2 * (uqword) statements)
+        slots <<= 1u;
+
+    uqword const      bytes = sizeof(dictionary_image) + statements * sizeof(dictionary_entry) + slots * sizeof(udword) +
+                              length;
+    dictionary_image *image = malloc(bytes);
+    // the genus and whatness of each entry, resolved once every name is in the table
+    dictionary_span  *edges = malloc((statements ? statements : 1) * 2 * sizeof(dictionary_span));
+    if (!image || !edges)
+        fatalf(__func__, "failed to allocate a dictionary image of %llu bytes\n", (unsigned long long) bytes);
+    m_profile_allocation("dictionary_image", bytes);
+    atomic_fetch_add_explicit(&dictionary_images, 1, memory_order_relaxed);
+    image->count = 0;
+    image->mask = slots - 1;
+    image->entries = (dictionary_entry *) (image + 1);
+    image->slots = (udword *) (image->entries + statements);
+    image->names = (char *) (image->slots + slots);
+    memset(image->slots, 0, slots * sizeof(udword));
+
+    uqword names = 0, offset = 0;
+    for (;;) {
+        dictionary_span tokens[4];
+        udword          count = 0;
+        uqword          start, token;
+        while ((token = dictionary_token(text, length, &offset, &start)) != 0 && !(token == 1 && text[start] == ';'))
+            if (count < 4)
+                tokens[count++] = (dictionary_span) {start, token};
+        if (token == 0)
+            break;
+        if (count == 0 || !dictionary_word(text + tokens[0].start, tokens[0].length))
+            continue;
+
+        char const  *name = text + tokens[0].start;
+        uqword const hash = dictionary_hash(name, tokens[0].length);
+        if (dictionary_find_hashed(image, name, tokens[0].length, hash) != DICTIONARY_NONE)
+            continue;
+        udword slot = (udword) hash & image->mask;
+        while (image->slots[slot] != 0)
+            slot = (slot + 1) & image->mask;
+        image->slots[slot] = image->count + 1;
+
+        memcpy(image->names + names, name, tokens[0].length);
+        image->entries[image->count] = (dictionary_entry) {hash, (udword) names, (udword) tokens[0].length,
+                                                           DICTIONARY_NONE, DICTIONARY_NONE};
+        names += tokens[0].length;
+        bool const defined = count == 4 && tokens[1].length == 2 && text[tokens[1].start] == ':';
+        edges[2 * image->count] = defined ? tokens[2] : (dictionary_span) {0, 0};
+        edges[2 * image->count + 1] = defined ? tokens[3] : (dictionary_span) {0, 0};
+        image->count++;
+    }
+
+    for (udword i = 0; i < image->count; i++) {
+        if (edges[2 * i].length != 0)
+            image->entries[i].genus = dictionary_find(image, text + edges[2 * i].start, edges[2 * i].length);
+        if (edges[2 * i + 1].length != 0)
+            image->entries[i].whatness = dictionary_find(image, text + edges[2 * i + 1].start, edges[2 * i + 1].length);
+    }
+    free(edges);
+    return image;
+}
+
+void dictionary_image_free(dictionary_image *image) {
+    if (image)
+        atomic_fetch_sub_explicit(&dictionary_images, 1, memory_order_relaxed);
+    free(image);
+}
+
+udword dictionary_convert(dictionary_image const *image, char const *operand, uqword length, context *metrics) {
+    udword current = DICTIONARY_NONE;
+    uqword offset = 0, start, token, lookups = 0;
+    bool   converted = true;
+
+    while (converted && (token = dictionary_token(operand, length, &offset, &start)) != 0) {
+        udword const index = dictionary_find(image, operand + start, token);
+        lookups++;
+        // the first identifier is a root, and every one after it a child of the one before
+        converted = index != DICTIONARY_NONE && image->entries[index].genus == current;
+        current = index;
+    }
+    // only the last lookup can have missed
+    uqword const misses = lookups != 0 && current == DICTIONARY_NONE;
+    converted = converted && lookups != 0;
+    if (metrics) {
+        context_count(metrics, C_DICTIONARY_LOOKUPS, lookups);
+        context_count(metrics, C_DICTIONARY_HITS, lookups - misses);
+        context_count(metrics, C_DICTIONARY_MISSES, misses);
+        context_count(metrics, C_CONVERSIONS, converted);
+    }
+    return converted ? current : DICTIONARY_NONE;
+}
+
+/* PUBLICATION */
+
+static void dictionary_release(void *owner, void **images, uqword count) {
+    (void) owner;
+    for (uqword i = 0; i < count; i++)
+        dictionary_image_free(images[i]);
+}
+
+void dictionary_init(dictionary *dict, dictionary_image *image) {
+    atomic_init(&dict->image, image);
+}
+
+void dictionary_free(dictionary *dict) {
+    dictionary_image *image = atomic_exchange_explicit(&dict->image, NULL, memory_order_acq_rel);
+    m_epoch_synchronize();
+    dictionary_image_free(image);
+}
+
+void dictionary_publish(dictionary *dict, dictionary_image *image) {
+    // release, so that a reader which loads the new image sees it fully built
+    dictionary_image *old = atomic_exchange_explicit(&dict->image, image, memory_order_acq_rel);
+    if (old)
+        m_epoch_retire(old, dictionary_release, NULL);
+    // images are large and replaced rarely: free this one now rather than after some later retirement
+    m_epoch_synchronize();
+}
+
+uqword dictionary_convert_text(dictionary *dict, char const *text, uqword length, context *metrics) {
+    uqword converted = 0;
+    for (uqword offset = 0; offset < length;) {
+        char const *end = memchr(text + offset, ';', length - offset);
+        uqword const statement = end ? (uqword) (end - text) - offset : length - offset;
+        if (statement != 0) {
+            dictionary_image const *image = dictionary_enter(dict);
+            converted += dictionary_convert(image, text + offset, statement, metrics) != DICTIONARY_NONE;
+            dictionary_leave();
+        }
+        offset += statement + 1;
+    }
+    return converted;
+}
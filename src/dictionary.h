@@ -0,0 +1,118 @@
+/*
+ * Module: dictionary
+ * File: dictionary.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Dictionaries of Anno Domini identifiers and the conversion of operands against them. A dictionary image is built
+ * once from dictionary text and never changes afterwards: one allocation holding an open-addressing table of the
+ * identifiers, their genus and whatness edges, and their names.
+ *
+ * A dictionary publishes its current image RCU-style, so that it can be replaced while conversions are in flight. An
+ * update builds the new image off to the side and swaps it in with one atomic exchange; the old image is retired
+ * through m_epoch, and the update waits until every reader which could have loaded it has left its critical section,
+ * then frees it. Readers take no locks and never wait: they enter an epoch critical section, load the image once and
+ * use it until they leave.
+ */
+
+#ifndef PROJECT_AQUINAS_DICTIONARY_H
+#define PROJECT_AQUINAS_DICTIONARY_H
+
+#include <stdatomic.h>
+#include <platform.h>
+#include "compiler.h"
+#include "memory/m_epoch.h"
+
+// index of no identifier: the genus of a root, or the result of a failed lookup or conversion
+#define DICTIONARY_NONE ((udword) -1)
+
+typedef struct dictionary_entry {
+    uqword hash;
+    // offset and length of the name in the names of the image
+    udword name;
+    udword length;
+    udword genus;
+    udword whatness;
+} dictionary_entry;
+
+typedef struct dictionary_image {
+    udword            count;
+    // slots - 1; the table is at most half full
+    udword            mask;
+    // index + 1 of the entry in each slot, or 0 when the slot is empty
+    udword           *slots;
+    dictionary_entry *entries;
+    char             *names;
+} dictionary_image;
+
+typedef struct dictionary {
+    _Atomic(dictionary_image *) image;
+} dictionary;
+
+/*
+ * Builds an image from dictionary text: statements "name ;" for roots and "name := genus whatness ;" for the rest. An
+ * identifier defined twice keeps its first definition; edges to undefined identifiers are DICTIONARY_NONE. The process
+ * terminates if the image cannot be allocated.
+ */
+dictionary_image *dictionary_build(char const *text, uqword length);
+
+void dictionary_image_free(dictionary_image *image);
+
+/*
+ * Returns the number of images built and not yet freed, by every dictionary.
+ */
+uqword dictionary_image_count(void);
+
+/*
+ * Returns the index of the identifier `name` in `image`, or DICTIONARY_NONE.
+ */
+udword dictionary_find(dictionary_image const *image, char const *name, uqword length);
+
+/*
+ * Converts one operand, a token string following genus edges from a root downwards (without its ';'). Returns the
+ * index of the last identifier, or DICTIONARY_NONE when a token is undefined or not a child of the one before it.
+ * Counts lookups, hits, misses and conversions in `metrics` unless it is NULL.
+ */
+udword dictionary_convert(dictionary_image const *image, char const *operand, uqword length, context *metrics);
+
+/*
+ * Publishes `image` as the first image of `dict`.
+ */
+void dictionary_init(dictionary *dict, dictionary_image *image);
+
+/*
+ * Waits out the readers of the current image, then frees it.
+ */
+void dictionary_free(dictionary *dict);
+
+/*
+ * Enters an epoch critical section and returns the current image, which stays valid until dictionary_leave.
+ */
+static inline dictionary_image const *dictionary_enter(dictionary *dict) {
+    m_epoch_enter();
+    return atomic_load_explicit(&dict->image, memory_order_acquire);
+}
+
+static inline void dictionary_leave(void) {
+    m_epoch_exit();
+}
+
+/*
+ * Swaps `image` in as the current image of `dict` and retires the one it replaces. Readers which entered before the
+ * swap keep the old image; every reader which enters afterwards sees the new one. Returns once those readers have left
+ * and the old image is freed, so it must not be called inside a critical section.
+ */
+void dictionary_publish(dictionary *dict, dictionary_image *image);
+
+/*
+ * Converts every operand statement of `text` against the current image of `dict`, loading the image afresh for each
+ * statement, and returns how many converted.
+ */
+uqword dictionary_convert_text(dictionary *dict, char const *text, uqword length, context *metrics);
+
+#endif //PROJECT_AQUINAS_DICTIONARY_H
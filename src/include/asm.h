@@ -92,14 +92,29 @@ __attribute__((always_inline, cold)) static inline struct cpuid_function_values
     return values;
 }
 
+/*
+ * cpuid for leaves which take a subleaf in ecx, such as leaf 4 (deterministic cache parameters).
+ */
+__attribute__((always_inline, cold)) static inline struct cpuid_function_values __x64_cpuid_count(uint32_t function,
+                                                                                                  uint32_t subfunction) {
+    struct cpuid_function_values values;
+    asm volatile (
+    "cpuid"
+    : "=a" (values.eax), "=b" (values.ebx), "=c" (values.ecx), "=d" (values.edx)
+    : "a" (function), "c" (subfunction));
+    return values;
+}
+
 __attribute__((always_inline)) static inline uint64_t __x64_lzcnt(uint64_t value) {
-    asm("lzcntq %0, %0" : "+X" (value) : "X" (value));
-    return value;
+    uint64_t result;
+    asm("lzcntq %1, %0" : "=r" (result) : "rm" (value) : "cc");
+    return result;
 }
 
 __attribute__((always_inline)) static inline uint64_t __x64_popcnt(uint64_t value) {
-    asm("popcntq %0, %0" : "+X" (value) : "X" (value));
-    return value;
+    uint64_t result;
+    asm("popcntq %1, %0" : "=r" (result) : "rm" (value) : "cc");
+    return result;
 }
 
 __attribute__((always_inline)) static inline uint64_t __x64_rol(uint64_t value, uint64_t shift_count) {
@@ -113,8 +128,53 @@ __attribute__((always_inline)) static inline uint64_t __x64_ror(uint64_t value,
 }
 
 __attribute__((always_inline)) static inline uint64_t __x64_tzcnt(uint64_t value) {
-    asm("tzcntq %0, %0" : "+X" (value) : "X" (value));
-    return value;
+    uint64_t result;
+    asm("tzcntq %1, %0" : "=r" (result) : "rm" (value) : "cc");
+    return result;
+}
+
+// time stamp counter
+
+__attribute__((always_inline)) static inline void __x64_lfence() {
+    asm volatile ("lfence" ::: "memory");
+}
+
+__attribute__((always_inline)) static inline uint64_t __x64_rdtsc() {
+    uint32_t lo, hi;
+    asm volatile ("rdtsc" : "=a" (lo), "=d" (hi));
+    return (uint64_t) hi << 32 | lo;
+}
+
+/*
+ * Waits for earlier instructions to execute before reading the counter; `aux` receives IA32_TSC_AUX (the processor
+ * number on Linux and Windows). Requires cpuid 0x80000001 edx bit 27.
+ */
+__attribute__((always_inline)) static inline uint64_t __x64_rdtscp(uint32_t *aux) {
+    uint32_t lo, hi;
+    asm volatile ("rdtscp" : "=a" (lo), "=d" (hi), "=c" (*aux));
+    return (uint64_t) hi << 32 | lo;
+}
+
+/*
+ * Reads the counter at the start of a measured region: earlier instructions complete before the read, and later ones
+ * do not start until after it.
+ */
+__attribute__((always_inline)) static inline uint64_t __x64_rdtsc_begin() {
+    __x64_lfence();
+    uint64_t const cycles = __x64_rdtsc();
+    __x64_lfence();
+    return cycles;
+}
+
+/*
+ * Reads the counter at the end of a measured region: the region completes before the read, and later instructions do
+ * not start until after it.
+ */
+__attribute__((always_inline)) static inline uint64_t __x64_rdtscp_end() {
+    uint32_t aux;
+    uint64_t const cycles = __x64_rdtscp(&aux);
+    __x64_lfence();
+    return cycles;
 }
 
 // FLAGS register info
@@ -198,13 +258,15 @@ __attribute__((always_inline, cold)) static inline struct cpuid_function_values
 }
 
 __attribute__((always_inline)) static inline uint32_t __x86_lzcnt(uint32_t value) {
-    asm("lzcntl %0, %0" : "+X" (value) : "X" (value));
-    return value;
+    uint32_t result;
+    asm("lzcntl %1, %0" : "=r" (result) : "rm" (value) : "cc");
+    return result;
 }
 
 __attribute__((always_inline)) static inline uint32_t __x86_popcnt(uint32_t value) {
-    asm("popcntl %0, %0" : "+X" (value) : "X" (value));
-    return value;
+    uint32_t result;
+    asm("popcntl %1, %0" : "=r" (result) : "rm" (value) : "cc");
+    return result;
 }
 
 __attribute__((always_inline)) static inline uint32_t __x86_rol(uint32_t value, uint32_t shift_count) {
@@ -218,8 +280,9 @@ __attribute__((always_inline)) static inline uint32_t __x86_ror(uint32_t value,
 }
 
 __attribute__((always_inline)) static inline uint32_t __x86_tzcnt(uint32_t value) {
-    asm("tzcntl %0, %0" : "+X" (value) : "X" (value));
-    return value;
+    uint32_t result;
+    asm("tzcntl %1, %0" : "=r" (result) : "rm" (value) : "cc");
+    return result;
 }
 
 // FLAGS register info
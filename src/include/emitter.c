@@ -0,0 +1,261 @@
+/*
+ * Module: emitter
+ * File: emitter.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "state.h"
+#include "emitter.h"
+#include "memory/m_profile.h"
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/uio.h>
+
+_Static_assert(sizeof(emitter_slice) == sizeof(struct iovec) &&
+               offsetof(emitter_slice, base) == offsetof(struct iovec, iov_base) &&
+               offsetof(emitter_slice, length) == offsetof(struct iovec, iov_len), "emitter_slice is not an iovec");
+#endif
+
+// address space reserved for a mapped output file, which may not grow past it
+#ifndef EMITTER_MAP_WINDOW
+  #define EMITTER_MAP_WINDOW ((uqword) 1u << 36u)
+#endif
+
+// bytes a mapped output file grows by at least
+#define EMITTER_MAP_GROWTH ((uqword) 1u << 24u)
+
+struct emitter {
+    enum emitter_mode mode;
+    // bytes reserved by flushes so far, which is the length of the output
+    _Atomic uqword    length;
+    atomic_bool       failed;
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+    int               fd;
+    // EMITTER_MMAP: the window and the current size of the file behind it, grown under `grow`
+    char             *map;
+    _Atomic uqword    size;
+    pthread_mutex_t   grow;
+#else
+    // flushes append in the order they take the lock
+    FILE             *file;
+    pthread_mutex_t   grow;
+#endif
+};
+
+emitter *emitter_open(char const *path, enum emitter_mode mode) {
+    emitter *output = calloc(1, sizeof(emitter));
+    if (!output)
+        fatalf(__func__, "failed to allocate an emitter\n");
+    output->mode = mode;
+    atomic_init(&output->length, 0);
+    atomic_init(&output->failed, false);
+    pthread_mutex_init(&output->grow, NULL);
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+    output->fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (output->fd < 0) {
+        warnf(__func__, "unable to open %s (errno %d)\n", path, errno);
+        pthread_mutex_destroy(&output->grow);
+        free(output);
+        return NULL;
+    }
+    if (mode == EMITTER_MMAP) {
+        // the window is only address space: pages exist once ftruncate has extended the file under them
+        void *map = mmap(NULL, EMITTER_MAP_WINDOW, PROT_READ | PROT_WRITE, MAP_SHARED, output->fd, 0);
+        if (map == MAP_FAILED) {
+            warnf(__func__, "unable to map %s (errno %d); writing it instead\n", path, errno);
+            output->mode = EMITTER_WRITEV;
+        } else {
+            output->map = map;
+        }
+    }
+    atomic_init(&output->size, 0);
+#else
+    output->file = fopen(path, "wb");
+    if (!output->file) {
+        warnf(__func__, "unable to open %s (errno %d)\n", path, errno);
+        pthread_mutex_destroy(&output->grow);
+        free(output);
+        return NULL;
+    }
+    if (mode == EMITTER_MMAP) {
+        warnf(__func__, "mapped output needs POSIX; writing %s instead\n", path);
+        output->mode = EMITTER_WRITEV;
+    }
+#endif
+    return output;
+}
+
+bool emitter_close(emitter *output) {
+    if (!output)
+        return false;
+    bool ok = !atomic_load(&output->failed);
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+    if (output->map) {
+        munmap(output->map, EMITTER_MAP_WINDOW);
+        // the file grew in steps; cut it back to what was written
+        if (ftruncate(output->fd, (off_t) atomic_load(&output->length)) != 0)
+            ok = false;
+    }
+    if (close(output->fd) != 0)
+        ok = false;
+#else
+    if (fclose(output->file) != 0)
+        ok = false;
+#endif
+    pthread_mutex_destroy(&output->grow);
+    free(output);
+    return ok;
+}
+
+enum emitter_mode emitter_get_mode(emitter const *output) {
+    return output->mode;
+}
+
+emitter_stream *emitter_stream_create(emitter *output) {
+    emitter_stream *stream = calloc(1, sizeof(emitter_stream));
+    if (!stream || !(stream->buffer = malloc(EMITTER_BUFFER)))
+        fatalf(__func__, "failed to allocate an output stream\n");
+    m_profile_allocation("emitter_stream", sizeof(emitter_stream) + EMITTER_BUFFER);
+    stream->output = output;
+    return stream;
+}
+
+void emitter_stream_free(emitter_stream *stream) {
+    if (!stream)
+        return;
+    emitter_flush(stream);
+    free(stream->buffer);
+    free(stream);
+}
+
+static void emitter_fail(emitter *output, char const *what) {
+    // one warning per emitter, not one per flush
+    if (!atomic_exchange(&output->failed, true))
+        warnf(__func__, "%s failed (errno %d); output is incomplete\n", what, errno);
+}
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+
+/*
+ * Returns the mapping of [offset, offset + length), extending the file under it if it does not reach that far yet, or
+ * NULL if it cannot be extended.
+ */
+static char *emitter_map(emitter *output, uqword offset, uqword length) {
+    uqword const end = offset + length;
+    if (end > EMITTER_MAP_WINDOW)
+        fatalf(__func__, "output of %llu bytes exceeds the mapped window\n", (unsigned long long) end);
+    if (end > atomic_load_explicit(&output->size, memory_order_acquire)) {
+        pthread_mutex_lock(&output->grow);
+        uqword size = atomic_load_explicit(&output->size, memory_order_relaxed);
+        if (end > size) {
+            size = size * 2 > end ? size * 2 : end;
+            if (size < EMITTER_MAP_GROWTH)
+                size = EMITTER_MAP_GROWTH;
+            if (size > EMITTER_MAP_WINDOW)
+                size = EMITTER_MAP_WINDOW;
+            if (ftruncate(output->fd, (off_t) size) != 0) {
+                pthread_mutex_unlock(&output->grow);
+                return NULL;
+            }
+            atomic_store_explicit(&output->size, size, memory_order_release);
+        }
+        pthread_mutex_unlock(&output->grow);
+    }
+    return output->map + offset;
+}
+
+static void emitter_write(emitter *output, emitter_slice *slices, udword count, uqword offset) {
+    while (count != 0) {
+        ssize_t written = pwritev(output->fd, (struct iovec const *) slices, (int) count, (off_t) offset);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0) {
+            emitter_fail(output, "pwritev");
+            return;
+        }
+        // a short write stops anywhere: skip the slices it finished and trim the one it stopped in
+        offset += (uqword) written;
+        while (count != 0 && (size_t) written >= slices->length) {
+            written -= (ssize_t) slices->length;
+            slices++;
+            count--;
+        }
+        if (count != 0) {
+            slices->base = (char *) slices->base + written;
+            slices->length -= (size_t) written;
+        }
+    }
+}
+
+#endif
+
+void emitter_flush(emitter_stream *stream) {
+    if (stream->pending == 0)
+        return;
+    emitter *output = stream->output;
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+    uqword const offset = atomic_fetch_add_explicit(&output->length, stream->pending, memory_order_relaxed);
+    if (output->mode == EMITTER_MMAP) {
+        char *at = emitter_map(output, offset, stream->pending);
+        if (!at) {
+            emitter_fail(output, "ftruncate");
+        } else {
+            for (udword i = 0; i < stream->count; i++) {
+                memcpy(at, stream->slices[i].base, stream->slices[i].length);
+                at += stream->slices[i].length;
+            }
+        }
+    } else {
+        emitter_write(output, stream->slices, stream->count, offset);
+    }
+#else
+    pthread_mutex_lock(&output->grow);
+    for (udword i = 0; i < stream->count; i++)
+        if (fwrite(stream->slices[i].base, 1, stream->slices[i].length, output->file) != stream->slices[i].length)
+            emitter_fail(output, "fwrite");
+    atomic_fetch_add_explicit(&output->length, stream->pending, memory_order_relaxed);
+    pthread_mutex_unlock(&output->grow);
+#endif
+
+    stream->count = 0;
+    stream->used = 0;
+    stream->pending = 0;
+}
+
+void emitter_put_reference(emitter_stream *stream, void const *data, uqword length) {
+    if (length == 0)
+        return;
+    if (stream->count == EMITTER_SLICES)
+        emitter_flush(stream);
+    stream->slices[stream->count++] = (emitter_slice) {(void *) data, length};
+    stream->pending += length;
+}
+
+void emitter_put_slow(emitter_stream *stream, void const *data, uqword length) {
+    emitter_flush(stream);
+    // too large for the buffer even when it is empty: written from where it is before the call returns
+    if (length > EMITTER_BUFFER) {
+        emitter_put_reference(stream, data, length);
+        emitter_flush(stream);
+        return;
+    }
+    emitter_put(stream, data, length);
+}
@@ -0,0 +1,124 @@
+/*
+ * Module: emitter
+ * File: emitter.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Buffered, vectored output of token strings. Every thread writing to an emitter does so through a stream of its own,
+ * which gathers slices: small ones are copied into the stream's buffer, coalescing with the slice before when they are
+ * adjacent, and large ones may be referenced in place. A flush reserves the next range of the output file with one
+ * atomic add and writes every slice gathered since the last flush into it, so that a thread makes one system call per
+ * megabyte of output rather than one per token:
+ *
+ *      EMITTER_WRITEV  the slices go out through pwritev at the reserved offset, up to IOV_MAX at once.
+ *      EMITTER_MMAP    the file is mapped into a large window and grown with ftruncate as reservations pass its end;
+ *                      a flush copies the slices straight into the mapping, and closing truncates the file to the
+ *                      bytes written. Output is then bounded by memory bandwidth, not system calls.
+ *
+ * The bytes of one flush are contiguous; flushes of different streams interleave in the order they reserve.
+ */
+
+#ifndef PROJECT_AQUINAS_EMITTER_H
+#define PROJECT_AQUINAS_EMITTER_H
+
+#include <string.h>
+#include <platform.h>
+
+// bytes a stream copies before it flushes
+#ifndef EMITTER_BUFFER
+  #define EMITTER_BUFFER (1u << 20u)
+#endif
+
+// slices a stream gathers before it flushes; IOV_MAX on Linux
+#ifndef EMITTER_SLICES
+  #define EMITTER_SLICES 1024
+#endif
+
+enum emitter_mode {
+    EMITTER_WRITEV,
+    EMITTER_MMAP
+};
+
+typedef struct emitter emitter;
+
+// laid out as struct iovec, so that the slices of a stream pass to pwritev as they are
+typedef struct emitter_slice {
+    void  *base;
+    size_t length;
+} emitter_slice;
+
+typedef struct emitter_stream {
+    emitter      *output;
+    // slices gathered, bytes of the buffer used, and bytes across all slices
+    udword        count;
+    uqword        used;
+    uqword        pending;
+    char         *buffer;
+    emitter_slice slices[EMITTER_SLICES];
+} emitter_stream;
+
+/*
+ * Creates or truncates the file at `path` for output in `mode`. Returns NULL with a warning if it cannot be opened; a
+ * mapping which cannot be made warns and falls back to EMITTER_WRITEV, as does EMITTER_MMAP outside POSIX.
+ */
+emitter *emitter_open(char const *path, enum emitter_mode mode);
+
+/*
+ * Closes the file once every stream has been freed; returns false if any write failed.
+ */
+bool emitter_close(emitter *output);
+
+enum emitter_mode emitter_get_mode(emitter const *output);
+
+/*
+ * Creates a stream for the calling thread; streams are not shared between threads.
+ */
+emitter_stream *emitter_stream_create(emitter *output);
+
+/*
+ * Flushes and frees `stream`.
+ */
+void emitter_stream_free(emitter_stream *stream);
+
+/*
+ * Writes everything gathered by `stream` to its emitter.
+ */
+void emitter_flush(emitter_stream *stream);
+
+void emitter_put_slow(emitter_stream *stream, void const *data, uqword length);
+
+/*
+ * Gathers `length` bytes from `data`, which `stream` references in place rather than copies; they must stay unchanged
+ * until the next flush.
+ */
+void emitter_put_reference(emitter_stream *stream, void const *data, uqword length);
+
+/*
+ * Copies `length` bytes from `data` into `stream`.
+ */
+static inline void emitter_put(emitter_stream *stream, void const *data, uqword length) {
+    if (stream->used + length > EMITTER_BUFFER || stream->count == EMITTER_SLICES) {
+        emitter_put_slow(stream, data, length);
+        return;
+    }
+    char *at = stream->buffer + stream->used;
+    memcpy(at, data, length);
+    stream->used += length;
+    stream->pending += length;
+
+    if (stream->count != 0) {
+        emitter_slice *last = &stream->slices[stream->count - 1];
+        if ((char *) last->base + last->length == at) {
+            last->length += length;
+            return;
+        }
+    }
+    stream->slices[stream->count++] = (emitter_slice) {at, length};
+}
+
+#endif //PROJECT_AQUINAS_EMITTER_H
@@ -0,0 +1,370 @@
+/*
+ * Module: file_reader
+ * File: file_reader.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <errno.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "state.h"
+#include "task.h"
+#include "file_reader.h"
+#include "memory/m_profile.h"
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+  #include <fcntl.h>
+  #include <unistd.h>
+  #if __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #define FILE_READER_HAS_URING 1
+  #endif
+#else
+  #include <stdio.h>
+#endif
+
+#ifndef FILE_READER_HAS_URING
+  #define FILE_READER_HAS_URING 0
+#endif
+
+// files in flight through io_uring at most, whatever the depth asked for
+#define FILE_READER_MAX_DEPTH 4096
+
+static file_buffer *file_buffer_create(udword index) {
+    file_buffer *buffer = malloc(sizeof(file_buffer) + FILE_READER_BUFFER);
+    if (!buffer)
+        fatalf(__func__, "failed to allocate a file buffer\n");
+    m_profile_allocation("file_buffer", sizeof(file_buffer) + FILE_READER_BUFFER);
+    *buffer = (file_buffer) {.index = index, .capacity = FILE_READER_BUFFER};
+    return buffer;
+}
+
+static file_buffer *file_buffer_grow(file_buffer *buffer) {
+    uqword const capacity = buffer->capacity * 2;
+    buffer = realloc(buffer, sizeof(file_buffer) + capacity);
+    if (!buffer)
+        fatalf(__func__, "failed to grow a file buffer to %llu bytes\n", (unsigned long long) capacity);
+    m_profile_allocation("file_buffer", capacity);
+    buffer->capacity = capacity;
+    return buffer;
+}
+
+void file_buffer_free(file_buffer *buffer) {
+    free(buffer);
+}
+
+static void file_deliver(mpmc_queue *output, file_buffer *buffer) {
+    void *item = buffer;
+    while (mpmc_enqueue(output, &item, 1) == 0)
+        sched_yield();
+}
+
+/* TASK POOL */
+
+typedef struct file_read_job {
+    char const *path;
+    udword      index;
+    mpmc_queue *output;
+} file_read_job;
+
+static void file_read_task(void *argument) {
+    file_read_job const *job = argument;
+    file_buffer         *buffer = file_buffer_create(job->index);
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+    int const fd = open(job->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        buffer->error = errno;
+    } else {
+        for (;;) {
+            if (buffer->length == buffer->capacity)
+                buffer = file_buffer_grow(buffer);
+            ssize_t const bytes = pread(fd, buffer->data + buffer->length, buffer->capacity - buffer->length,
+                                        (off_t) buffer->length);
+            if (bytes < 0 && errno == EINTR)
+                continue;
+            if (bytes < 0)
+                buffer->error = errno;
+            if (bytes <= 0)
+                break;
+            buffer->length += (uqword) bytes;
+        }
+        close(fd);
+    }
+#else
+    FILE *file = fopen(job->path, "rb");
+    if (!file) {
+        buffer->error = errno;
+    } else {
+        size_t bytes;
+        while ((bytes = fread(buffer->data + buffer->length, 1, buffer->capacity - buffer->length, file)) != 0) {
+            buffer->length += bytes;
+            if (buffer->length == buffer->capacity)
+                buffer = file_buffer_grow(buffer);
+        }
+        if (ferror(file))
+            buffer->error = EIO;
+        fclose(file);
+    }
+#endif
+
+    file_deliver(job->output, buffer);
+}
+
+static void file_read_threads(char const *const *paths, udword count, mpmc_queue *output) {
+    file_read_job *jobs = malloc((count ? count : 1) * sizeof(file_read_job));
+    if (!jobs)
+        fatalf(__func__, "failed to allocate %u read jobs\n", count);
+    task_group group = TASK_GROUP_INIT;
+    for (udword i = 0; i < count; i++) {
+        jobs[i] = (file_read_job) {paths[i], i, output};
+        task_spawn(&group, file_read_task, &jobs[i]);
+    }
+    task_sync(&group);
+    free(jobs);
+}
+
+/* IO_URING */
+
+#if FILE_READER_HAS_URING
+
+typedef struct file_uring {
+    int                  fd;
+    // submission ring: indices into sqes, published by storing sq_tail
+    _Atomic udword      *sq_head;
+    _Atomic udword      *sq_tail;
+    udword               sq_mask;
+    udword              *sq_array;
+    struct io_uring_sqe *sqes;
+    // completion ring: consumed by storing cq_head
+    _Atomic udword      *cq_head;
+    _Atomic udword      *cq_tail;
+    udword               cq_mask;
+    struct io_uring_cqe *cqes;
+    void                *sq_ring;
+    void                *cq_ring;
+    uqword               sq_ring_size;
+    uqword               cq_ring_size;
+    uqword               sqes_size;
+} file_uring;
+
+typedef struct file_uring_slot {
+    file_buffer *buffer;
+    // -1 until the open completes
+    int          fd;
+} file_uring_slot;
+
+static void file_uring_close(file_uring *ring) {
+    if (ring->sqes)
+        munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring && ring->cq_ring != ring->sq_ring)
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    if (ring->sq_ring)
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+/*
+ * Sets up a ring of `entries` submissions and checks that it supports opening and reading; returns false, with nothing
+ * left to release, if not.
+ */
+static bool file_uring_open(file_uring *ring, udword entries) {
+    struct io_uring_params params = {0};
+    *ring = (file_uring) {.fd = (int) syscall(__NR_io_uring_setup, entries, &params)};
+    if (ring->fd < 0)
+        return false;
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(udword);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    bool const single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single && ring->cq_ring_size > ring->sq_ring_size)
+        ring->sq_ring_size = ring->cq_ring_size;
+
+    void *sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                         IORING_OFF_SQ_RING);
+    ring->sq_ring = sq_ring != MAP_FAILED ? sq_ring : NULL;
+    void *cq_ring = single ? sq_ring : mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    ring->cq_ring = cq_ring != MAP_FAILED ? cq_ring : NULL;
+    void *sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                      IORING_OFF_SQES);
+    ring->sqes = sqes != MAP_FAILED ? sqes : NULL;
+    if (!ring->sq_ring || !ring->cq_ring || !ring->sqes) {
+        file_uring_close(ring);
+        return false;
+    }
+
+    ubyte *sq = ring->sq_ring, *cq = ring->cq_ring;
+    ring->sq_head = (_Atomic udword *) (sq + params.sq_off.head);
+    ring->sq_tail = (_Atomic udword *) (sq + params.sq_off.tail);
+    ring->sq_mask = *(udword *) (sq + params.sq_off.ring_mask);
+    ring->sq_array = (udword *) (sq + params.sq_off.array);
+    ring->cq_head = (_Atomic udword *) (cq + params.cq_off.head);
+    ring->cq_tail = (_Atomic udword *) (cq + params.cq_off.tail);
+    ring->cq_mask = *(udword *) (cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+
+    // OPENAT and READ arrived in 5.6, together with the probe itself
+    udword const            ops = 256;
+    struct io_uring_probe  *probe = calloc(1, sizeof(struct io_uring_probe) + ops * sizeof(struct io_uring_probe_op));
+    bool                    supported = probe && syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE,
+                                                         probe, ops) >= 0 && probe->last_op >= IORING_OP_READ &&
+                                        (probe->ops[IORING_OP_OPENAT].flags & IO_URING_OP_SUPPORTED) &&
+                                        (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+    free(probe);
+    if (!supported)
+        file_uring_close(ring);
+    return supported;
+}
+
+/*
+ * Returns a cleared submission at the tail of the ring, which is published by the next file_uring_enter. The caller
+ * never has more submissions outstanding than the ring has entries.
+ */
+static struct io_uring_sqe *file_uring_sqe(file_uring *ring, udword *tail) {
+    udword const         index = (*tail)++ & ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    ring->sq_array[index] = index;
+    return sqe;
+}
+
+/*
+ * Submits everything up to `tail` and waits for at least `wait` completions.
+ */
+static void file_uring_enter(file_uring *ring, udword tail, udword wait) {
+    atomic_store_explicit(ring->sq_tail, tail, memory_order_release);
+    for (;;) {
+        udword const submit = tail - atomic_load_explicit(ring->sq_head, memory_order_acquire);
+        if (syscall(__NR_io_uring_enter, ring->fd, submit, wait, IORING_ENTER_GETEVENTS, NULL, 0) >= 0)
+            return;
+        // interrupted (by the sampling profiler, say) or short of resources: whatever was submitted stays submitted
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            fatalf(__func__, "io_uring_enter failed with errno %d\n", errno);
+    }
+}
+
+static void file_uring_read(file_uring *ring, udword *tail, file_uring_slot const *slot, udword index) {
+    file_buffer         *buffer = slot->buffer;
+    struct io_uring_sqe *sqe = file_uring_sqe(ring, tail);
+    uqword const         room = buffer->capacity - buffer->length;
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = slot->fd;
+    sqe->addr = (uintptr_t) (buffer->data + buffer->length);
+    sqe->len = room < (1u << 30u) ? (udword) room : 1u << 30u;
+    sqe->off = buffer->length;
+    sqe->user_data = index;
+}
+
+static void file_uring_openat(file_uring *ring, udword *tail, char const *path, udword index) {
+    struct io_uring_sqe *sqe = file_uring_sqe(ring, tail);
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uintptr_t) path;
+    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    sqe->user_data = index;
+}
+
+static bool file_read_uring(char const *const *paths, udword count, udword depth, mpmc_queue *output) {
+    file_uring ring;
+    if (!file_uring_open(&ring, depth))
+        return false;
+
+    file_uring_slot *slots = calloc(depth, sizeof(file_uring_slot));
+    udword          *unused = malloc(depth * sizeof(udword));
+    if (!slots || !unused)
+        fatalf(__func__, "failed to allocate %u read slots\n", depth);
+    udword free_slots = depth;
+    for (udword i = 0; i < depth; i++)
+        unused[i] = depth - 1 - i;
+
+    udword tail = atomic_load_explicit(ring.sq_tail, memory_order_relaxed);
+    udword next = 0, in_flight = 0;
+    while (next < count || in_flight != 0) {
+        for (; next < count && free_slots != 0; next++, in_flight++) {
+            udword const index = unused[--free_slots];
+            slots[index] = (file_uring_slot) {file_buffer_create(next), -1};
+            file_uring_openat(&ring, &tail, paths[next], index);
+        }
+        file_uring_enter(&ring, tail, 1);
+
+        udword       head = atomic_load_explicit(ring.cq_head, memory_order_relaxed);
+        udword const completed = atomic_load_explicit(ring.cq_tail, memory_order_acquire);
+        for (; head != completed; head++) {
+            struct io_uring_cqe const *cqe = &ring.cqes[head & ring.cq_mask];
+            udword const               index = (udword) cqe->user_data;
+            file_uring_slot           *slot = &slots[index];
+            file_buffer               *buffer = slot->buffer;
+            dword const                result = cqe->res;
+
+            bool done = true;
+            if (result == -EINTR || result == -EAGAIN) {
+                done = false;
+            } else if (result < 0) {
+                buffer->error = -result;
+            } else if (slot->fd < 0) {
+                slot->fd = result;
+                done = false;
+            } else if (result != 0) {
+                // only an empty read is the end of the file: a read may stop short of what was asked for (a pipe, a
+                // procfs file, or the cap on one read) with more to come
+                buffer->length += (uqword) result;
+                if (buffer->length == buffer->capacity)
+                    slot->buffer = file_buffer_grow(buffer);
+                done = false;
+            }
+
+            if (!done) {
+                // the open is submitted again when it was interrupted, and otherwise the next read
+                if (slot->fd < 0)
+                    file_uring_openat(&ring, &tail, paths[slot->buffer->index], index);
+                else
+                    file_uring_read(&ring, &tail, slot, index);
+                continue;
+            }
+            if (slot->fd >= 0)
+                close(slot->fd);
+            file_deliver(output, slot->buffer);
+            unused[free_slots++] = index;
+            in_flight--;
+        }
+        atomic_store_explicit(ring.cq_head, head, memory_order_release);
+    }
+
+    free(unused);
+    free(slots);
+    file_uring_close(&ring);
+    return true;
+}
+
+#endif
+
+enum file_reader_mode file_read_all(char const *const *paths, udword count, udword depth, enum file_reader_mode mode,
+                                    mpmc_queue *output) {
+    if (depth == 0)
+        depth = 1;
+    if (depth > FILE_READER_MAX_DEPTH)
+        depth = FILE_READER_MAX_DEPTH;
+
+    if (mode != FILE_READER_THREADS) {
+#if FILE_READER_HAS_URING
+        if (file_read_uring(paths, count, depth, output))
+            return FILE_READER_URING;
+#endif
+        if (mode == FILE_READER_URING)
+            warnf(__func__, "io_uring is unavailable; reading on the task pool\n");
+    }
+    file_read_threads(paths, count, output);
+    return FILE_READER_THREADS;
+}
@@ -0,0 +1,63 @@
+/*
+ * Module: file_reader
+ * File: file_reader.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Batch reading of many source files, for compile jobs of thousands of small ones. On Linux the opens and reads go
+ * through io_uring, driven by the raw system calls: up to `depth` files are in flight at once, and every submission and
+ * completion for all of them is batched into one io_uring_enter per round. Where io_uring is missing or forbidden (an
+ * old kernel, a seccomp policy) the files are read with open and pread on the task pool instead.
+ *
+ * Each file arrives whole, as a file_buffer put into an MPMC queue as soon as its last read completes, so that lexers
+ * dequeuing from the other end start on the first files while the rest are still being read.
+ */
+
+#ifndef PROJECT_AQUINAS_FILE_READER_H
+#define PROJECT_AQUINAS_FILE_READER_H
+
+#include <platform.h>
+#include "queue.h"
+
+// bytes first read from a file; the buffer doubles for as long as reads fill it
+#ifndef FILE_READER_BUFFER
+  #define FILE_READER_BUFFER 16384
+#endif
+
+enum file_reader_mode {
+    // io_uring when the kernel allows it, otherwise the task pool
+    FILE_READER_AUTO,
+    FILE_READER_URING,
+    FILE_READER_THREADS
+};
+
+typedef struct file_buffer {
+    // index of the file in the paths given to file_read_all
+    udword index;
+    // errno of the failed open or read, or 0
+    dword  error;
+    uqword length;
+    uqword capacity;
+    char   data[];
+} file_buffer;
+
+/*
+ * Reads the `count` files of `paths` and enqueues a file_buffer for each into `output`, in order of completion,
+ * waiting while the queue is full; returns once every buffer has been enqueued, with the mode which read them. A file
+ * which cannot be read arrives with its error and no data. The consumer frees the buffers with file_buffer_free.
+ *
+ * In FILE_READER_URING mode, or in FILE_READER_AUTO mode when io_uring is available, at most `depth` files are open at
+ * once; the task pool bounds the threads mode instead. Requesting FILE_READER_URING where io_uring is unavailable warns
+ * and falls back to the task pool.
+ */
+enum file_reader_mode file_read_all(char const *const *paths, udword count, udword depth, enum file_reader_mode mode,
+                                    mpmc_queue *output);
+
+void file_buffer_free(file_buffer *buffer);
+
+#endif //PROJECT_AQUINAS_FILE_READER_H
@@ -0,0 +1,792 @@
+/*
+ * Module: logger
+ * File: logger.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Each ring is single producer (its thread) and single consumer (whoever holds log_drain_lock: the background thread,
+ * log_flush, or a synchronous write). Rings are never freed; a thread which exits releases its ring for reuse by the
+ * next thread which logs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "logger.h"
+
+static char const *const log_level_tags[] = {
+        [LOG_LEVEL_DEBUG]   = "[debug][",
+        [LOG_LEVEL_INFO]    = "[info][",
+        [LOG_LEVEL_WARNING] = "[warning][",
+        [LOG_LEVEL_FATAL]   = "[fatal][",
+};
+
+static void log_write_synchronous(enum log_level level, char const *fn_name, char const *context, char const *format,
+                                  va_list arguments) {
+    fputs(log_level_tags[level], stdout);
+    fputs(context, stdout);
+    fputs("][", stdout);
+    fputs(fn_name, stdout);
+    fputs("] ", stdout);
+    vprintf(format, arguments);
+}
+
+#if LOG_ASYNC
+
+#include <ctype.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+// direct-mapped cache of parsed formats per thread
+#define LOG_SIGNATURE_CACHE  64
+// longest conversion specification, such as "%-+#0*.*llx", which can be deferred
+#define LOG_SPECIFICATION    32
+#define LOG_OUTPUT_VECTORS   1020
+#define LOG_OUTPUT_BUFFER    (1u << 16)
+// signature count of a format which cannot be deferred
+#define LOG_UNDEFERRABLE     0xFF
+
+enum log_argument {
+    LOG_ARGUMENT_NONE,
+    LOG_ARGUMENT_UNSUPPORTED,
+    LOG_ARGUMENT_INT,
+    LOG_ARGUMENT_LONG,
+    LOG_ARGUMENT_LONG_LONG,
+    LOG_ARGUMENT_INTMAX,
+    LOG_ARGUMENT_SIZE,
+    LOG_ARGUMENT_PTRDIFF,
+    LOG_ARGUMENT_DOUBLE,
+    LOG_ARGUMENT_LONG_DOUBLE,
+    LOG_ARGUMENT_POINTER,
+    LOG_ARGUMENT_STRING
+};
+
+typedef struct log_conversion {
+    // past the conversion character
+    char const       *end;
+    // width and precision given as arguments, which precede the value
+    ubyte             stars;
+    enum log_argument argument;
+} log_conversion;
+
+typedef struct log_signature {
+    char const *format;
+    ubyte       count;
+    ubyte       arguments[LOG_MAX_ARGUMENTS];
+} log_signature;
+
+typedef struct log_record {
+    // bytes including the header and the arguments; a multiple of 8
+    uqword         size;
+    // NULL for the padding which skips the end of the ring
+    char const    *format;
+    char const    *function;
+    char const    *context;
+    enum log_level level;
+} log_record;
+
+typedef struct log_ring {
+    // written by the producer only
+    _Atomic uqword   head;
+    char             head_padding[P_CACHE_LINE_SIZE - sizeof(uqword)];
+    // written by the consumer only
+    _Atomic uqword   tail;
+    char             tail_padding[P_CACHE_LINE_SIZE - sizeof(uqword)];
+    atomic_bool      owned;
+    struct log_ring *next;
+    char            *buffer;
+    log_signature    signatures[LOG_SIGNATURE_CACHE];
+} log_ring;
+
+typedef struct log_output {
+    struct iovec vectors[LOG_OUTPUT_VECTORS];
+    udword       count;
+    uqword       used;
+    char         buffer[LOG_OUTPUT_BUFFER];
+} log_output;
+
+static _Atomic(log_ring *) log_rings;
+static _Thread_local log_ring *log_thread_ring;
+static pthread_key_t  log_ring_key;
+static pthread_once_t log_once = PTHREAD_ONCE_INIT;
+static atomic_bool    log_started;
+static pthread_mutex_t log_drain_lock = PTHREAD_MUTEX_INITIALIZER;
+// guarded by log_drain_lock
+static log_output log_pending;
+// the background thread waits on log_wake while every ring is empty, with log_idle set
+static pthread_mutex_t log_wake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  log_wake = PTHREAD_COND_INITIALIZER;
+static atomic_bool     log_idle;
+
+/* FORMATS */
+
+/*
+ * Parses the conversion specification which starts at the '%' in `start`.
+ */
+static log_conversion log_parse_conversion(char const *start) {
+    log_conversion conversion = {.stars = 0, .argument = LOG_ARGUMENT_UNSUPPORTED};
+    char const    *c          = start + 1;
+    enum { NONE, HH, H, L, LL, J, Z, T, LD } length = NONE;
+
+    while (*c && strchr("-+ #0'", *c))
+        c++;
+    if (*c == '*') {
+        conversion.stars++;
+        c++;
+    } else
+        while (isdigit((unsigned char) *c))
+            c++;
+    if (*c == '.') {
+        c++;
+        if (*c == '*') {
+            conversion.stars++;
+            c++;
+        } else
+            while (isdigit((unsigned char) *c))
+                c++;
+    }
+
+    switch (*c) {
+        case 'h':
+            length = c[1] == 'h' ? HH : H;
+            c += 1 + (length == HH);
+            break;
+        case 'l':
+            length = c[1] == 'l' ? LL : L;
+            c += 1 + (length == LL);
+            break;
+        case 'q':
+            length = LL;
+            c++;
+            break;
+        case 'j':
+            length = J;
+            c++;
+            break;
+        case 'z':
+            length = Z;
+            c++;
+            break;
+        case 't':
+            length = T;
+            c++;
+            break;
+        case 'L':
+            length = LD;
+            c++;
+            break;
+        default:
+            break;
+    }
+
+    conversion.end = *c ? c + 1 : c;
+    if (conversion.end - start >= LOG_SPECIFICATION)
+        return conversion;
+
+    switch (*c) {
+        case '%':
+            conversion.argument = conversion.stars ? LOG_ARGUMENT_UNSUPPORTED : LOG_ARGUMENT_NONE;
+            break;
+        case 'c':
+            conversion.argument = length == NONE ? LOG_ARGUMENT_INT : LOG_ARGUMENT_UNSUPPORTED;
+            break;
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            conversion.argument = (enum log_argument[]) {
+                    [NONE] = LOG_ARGUMENT_INT, [HH] = LOG_ARGUMENT_INT, [H] = LOG_ARGUMENT_INT,
+                    [L] = LOG_ARGUMENT_LONG, [LL] = LOG_ARGUMENT_LONG_LONG, [J] = LOG_ARGUMENT_INTMAX,
+                    [Z] = LOG_ARGUMENT_SIZE, [T] = LOG_ARGUMENT_PTRDIFF, [LD] = LOG_ARGUMENT_UNSUPPORTED
+            }[length];
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            conversion.argument = length == LD ? LOG_ARGUMENT_LONG_DOUBLE : length == NONE || length == L
+                                                                            ? LOG_ARGUMENT_DOUBLE
+                                                                            : LOG_ARGUMENT_UNSUPPORTED;
+            break;
+        case 's':
+            conversion.argument = length == NONE ? LOG_ARGUMENT_STRING : LOG_ARGUMENT_UNSUPPORTED;
+            break;
+        case 'p':
+            conversion.argument = length == NONE ? LOG_ARGUMENT_POINTER : LOG_ARGUMENT_UNSUPPORTED;
+            break;
+        default:
+            break;
+    }
+    return conversion;
+}
+
+static log_signature const *log_signature_of(log_ring *ring, char const *format) {
+    log_signature *signature = &ring->signatures[((uintptr_t) format >> 3u) % LOG_SIGNATURE_CACHE];
+    if (signature->format == format)
+        return signature;
+
+    signature->format = format;
+    signature->count = 0;
+    for (char const *c = strchr(format, '%'); c; c = strchr(c, '%')) {
+        log_conversion const conversion = log_parse_conversion(c);
+        ubyte const          count      = conversion.stars + (conversion.argument != LOG_ARGUMENT_NONE);
+
+        if (conversion.argument == LOG_ARGUMENT_UNSUPPORTED || signature->count + count > LOG_MAX_ARGUMENTS) {
+            signature->count = LOG_UNDEFERRABLE;
+            break;
+        }
+        for (ubyte star = 0; star < conversion.stars; star++)
+            signature->arguments[signature->count++] = LOG_ARGUMENT_INT;
+        if (conversion.argument != LOG_ARGUMENT_NONE)
+            signature->arguments[signature->count++] = conversion.argument;
+        c = conversion.end;
+    }
+    return signature;
+}
+
+/* PRODUCER */
+
+static void log_release_ring(void *ring) {
+    atomic_store_explicit(&((log_ring *) ring)->owned, false, memory_order_release);
+}
+
+static void *log_consume(void *unused);
+
+static void log_start(void) {
+    pthread_t consumer;
+
+    pthread_key_create(&log_ring_key, log_release_ring);
+    if (pthread_create(&consumer, NULL, log_consume, NULL) == 0) {
+        pthread_detach(consumer);
+        atomic_store(&log_started, true);
+    }
+    atexit(log_flush);
+}
+
+static log_ring *log_acquire_ring(void) {
+    log_ring *ring;
+
+    // reuse the ring of a thread which has exited; its pending records stay in order ahead of ours
+    for (ring = atomic_load_explicit(&log_rings, memory_order_acquire); ring; ring = ring->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong_explicit(&ring->owned, &expected, true, memory_order_acq_rel,
+                                                    memory_order_relaxed))
+            break;
+    }
+
+    if (!ring) {
+        ring = calloc(1, sizeof(log_ring));
+        if (!ring || !(ring->buffer = malloc(LOG_RING_CAPACITY)))
+            return NULL;
+        atomic_init(&ring->owned, true);
+        ring->next = atomic_load_explicit(&log_rings, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&log_rings, &ring->next, ring, memory_order_release,
+                                                      memory_order_relaxed));
+    }
+
+    pthread_setspecific(log_ring_key, ring);
+    return log_thread_ring = ring;
+}
+
+/*
+ * Returns the address at which `size` bytes may be written, waiting while the consumer catches up. Skips the end of
+ * the ring when the record would not fit before it; the caller publishes head + *skipped + size.
+ */
+static char *log_reserve(log_ring *ring, uqword head, uqword size, uqword *skipped) {
+    uqword const offset    = head & (LOG_RING_CAPACITY - 1u);
+    uqword const remaining = LOG_RING_CAPACITY - offset;
+
+    *skipped = remaining < size ? remaining : 0;
+    while (head + *skipped + size - atomic_load_explicit(&ring->tail, memory_order_acquire) > LOG_RING_CAPACITY)
+        sched_yield();
+
+    if (*skipped) {
+        // too short a gap for a header is skipped implicitly by the consumer
+        if (remaining >= sizeof(log_record))
+            memcpy(ring->buffer + offset, &(log_record) {.size = remaining, .format = NULL}, sizeof(log_record));
+        return ring->buffer;
+    }
+    return ring->buffer + offset;
+}
+
+static void log_write_locked(enum log_level level, char const *fn_name, char const *context, char const *format,
+                             va_list arguments);
+
+void log_submit(enum log_level level, char const *fn_name, char const *context, char const *format,
+                va_list arguments) {
+    pthread_once(&log_once, log_start);
+
+    log_ring *ring = log_thread_ring ? log_thread_ring : log_acquire_ring();
+    if (!ring || !atomic_load_explicit(&log_started, memory_order_relaxed)) {
+        log_write_locked(level, fn_name, context, format, arguments);
+        return;
+    }
+
+    log_signature const *signature = log_signature_of(ring, format);
+    if (signature->count == LOG_UNDEFERRABLE) {
+        log_write_locked(level, fn_name, context, format, arguments);
+        return;
+    }
+
+    // read every argument once, sizing the record as we go
+    union {
+        qword       integer;
+        double      real;
+        long double extended;
+        void       *pointer;
+        char const *string;
+    }      values[LOG_MAX_ARGUMENTS];
+    uqword lengths[LOG_MAX_ARGUMENTS];
+    uqword size = sizeof(log_record);
+    va_list copy;
+
+    va_copy(copy, arguments);
+    for (ubyte i = 0; i < signature->count; i++) {
+        switch (signature->arguments[i]) {
+            case LOG_ARGUMENT_INT:
+                values[i].integer = va_arg(copy, int);
+                break;
+            case LOG_ARGUMENT_LONG:
+                values[i].integer = va_arg(copy, long);
+                break;
+            case LOG_ARGUMENT_LONG_LONG:
+                values[i].integer = va_arg(copy, long long);
+                break;
+            case LOG_ARGUMENT_INTMAX:
+                values[i].integer = va_arg(copy, intmax_t);
+                break;
+            case LOG_ARGUMENT_SIZE:
+                values[i].integer = (qword) va_arg(copy, size_t);
+                break;
+            case LOG_ARGUMENT_PTRDIFF:
+                values[i].integer = va_arg(copy, ptrdiff_t);
+                break;
+            case LOG_ARGUMENT_DOUBLE:
+                values[i].real = va_arg(copy, double);
+                break;
+            case LOG_ARGUMENT_LONG_DOUBLE:
+                values[i].extended = va_arg(copy, long double);
+                size += sizeof(long double) - sizeof(uqword);
+                break;
+            case LOG_ARGUMENT_POINTER:
+                values[i].pointer = va_arg(copy, void *);
+                break;
+            default:
+                values[i].string = va_arg(copy, char const *);
+                if (!values[i].string)
+                    values[i].string = "(null)";
+                // length, then the terminated characters padded to 8 bytes
+                lengths[i] = strlen(values[i].string) + 1u;
+                size += (lengths[i] + 7u) & ~7ull;
+                break;
+        }
+        size += sizeof(uqword);
+    }
+    va_end(copy);
+
+    if (size > LOG_RING_CAPACITY / 2) {
+        log_write_locked(level, fn_name, context, format, arguments);
+        return;
+    }
+
+    uqword const head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uqword       skipped;
+    char        *cursor = log_reserve(ring, head, size, &skipped);
+    log_record const record = {.size = size, .format = format, .function = fn_name, .context = context, .level = level};
+
+    memcpy(cursor, &record, sizeof(record));
+    cursor += sizeof(record);
+    for (ubyte i = 0; i < signature->count; i++) {
+        switch (signature->arguments[i]) {
+            case LOG_ARGUMENT_LONG_DOUBLE:
+                memcpy(cursor, &values[i].extended, sizeof(long double));
+                cursor += sizeof(long double);
+                break;
+            case LOG_ARGUMENT_STRING:
+                memcpy(cursor, &lengths[i], sizeof(uqword));
+                memcpy(cursor + sizeof(uqword), values[i].string, lengths[i]);
+                cursor += sizeof(uqword) + ((lengths[i] + 7u) & ~7ull);
+                break;
+            default:
+                memcpy(cursor, &values[i], sizeof(uqword));
+                cursor += sizeof(uqword);
+                break;
+        }
+    }
+
+    atomic_store_explicit(&ring->head, head + skipped + size, memory_order_release);
+    // pairs with the fence in log_consume: either it sees the record, or this sees it idle and wakes it
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&log_idle, memory_order_relaxed)) {
+        pthread_mutex_lock(&log_wake_lock);
+        pthread_cond_signal(&log_wake);
+        pthread_mutex_unlock(&log_wake_lock);
+    }
+}
+
+/* CONSUMER */
+
+static void log_write_vectors(struct iovec *vectors, udword count) {
+    while (count) {
+        ssize_t written = writev(STDOUT_FILENO, vectors, (int) count);
+        if (written < 0)
+            return;
+        // resume after a partial write
+        while (count && (uqword) written >= vectors->iov_len) {
+            written -= (ssize_t) vectors->iov_len;
+            vectors++;
+            count--;
+        }
+        if (count) {
+            vectors->iov_base = (char *) vectors->iov_base + written;
+            vectors->iov_len -= (uqword) written;
+        }
+    }
+}
+
+static void log_output_flush(log_output *output) {
+    // anything written through stdio must come out first
+    fflush(stdout);
+    log_write_vectors(output->vectors, output->count);
+    output->count = 0;
+    output->used = 0;
+}
+
+static inline void log_output_vector(log_output *output, char const *base, uqword length) {
+    output->vectors[output->count++] = (struct iovec) {.iov_base = (void *) base, .iov_len = length};
+}
+
+/*
+ * Whether a conversion has no flags, width, precision or narrowing modifier ("%llu", "%X", "%s"), which covers nearly
+ * every message and is formatted without snprintf.
+ */
+static bool log_is_plain(char const *percent, char const *end) {
+    for (char const *c = percent + 1; c < end - 1; c++)
+        if (!strchr("lqjzt", *c))
+            return false;
+    return strchr("diuxXs", end[-1]) != NULL;
+}
+
+/*
+ * Writes the digits of a plain integer conversion backwards from `end` and returns the first character.
+ */
+static char *log_digits(char *end, qword value, enum log_argument argument, char conversion) {
+    uqword const bits     = argument == LOG_ARGUMENT_INT ? sizeof(int) * 8u
+                            : argument == LOG_ARGUMENT_LONG ? sizeof(long) * 8u : 64u;
+    bool const   negative = (conversion == 'd' || conversion == 'i') && value < 0;
+    uqword       digits   = negative ? -(uqword) value : (uqword) value & (bits == 64 ? ~0ull : (1ull << bits) - 1u);
+    char const  *symbols  = conversion == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+    uqword const base     = conversion == 'x' || conversion == 'X' ? 16u : 10u;
+
+    do {
+        *--end = symbols[digits % base];
+        digits /= base;
+    } while (digits);
+    if (negative)
+        *--end = '-';
+    return end;
+}
+
+/*
+ * Formats the arguments which follow the record header, snprintf style: writes at most `room` bytes (including the
+ * terminator) and returns the full length.
+ */
+static uqword log_format(char *out, uqword room, log_record const *record) {
+    char const *cursor = (char const *) (record + 1);
+    char const *format = record->format;
+    uqword      length = 0;
+
+    for (;;) {
+        char const *percent = strchr(format, '%');
+        uqword const literal = percent ? (uqword) (percent - format) : strlen(format);
+
+        if (length < room)
+            memcpy(out + length, format, literal < room - length ? literal : room - length);
+        length += literal;
+        if (!percent)
+            break;
+
+        log_conversion const conversion = log_parse_conversion(percent);
+
+        if (!conversion.stars && log_is_plain(percent, conversion.end)) {
+            char        digits[24];
+            char const *text;
+            uqword      text_length;
+
+            if (conversion.argument == LOG_ARGUMENT_STRING) {
+                memcpy(&text_length, cursor, sizeof(text_length));
+                text = cursor + sizeof(text_length);
+                cursor = text + ((text_length + 7u) & ~7ull);
+                // the stored length counts the terminator
+                text_length--;
+            } else {
+                qword value;
+                memcpy(&value, cursor, sizeof(value));
+                cursor += sizeof(value);
+                text = log_digits(digits + sizeof(digits), value, conversion.argument, conversion.end[-1]);
+                text_length = (uqword) (digits + sizeof(digits) - text);
+            }
+
+            if (length < room)
+                memcpy(out + length, text, text_length < room - length ? text_length : room - length);
+            length += text_length;
+            format = conversion.end;
+            continue;
+        }
+
+        char                 specification[LOG_SPECIFICATION];
+        int                  stars[2]    = {0, 0};
+        char                *destination = length < room ? out + length : NULL;
+        uqword const         available   = length < room ? room - length : 0;
+        int                  written     = 0;
+
+        memcpy(specification, percent, (uqword) (conversion.end - percent));
+        specification[conversion.end - percent] = '\0';
+        for (ubyte star = 0; star < conversion.stars; star++) {
+            qword value;
+            memcpy(&value, cursor, sizeof(value));
+            stars[star] = (int) value;
+            cursor += sizeof(value);
+        }
+
+        #define log_print(value) (                                                                                   \
+            conversion.stars == 0 ? snprintf(destination, available, specification, value) :                         \
+            conversion.stars == 1 ? snprintf(destination, available, specification, stars[0], value) :               \
+                                    snprintf(destination, available, specification, stars[0], stars[1], value))
+
+        switch (conversion.argument) {
+            case LOG_ARGUMENT_NONE:
+                written = snprintf(destination, available, "%%");
+                break;
+            case LOG_ARGUMENT_LONG_DOUBLE: {
+                long double value;
+                memcpy(&value, cursor, sizeof(value));
+                cursor += sizeof(value);
+                written = log_print(value);
+                break;
+            }
+            case LOG_ARGUMENT_STRING: {
+                uqword string_length;
+                memcpy(&string_length, cursor, sizeof(string_length));
+                char const *string = cursor + sizeof(string_length);
+                cursor = string + ((string_length + 7u) & ~7ull);
+                written = log_print(string);
+                break;
+            }
+            default: {
+                qword value;
+                memcpy(&value, cursor, sizeof(value));
+                cursor += sizeof(value);
+                switch (conversion.argument) {
+                    case LOG_ARGUMENT_INT:
+                        written = log_print((int) value);
+                        break;
+                    case LOG_ARGUMENT_LONG:
+                        written = log_print((long) value);
+                        break;
+                    case LOG_ARGUMENT_LONG_LONG:
+                        written = log_print((long long) value);
+                        break;
+                    case LOG_ARGUMENT_INTMAX:
+                        written = log_print((intmax_t) value);
+                        break;
+                    case LOG_ARGUMENT_SIZE:
+                        written = log_print((size_t) value);
+                        break;
+                    case LOG_ARGUMENT_PTRDIFF:
+                        written = log_print((ptrdiff_t) value);
+                        break;
+                    case LOG_ARGUMENT_DOUBLE: {
+                        double real;
+                        memcpy(&real, &value, sizeof(real));
+                        written = log_print(real);
+                        break;
+                    }
+                    default: {
+                        void *pointer;
+                        memcpy(&pointer, &value, sizeof(pointer));
+                        written = log_print(pointer);
+                        break;
+                    }
+                }
+                break;
+            }
+        }
+        #undef log_print
+
+        length += written > 0 ? (uqword) written : 0;
+        format = conversion.end;
+    }
+
+    if (room)
+        out[length < room ? length : room - 1u] = '\0';
+    return length;
+}
+
+/*
+ * Writes the prefix ("[info][context][function] ") and returns its length.
+ */
+static uqword log_prefix(char *out, log_record const *record) {
+    char const *parts[] = {log_level_tags[record->level], record->context, "][", record->function, "] "};
+    uqword      written = 0;
+
+    // NULL measures only
+    for (ubyte i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+        uqword const length = strlen(parts[i]);
+        if (out)
+            memcpy(out + written, parts[i], length);
+        written += length;
+    }
+    return written;
+}
+
+static void log_output_record(log_output *output, log_record const *record) {
+    uqword const prefix = log_prefix(NULL, record);
+
+    // records are appended to the buffer, and consecutive records share one vector
+    for (bool flushed = false;; flushed = true) {
+        uqword const room = LOG_OUTPUT_BUFFER - output->used;
+        char *const  base = output->buffer + output->used;
+
+        if (prefix < room && output->count < LOG_OUTPUT_VECTORS) {
+            uqword const length = prefix + log_format(base + prefix, room - prefix, record);
+            if (length < room) {
+                log_prefix(base, record);
+                struct iovec *last = output->count ? &output->vectors[output->count - 1] : NULL;
+                if (last && (char *) last->iov_base + last->iov_len == base)
+                    last->iov_len += length;
+                else
+                    log_output_vector(output, base, length);
+                output->used += length;
+                return;
+            }
+        }
+        if (flushed)
+            break;
+        log_output_flush(output);
+    }
+
+    // longer than the whole output buffer
+    uqword const length  = prefix + log_format(NULL, 0, record);
+    char        *message = malloc(length + 1u);
+    if (message) {
+        log_prefix(message, record);
+        log_format(message + prefix, length + 1u - prefix, record);
+        log_output_vector(output, message, length);
+        log_output_flush(output);
+    }
+    free(message);
+}
+
+/*
+ * Formats and writes every published record; the caller holds log_drain_lock. Returns whether anything was written.
+ */
+static bool log_drain(void) {
+    bool drained = false;
+
+    for (log_ring *ring = atomic_load_explicit(&log_rings, memory_order_acquire); ring; ring = ring->next) {
+        uqword const head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uqword       tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+        while (tail != head) {
+            uqword const offset    = tail & (LOG_RING_CAPACITY - 1u);
+            uqword const remaining = LOG_RING_CAPACITY - offset;
+            log_record   record;
+
+            if (remaining < sizeof(log_record)) {
+                tail += remaining;
+                continue;
+            }
+            memcpy(&record, ring->buffer + offset, sizeof(record));
+            if (record.format)
+                log_output_record(&log_pending, (log_record const *) (ring->buffer + offset));
+            tail += record.size;
+        }
+
+        if (atomic_load_explicit(&ring->tail, memory_order_relaxed) != tail) {
+            // the output no longer refers to the ring, so the space can be handed back
+            atomic_store_explicit(&ring->tail, tail, memory_order_release);
+            drained = true;
+        }
+    }
+
+    if (log_pending.count)
+        log_output_flush(&log_pending);
+    return drained;
+}
+
+static bool log_pending_records(void) {
+    for (log_ring *ring = atomic_load_explicit(&log_rings, memory_order_acquire); ring; ring = ring->next)
+        if (atomic_load_explicit(&ring->head, memory_order_relaxed) !=
+            atomic_load_explicit(&ring->tail, memory_order_relaxed))
+            return true;
+    return false;
+}
+
+static void *log_consume(void *unused) {
+    (void) unused;
+
+    for (;;) {
+        pthread_mutex_lock(&log_drain_lock);
+        bool const drained = log_drain();
+        pthread_mutex_unlock(&log_drain_lock);
+        if (drained)
+            continue;
+
+        // announce the wait before looking again, so that a record published meanwhile either is seen or signals
+        pthread_mutex_lock(&log_wake_lock);
+        atomic_store_explicit(&log_idle, true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!log_pending_records())
+            pthread_cond_wait(&log_wake, &log_wake_lock);
+        atomic_store_explicit(&log_idle, false, memory_order_relaxed);
+        pthread_mutex_unlock(&log_wake_lock);
+    }
+    return NULL;
+}
+
+static void log_write_locked(enum log_level level, char const *fn_name, char const *context, char const *format,
+                             va_list arguments) {
+    pthread_mutex_lock(&log_drain_lock);
+    log_drain();
+    log_write_synchronous(level, fn_name, context, format, arguments);
+    fflush(stdout);
+    pthread_mutex_unlock(&log_drain_lock);
+}
+
+void log_flush(void) {
+    if (!atomic_load(&log_started)) {
+        fflush(stdout);
+        return;
+    }
+    pthread_mutex_lock(&log_drain_lock);
+    log_drain();
+    pthread_mutex_unlock(&log_drain_lock);
+}
+
+#else
+
+void log_submit(enum log_level level, char const *fn_name, char const *context, char const *format,
+                va_list arguments) {
+    log_write_synchronous(level, fn_name, context, format, arguments);
+}
+
+void log_flush(void) {
+    fflush(stdout);
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * Module: logger
+ * File: logger.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Deferred logging behind info, infof and warnf. A log call copies the format pointer and its raw arguments (strings
+ * by value) into a ring owned by the calling thread; a background thread formats the records and writes them to
+ * standard output in batches with writev. Records from one thread keep their order; records from different threads
+ * are interleaved in the order their rings are drained.
+ *
+ * Format strings, function names and context names are stored by address and must have static storage duration
+ * (string literals and __func__ do).
+ */
+
+#ifndef PROJECT_AQUINAS_LOGGER_H
+#define PROJECT_AQUINAS_LOGGER_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <platform.h>
+
+enum log_level {
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARNING,
+    LOG_LEVEL_FATAL
+};
+
+/*
+ * Defers formatting to a background thread where POSIX threads and writev are available; otherwise every record is
+ * formatted and written by the calling thread.
+ */
+#ifndef LOG_ASYNC
+  #if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+    #define LOG_ASYNC 1
+  #else
+    #define LOG_ASYNC 0
+  #endif
+#endif
+
+/*
+ * Bytes of each thread's ring; a power of two. A record larger than half of the ring is written synchronously.
+ */
+#ifndef LOG_RING_CAPACITY
+  #define LOG_RING_CAPACITY (1u << 20)
+#endif
+
+#if LOG_RING_CAPACITY & (LOG_RING_CAPACITY - 1)
+  #error "[build][fatal][logger] LOG_RING_CAPACITY must be a power of two"
+#endif
+
+/*
+ * Most arguments (including width and precision given as '*') one deferred record may carry.
+ */
+#define LOG_MAX_ARGUMENTS 24
+
+/*
+ * Records a message; the characters of each %s argument are copied into the record, so they need not outlive the
+ * call. Formats with more than LOG_MAX_ARGUMENTS arguments, or with conversions which cannot be deferred (%n and wide
+ * characters), or records larger than half a ring, are written synchronously after the pending records.
+ */
+void log_submit(enum log_level level, char const *fn_name, char const *context, char const *format,
+                va_list arguments);
+
+/*
+ * Writes every record submitted so far (by any thread) before returning. Registered with atexit, and called by
+ * fatalf before it reports the error.
+ */
+void log_flush(void);
+
+#endif //PROJECT_AQUINAS_LOGGER_H
@@ -0,0 +1,231 @@
+/*
+ * Module: m_epoch
+ * File: m_epoch.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "state.h"
+#include "memory/m_epoch.h"
+
+// objects released through one call of a release function at most
+#define M_EPOCH_RELEASE_RUN 64
+
+typedef struct m_epoch_retired {
+    void           *object;
+    m_epoch_release release;
+    void           *owner;
+} m_epoch_retired;
+
+typedef struct m_epoch_limbo {
+    // the epoch in which the objects were retired
+    uqword           epoch;
+    uqword           count;
+    uqword           capacity;
+    m_epoch_retired *retired;
+} m_epoch_limbo;
+
+typedef struct m_epoch_record {
+    // the announced epoch shifted left by one, with the low bit set while inside a critical section
+    _Atomic uqword         announced;
+    char                   announced_padding[P_CACHE_LINE_SIZE - sizeof(uqword)];
+    atomic_bool            owned;
+    uqword                 nesting;
+    // limbo lists for the three epochs which may hold memory: the current one and the two before it
+    m_epoch_limbo          limbo[3];
+    // objects across the limbo lists
+    uqword                 pending;
+    struct m_epoch_record *next;
+} m_epoch_record;
+
+// starts at 2 so that "two epochs ago" never underflows
+static _Atomic uqword                  m_epoch_global = 2;
+static _Atomic(m_epoch_record *)       m_epoch_records;
+static pthread_key_t                   m_epoch_key;
+static pthread_once_t                  m_epoch_once = PTHREAD_ONCE_INIT;
+static _Thread_local m_epoch_record   *m_epoch_self;
+
+static void m_epoch_release_record(void *record) {
+    atomic_store_explicit(&((m_epoch_record *) record)->announced, 0, memory_order_release);
+    atomic_store_explicit(&((m_epoch_record *) record)->owned, false, memory_order_release);
+}
+
+static void m_epoch_start(void) {
+    pthread_key_create(&m_epoch_key, m_epoch_release_record);
+}
+
+/*
+ * Returns the record of the calling thread, taking over the record of an exited thread (and what it left in limbo)
+ * when there is one.
+ */
+static m_epoch_record *m_epoch_record_of_thread(void) {
+    if (m_epoch_self)
+        return m_epoch_self;
+    pthread_once(&m_epoch_once, m_epoch_start);
+
+    m_epoch_record *record;
+    for (record = atomic_load_explicit(&m_epoch_records, memory_order_acquire); record; record = record->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong_explicit(&record->owned, &expected, true, memory_order_acq_rel,
+                                                    memory_order_relaxed))
+            break;
+    }
+    if (!record) {
+        record = calloc(1, sizeof(m_epoch_record));
+        if (!record)
+            fatalf(__func__, "failed to allocate an epoch record\n");
+        atomic_init(&record->owned, true);
+        record->next = atomic_load_explicit(&m_epoch_records, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&m_epoch_records, &record->next, record, memory_order_release,
+                                                      memory_order_relaxed));
+    }
+    pthread_setspecific(m_epoch_key, record);
+    return m_epoch_self = record;
+}
+
+static void m_epoch_announce(m_epoch_record *record) {
+    uqword const epoch = atomic_load_explicit(&m_epoch_global, memory_order_relaxed);
+    // sequentially consistent, so that a thread advancing the epoch either sees the announcement or is seen advancing
+    atomic_store_explicit(&record->announced, epoch << 1u | 1u, memory_order_seq_cst);
+}
+
+/*
+ * Advances the global epoch if every thread inside a critical section has announced the current one.
+ */
+static bool m_epoch_advance(void) {
+    uqword epoch = atomic_load_explicit(&m_epoch_global, memory_order_seq_cst);
+    for (m_epoch_record *record = atomic_load_explicit(&m_epoch_records, memory_order_acquire); record;
+         record = record->next) {
+        uqword const announced = atomic_load_explicit(&record->announced, memory_order_seq_cst);
+        if ((announced & 1u) && announced >> 1u != epoch)
+            return false;
+    }
+    return atomic_compare_exchange_strong_explicit(&m_epoch_global, &epoch, epoch + 1, memory_order_acq_rel,
+                                                   memory_order_relaxed);
+}
+
+/*
+ * Hands the objects of `limbo`, one of the lists of `record`, to their release functions, in runs of equal function
+ * and owner.
+ */
+static void m_epoch_release_limbo(m_epoch_record *record, m_epoch_limbo *limbo) {
+    void *run[M_EPOCH_RELEASE_RUN];
+    record->pending -= limbo->count;
+    for (uqword i = 0; i < limbo->count;) {
+        m_epoch_retired const *first = &limbo->retired[i];
+        uqword                 count = 0;
+        while (i < limbo->count && count < M_EPOCH_RELEASE_RUN && limbo->retired[i].release == first->release &&
+               limbo->retired[i].owner == first->owner)
+            run[count++] = limbo->retired[i++].object;
+        first->release(first->owner, run, count);
+    }
+    limbo->count = 0;
+}
+
+/*
+ * Releases the limbo lists of `record` retired two or more epochs before the current one.
+ */
+static void m_epoch_collect(m_epoch_record *record) {
+    uqword const epoch = atomic_load_explicit(&m_epoch_global, memory_order_acquire);
+    for (udword i = 0; i < 3; i++)
+        if (record->limbo[i].count != 0 && record->limbo[i].epoch + 2 <= epoch)
+            m_epoch_release_limbo(record, &record->limbo[i]);
+}
+
+void m_epoch_enter(void) {
+    m_epoch_record *record = m_epoch_record_of_thread();
+    if (record->nesting++ == 0)
+        m_epoch_announce(record);
+}
+
+void m_epoch_exit(void) {
+    m_epoch_record *record = m_epoch_self;
+    if (!record || record->nesting == 0)
+        fatalf(__func__, "not inside an epoch critical section\n");
+    if (--record->nesting != 0)
+        return;
+    atomic_store_explicit(&record->announced, 0, memory_order_release);
+    // a thread which retires rarely would otherwise wait for its next retirement to release anything
+    if (record->pending != 0) {
+        m_epoch_advance();
+        m_epoch_collect(record);
+    }
+}
+
+void m_epoch_quiescent(void) {
+    m_epoch_record *record = m_epoch_record_of_thread();
+    if (record->nesting != 0)
+        m_epoch_announce(record);
+    m_epoch_advance();
+    m_epoch_collect(record);
+}
+
+void m_epoch_retire(void *object, m_epoch_release release, void *owner) {
+    m_epoch_record *record = m_epoch_record_of_thread();
+    // the caller's unlinking stores come before the epoch is read: a reader which announces a later epoch cannot find
+    // the object, and one which found it holds this epoch back
+    atomic_thread_fence(memory_order_seq_cst);
+    uqword const   epoch = atomic_load_explicit(&m_epoch_global, memory_order_acquire);
+    m_epoch_limbo *limbo = &record->limbo[epoch % 3];
+
+    // the list last held the epoch three before this one, which is safe by now
+    if (limbo->epoch != epoch) {
+        if (limbo->count != 0)
+            m_epoch_release_limbo(record, limbo);
+        limbo->epoch = epoch;
+    }
+    if (limbo->count == limbo->capacity) {
+        uqword const     capacity = limbo->capacity ? limbo->capacity * 2 : M_EPOCH_BATCH;
+        m_epoch_retired *retired = realloc(limbo->retired, capacity * sizeof(m_epoch_retired));
+        if (!retired)
+            fatalf(__func__, "failed to grow a limbo list to %llu objects\n", (unsigned long long) capacity);
+        limbo->retired = retired;
+        limbo->capacity = capacity;
+    }
+    limbo->retired[limbo->count++] = (m_epoch_retired) {object, release, owner};
+    record->pending++;
+
+    // the first retirement of an epoch starts it moving; after that, every batch
+    if (limbo->count == 1 || limbo->count % M_EPOCH_BATCH == 0) {
+        m_epoch_advance();
+        m_epoch_collect(record);
+    }
+}
+
+void m_epoch_release_free(void *owner, void **objects, uqword count) {
+    (void) owner;
+    for (uqword i = 0; i < count; i++)
+        free(objects[i]);
+}
+
+void m_epoch_synchronize(void) {
+    m_epoch_record *self = m_epoch_record_of_thread();
+    if (self->nesting != 0)
+        fatalf(__func__, "called inside an epoch critical section\n");
+
+    uqword const target = atomic_load_explicit(&m_epoch_global, memory_order_acquire) + 2;
+    while (atomic_load_explicit(&m_epoch_global, memory_order_acquire) < target)
+        if (!m_epoch_advance())
+            sched_yield();
+
+    m_epoch_collect(self);
+    // what exited threads left behind is released by whoever takes over their records, or here
+    for (m_epoch_record *record = atomic_load_explicit(&m_epoch_records, memory_order_acquire); record;
+         record = record->next) {
+        bool expected = false;
+        if (!atomic_compare_exchange_strong_explicit(&record->owned, &expected, true, memory_order_acq_rel,
+                                                     memory_order_relaxed))
+            continue;
+        m_epoch_collect(record);
+        atomic_store_explicit(&record->owned, false, memory_order_release);
+    }
+}
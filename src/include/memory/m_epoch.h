@@ -0,0 +1,75 @@
+/*
+ * Module: m_epoch
+ * File: m_epoch.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Epoch-based reclamation, for structures whose readers take no locks. Readers bracket their accesses with
+ * m_epoch_enter and m_epoch_exit, which announce the global epoch the thread has observed; a writer which unlinks a
+ * node or replaces a bucket array passes the old memory to m_epoch_retire instead of freeing it. Retired memory waits
+ * in the retiring thread's limbo list for the epoch in which it was retired, and the global epoch only advances once
+ * every thread inside a critical section has announced the current one; memory retired two epochs ago can no longer
+ * be reached by any reader and is released in batches, each batch of objects with the same release function and owner
+ * handed to it at once so that it can return them to the allocator they came from.
+ *
+ * The epoch is advanced, and a thread's limbo lists collected, by that thread: when it retires the first object of an
+ * epoch and every M_EPOCH_BATCH objects after, when it leaves its outermost critical section with memory in limbo, and
+ * in m_epoch_quiescent and m_epoch_synchronize. A thread which retires and then neither reads nor retires again should
+ * call m_epoch_synchronize, or its last objects wait for the thread to exit and another to take over its record.
+ *
+ * A thread which stays inside a critical section for long (a worker looping over a shared structure) holds the epoch
+ * back for everyone; it should call m_epoch_quiescent whenever it holds no references, which re-announces the epoch.
+ */
+
+#ifndef PROJECT_AQUINAS_M_EPOCH_H
+#define PROJECT_AQUINAS_M_EPOCH_H
+
+#include <platform.h>
+
+// retirements into one limbo list after which the retiring thread tries to advance the epoch and release memory
+#ifndef M_EPOCH_BATCH
+  #define M_EPOCH_BATCH 64
+#endif
+
+/*
+ * Returns `count` objects of `owner` to it; the objects were retired together with this function and owner.
+ */
+typedef void (*m_epoch_release)(void *owner, void **objects, uqword count);
+
+/*
+ * Begins a critical section in which the calling thread may read structures protected by epochs. Sections nest.
+ */
+void m_epoch_enter(void);
+
+void m_epoch_exit(void);
+
+/*
+ * Declares that the calling thread holds no references to protected memory at this point, even inside a critical
+ * section, and releases what has become safe to release.
+ */
+void m_epoch_quiescent(void);
+
+/*
+ * Releases `object` through release(owner, ...) once no reader can reach it. The object must already be unreachable
+ * for readers which start after this call. May be called inside or outside a critical section; inside one, the object
+ * outlives it, since the caller's own announcement holds the epoch back.
+ */
+void m_epoch_retire(void *object, m_epoch_release release, void *owner);
+
+/*
+ * A release function which frees objects obtained from malloc.
+ */
+void m_epoch_release_free(void *owner, void **objects, uqword count);
+
+/*
+ * Waits until every critical section which began before the call has ended, then releases what the calling thread
+ * and any exited thread have retired. Must not be called inside a critical section.
+ */
+void m_epoch_synchronize(void);
+
+#endif //PROJECT_AQUINAS_M_EPOCH_H
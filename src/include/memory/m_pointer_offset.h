@@ -18,6 +18,7 @@
 #include "platform.h"
 #include "m_context.h"
 #include "bit_math.h"
+#include "fix_math.h"
 
 /*
  *  Computes the optimal size of a pointer_offset data type in bits for the given
@@ -45,38 +46,11 @@ static inline udqword m_compute_required_space(ubyte address_bits, ubyte offset_
     // filter to permit values in [0, 2**6)
     offset_bits &= 0x3f;
     
-    register udqword a = 0;
-    register udqword b = 0;
-    
-    // b_address - b_offset
-    a = address_bits - offset_bits;
-    // normalize to 64.64 fixed point
-    a <<= 64;
-    // multiply by 2**(-b_offset)
-    a >>= offset_bits;
-    // add b_offset
-    a += (udqword) offset_bits << 64;
-    
-    // multiply integer part by elements
-    b           = (a >> 64) * elements;
-    
-    // filter fraction part
-    a &= 0xFFFFFFFFFFFFFFFF;
-    // compute exponent of the fraction part
-    offset_bits = 65 - sigbits((uqword) a);
-    // reduce fraction part
-    a >>= cnttz((uqword) a);
-    
-    // multiply fraction part by elements
-    a *= ((udqword) elements);
-    
-    // combine integer and fraction parts and put in b
-    b += a >> offset_bits;
-    
-    // compute ceiled integer result
-    b += filter((uqword) a, offset_bits, 0) != 0;
-    
-    return b;
+    // (b_address - b_offset) * 2**(-b_offset) + b_offset in 64.64 fixed point
+    fix_t const width = (((fix_t) (address_bits - offset_bits) << 64) >> offset_bits) + ((fix_t) offset_bits << 64);
+
+    // ceiled integer product with elements
+    return (udqword) fix_mul_q(width, (fix_t) elements, 64, FIX_ROUND_UP, false);
 }
 
 #endif //PROJECT_AQUINAS_M_POINTER_OFFSET_H
@@ -0,0 +1,252 @@
+/*
+ * Module: m_profile
+ * File: m_profile.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+// tested before any header is included, so PLATFORM (from platform.h) is not defined yet
+#if defined(__linux__) || defined(__unix__)
+  // dladdr
+  #define _GNU_SOURCE
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "state.h"
+#include "memory/m_profile.h"
+
+#if PLATFORM == P_WINDOWS || ENVIRONMENT == P_WINDOWS
+  #include <windows.h>
+#elif PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+  #include <dlfcn.h>
+  #include <execinfo.h>
+#endif
+
+typedef struct m_profile_site {
+    uqword      hash;
+    char const *allocator;
+    ubyte       size_class;
+    ubyte       context_count;
+    ubyte       frame_count;
+    char const *contexts[M_PROFILE_FRAMES];
+    void       *frames[M_PROFILE_FRAMES];
+    uqword      samples;
+    // estimated bytes allocated at the site
+    double      bytes;
+} m_profile_site;
+
+atomic_bool          m_profile_recording;
+_Thread_local qword  m_profile_countdown;
+static _Thread_local uqword m_profile_random;
+
+static _Atomic uqword  m_profile_period = 1;
+static atomic_flag     m_profile_lock = ATOMIC_FLAG_INIT;
+static m_profile_site *m_profile_sites;
+static uqword          m_profile_capacity, m_profile_count;
+
+static void m_profile_acquire(void) {
+    while (atomic_flag_test_and_set_explicit(&m_profile_lock, memory_order_acquire))
+        continue;
+}
+
+static void m_profile_release(void) {
+    atomic_flag_clear_explicit(&m_profile_lock, memory_order_release);
+}
+
+void m_profile_start(uqword period) {
+    atomic_store(&m_profile_period, period != 0 ? period : 1);
+    atomic_store(&m_profile_recording, true);
+}
+
+void m_profile_stop(void) {
+    atomic_store(&m_profile_recording, false);
+}
+
+void m_profile_reset(void) {
+    m_profile_acquire();
+    free(m_profile_sites);
+    m_profile_sites = NULL;
+    m_profile_capacity = m_profile_count = 0;
+    m_profile_release();
+}
+
+/*
+ * Bytes until the next sample: exponentially distributed with mean `period`, from a per-thread xorshift64*.
+ */
+static qword m_profile_interval(uqword period) {
+    if (period <= 1)
+        return 1;
+    if (m_profile_random == 0)
+        m_profile_random = (uqword) (uintptr_t) &m_profile_random ^ p_get_time(CYCLES) ^ 0x9E3779B97F4A7C15u;
+    m_profile_random ^= m_profile_random >> 12u;
+    m_profile_random ^= m_profile_random << 25u;
+    m_profile_random ^= m_profile_random >> 27u;
+    // uniform in (0, 1]
+    double const uniform = (double) ((m_profile_random * 0x2545F4914F6CDD1Du) >> 11u) / (double) (1ull << 53) +
+                           1.0 / (double) (1ull << 53);
+    return (qword) (-log(uniform) * (double) period) + 1;
+}
+
+static uqword m_profile_capture(void **frames) {
+#if PLATFORM == P_WINDOWS || ENVIRONMENT == P_WINDOWS
+    // skips m_profile_capture and m_profile_sample
+    return CaptureStackBackTrace(2, M_PROFILE_FRAMES, frames, NULL);
+#elif PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+    void *captured[M_PROFILE_FRAMES + 2];
+    int const count = backtrace(captured, M_PROFILE_FRAMES + 2);
+    if (count <= 2)
+        return 0;
+    memcpy(frames, captured + 2, (uqword) (count - 2) * sizeof(void *));
+    return (uqword) (count - 2);
+#else
+    (void) frames;
+    return 0;
+#endif
+}
+
+static uqword m_profile_hash(m_profile_site const *site) {
+    uqword hash = 0xCBF29CE484222325u;
+#define M_PROFILE_MIX(value) hash = (hash ^ (uqword) (uintptr_t) (value)) * 0x100000001B3u
+    M_PROFILE_MIX(site->allocator);
+    M_PROFILE_MIX(site->size_class);
+    for (ubyte i = 0; i < site->context_count; i++)
+        M_PROFILE_MIX(site->contexts[i]);
+    for (ubyte i = 0; i < site->frame_count; i++)
+        M_PROFILE_MIX(site->frames[i]);
+#undef M_PROFILE_MIX
+    return hash | 1u;
+}
+
+static bool m_profile_same(m_profile_site const *a, m_profile_site const *b) {
+    return a->hash == b->hash && a->allocator == b->allocator && a->size_class == b->size_class &&
+           a->context_count == b->context_count && a->frame_count == b->frame_count &&
+           memcmp(a->contexts, b->contexts, a->context_count * sizeof(char const *)) == 0 &&
+           memcmp(a->frames, b->frames, a->frame_count * sizeof(void *)) == 0;
+}
+
+/*
+ * Returns the slot of `site` in the open-addressed table, or the empty slot where it belongs.
+ */
+static m_profile_site *m_profile_slot(m_profile_site *sites, uqword capacity, m_profile_site const *site) {
+    for (uqword i = site->hash & (capacity - 1);; i = (i + 1) & (capacity - 1))
+        if (sites[i].hash == 0 || m_profile_same(&sites[i], site))
+            return &sites[i];
+}
+
+static bool m_profile_grow(void) {
+    uqword const    capacity = m_profile_capacity != 0 ? m_profile_capacity * 2 : 256;
+    m_profile_site *sites = calloc(capacity, sizeof(m_profile_site));
+    if (sites == NULL)
+        return false;
+    for (uqword i = 0; i < m_profile_capacity; i++)
+        if (m_profile_sites[i].hash != 0)
+            *m_profile_slot(sites, capacity, &m_profile_sites[i]) = m_profile_sites[i];
+    free(m_profile_sites);
+    m_profile_sites = sites;
+    m_profile_capacity = capacity;
+    return true;
+}
+
+void m_profile_sample(char const *allocator, uqword bytes) {
+    uqword const period = atomic_load_explicit(&m_profile_period, memory_order_relaxed);
+    bool const   first = m_profile_random == 0;
+    m_profile_countdown = m_profile_interval(period);
+    // the countdown of a thread starts at zero, which is no sample
+    if (first && period > 1)
+        return;
+
+    m_profile_site site = {.allocator = allocator, .samples = 1};
+    site.size_class = (ubyte) (bytes > 1 ? 64 - __builtin_clzll(bytes - 1) : 0);
+    // an allocation of b bytes is sampled with probability 1 - e^(-b/period), so it stands for b over that
+    site.bytes = period > 1 ? (double) bytes / -expm1(-(double) bytes / (double) period) : (double) bytes;
+
+    // the innermost contexts are kept when the stack is deeper than a sample holds
+    uqword const depth = get_context_depth() + 1;
+    uqword const skip = depth > M_PROFILE_FRAMES ? depth - M_PROFILE_FRAMES : 0;
+    for (uqword i = skip; i < depth; i++)
+        site.contexts[site.context_count++] = _global_context_stack[i];
+    site.frame_count = (ubyte) m_profile_capture(site.frames);
+    site.hash = m_profile_hash(&site);
+
+    m_profile_acquire();
+    if ((m_profile_count + 1) * 2 > m_profile_capacity && !m_profile_grow()) {
+        m_profile_release();
+        return;
+    }
+    m_profile_site *slot = m_profile_slot(m_profile_sites, m_profile_capacity, &site);
+    if (slot->hash == 0) {
+        *slot = site;
+        m_profile_count++;
+    } else {
+        slot->samples++;
+        slot->bytes += site.bytes;
+    }
+    m_profile_release();
+}
+
+/*
+ * Writes a frame name with the separators of the folded format replaced.
+ */
+static void m_profile_frame(FILE *file, char const *name) {
+    for (; *name != '\0'; name++)
+        fputc(*name == ';' || *name == ' ' || *name == '\n' ? '_' : *name, file);
+    fputc(';', file);
+}
+
+static void m_profile_address(FILE *file, void *address) {
+    char name[256];
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+    Dl_info info = {0};
+    if (dladdr(address, &info) != 0 && info.dli_sname != NULL) {
+        snprintf(name, sizeof(name), "%s", info.dli_sname);
+    } else if (info.dli_fname != NULL) {
+        char const *module = strrchr(info.dli_fname, '/');
+        snprintf(name, sizeof(name), "%s+0x%llx", module != NULL ? module + 1 : info.dli_fname,
+                 (unsigned long long) ((uintptr_t) address - (uintptr_t) info.dli_fbase));
+    } else
+#endif
+    {
+        snprintf(name, sizeof(name), "0x%llx", (unsigned long long) (uintptr_t) address);
+    }
+    m_profile_frame(file, name);
+}
+
+static void m_profile_size_class(FILE *file, ubyte size_class) {
+    static char const units[] = {'B', 'K', 'M', 'G', 'T', 'P', 'E'};
+    ubyte const       unit = size_class / 10u;
+    fprintf(file, "<=%llu%c", 1ull << (size_class - unit * 10u), units[unit]);
+}
+
+bool m_profile_write(char const *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+        return false;
+
+    m_profile_acquire();
+    for (uqword i = 0; i < m_profile_capacity; i++) {
+        m_profile_site const *site = &m_profile_sites[i];
+        if (site->hash == 0)
+            continue;
+
+        for (ubyte j = 0; j < site->context_count; j++)
+            m_profile_frame(file, site->contexts[j] != NULL ? site->contexts[j] : "?");
+        // return addresses run from the innermost frame outwards
+        for (ubyte j = site->frame_count; j > 0; j--)
+            m_profile_address(file, site->frames[j - 1]);
+        m_profile_frame(file, site->allocator);
+        m_profile_size_class(file, site->size_class);
+        fprintf(file, " %llu\n", (unsigned long long) (site->bytes + 0.5));
+    }
+    m_profile_release();
+
+    bool const written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
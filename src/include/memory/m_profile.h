@@ -0,0 +1,79 @@
+/*
+ * Module: m_profile
+ * File: m_profile.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Allocation-site sampling for allocation flame graphs. Allocators report each allocation through m_profile_allocation;
+ * while profiling, one allocation is sampled on average every `period` bytes (the byte distance between samples is
+ * drawn from an exponential distribution, so that allocation patterns cannot alias with the period). A sample records
+ * the context stack of the thread (the phases and containers which called push_context), a compact backtrace of return
+ * addresses, the allocator and the size class, and is weighted by the bytes it stands for. m_profile_write emits the
+ * aggregated samples as folded stacks, one "frame;frame;... bytes" line per site, for flamegraph.pl, speedscope or
+ * inferno.
+ *
+ * With M_PROFILE set to 0 the hook compiles to nothing.
+ */
+
+#ifndef PROJECT_AQUINAS_M_PROFILE_H
+#define PROJECT_AQUINAS_M_PROFILE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "platform.h"
+
+#ifndef M_PROFILE
+  #define M_PROFILE 1
+#endif
+
+// return addresses kept per sample
+#define M_PROFILE_FRAMES 16
+
+extern atomic_bool m_profile_recording;
+extern _Thread_local qword m_profile_countdown;
+
+/*
+ * Starts sampling one allocation every `period` bytes on average; a period of 1 records every allocation.
+ */
+void m_profile_start(uqword period);
+
+void m_profile_stop(void);
+
+/*
+ * Discards the samples recorded so far.
+ */
+void m_profile_reset(void);
+
+/*
+ * Writes the samples as folded stacks weighted by estimated bytes allocated. Returns false if the file cannot be written.
+ */
+bool m_profile_write(char const *path);
+
+/*
+ * Records a sampled allocation; called through m_profile_allocation.
+ */
+void m_profile_sample(char const *allocator, uqword bytes);
+
+/*
+ * Reports an allocation of `bytes` bytes by `allocator` (a static string naming the allocator or container).
+ */
+__attribute__((always_inline))
+static inline void m_profile_allocation(char const *allocator, uqword bytes) {
+#if M_PROFILE
+    if (!atomic_load_explicit(&m_profile_recording, memory_order_relaxed))
+        return;
+    m_profile_countdown -= (qword) bytes;
+    if (m_profile_countdown <= 0)
+        m_profile_sample(allocator, bytes);
+#else
+    (void) allocator;
+    (void) bytes;
+#endif
+}
+
+#endif //PROJECT_AQUINAS_M_PROFILE_H
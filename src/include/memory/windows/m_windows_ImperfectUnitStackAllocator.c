@@ -16,6 +16,8 @@
 #include "m_windows_ImperfectUnitStackAllocator.h"
 #include "platform.h"
 #include "bit_math.h"
+#include "trace.h"
+#include "memory/m_profile.h"
 
 typedef struct {
     udqword actually_allocated_bits;
@@ -70,6 +72,7 @@ static uqword local_compute_required_bytes_for_stack(udqword program_lifetime_bi
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wshift-count-overflow"
 void w32_stack_create(udqword program_lifetime_bit_quantity) {
+    trace_scope(__func__);
     // add space to program_lifetime_bit_quantity for heap size and number of allocated bits
     program_lifetime_bit_quantity += bitwidth(m_windows_selflike_page_list_info) + bitwidth(m_windows_stack_info);
 #define local_LARGEST_ALLOCATION_VALUE ((DWORD)-1ll)
@@ -120,6 +123,7 @@ void w32_stack_create(udqword program_lifetime_bit_quantity) {
 #pragma clang diagnostic pop
 
 void w32_stack_destroy(void) {
+    trace_scope(__func__);
     if (M_WINDOWS_PAGING_STATEHOLDS_STACK != NULL) {
         BOOL VirtualFree_succeeded = VirtualFree(M_WINDOWS_PAGING_STATEHOLDS_STACK, 0, MEM_RELEASE);
         if (VirtualFree_succeeded != TRUE) {
@@ -147,6 +151,8 @@ m_windows_stack_pointer w32_stack_allocate(void) {
     w32_stack_ensure_sufficient_space(1);
     // increment allocation count
     m_windows_stack_info_offset()->allocation_count_part0++;
+    trace_counter("w32_stack_allocated_bits", (qword) m_windows_stack_info_offset()->allocation_count_part0);
+    m_profile_allocation("w32_stack_allocate", 1);
     // compute stack pointer and return it
     return m_windows_compute_pointer_from_offset(m_windows_stack_info_offset()->allocation_count_part0);
 }
@@ -158,6 +164,8 @@ m_windows_stack_pointer w32_stack_allocate_all(udqword const bits) {
     w32_stack_ensure_sufficient_space(bits);
     // add bits onto allocation count
     m_windows_stack_info_offset()->allocation_count_part0 += bits;
+    trace_counter("w32_stack_allocated_bits", (qword) m_windows_stack_info_offset()->allocation_count_part0);
+    m_profile_allocation("w32_stack_allocate_all", (uqword) ((bits + 7u) >> 3u));
     // compute stack pointer and return it
     return m_windows_compute_pointer_from_offset(m_windows_stack_info_offset()->allocation_count_part0);
 }
@@ -173,6 +181,7 @@ void w32_stack_deallocate() {
 
     // deallocate the allocation
     m_windows_stack_info_offset()->allocation_count_part0 -= 1;
+    trace_counter("w32_stack_allocated_bits", (qword) m_windows_stack_info_offset()->allocation_count_part0);
 }
 
 void w32_stack_deallocate_all(m_windows_stack_pointer starting_allocation, m_windows_stack_pointer most_recent_allocation) {
@@ -189,4 +198,5 @@ void w32_stack_deallocate_all(m_windows_stack_pointer starting_allocation, m_win
         fatalf(__func__, "starting_allocation was not allocated in the allocation boundary of the internal stack allocator\n");
     // deallocate the allocation
     m_windows_stack_info_offset()->allocation_count_part0 -= abs_diff(m_windows_stack_info_offset()->allocation_count_part0, starting_allocation);
+    trace_counter("w32_stack_allocated_bits", (qword) m_windows_stack_info_offset()->allocation_count_part0);
 }
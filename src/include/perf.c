@@ -0,0 +1,175 @@
+/*
+ * Module: perf
+ * File: perf.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <stdatomic.h>
+#include <string.h>
+#include "state.h"
+#include "perf.h"
+
+static char const *const perf_counter_names[PERF_COUNTERS] = {
+        [PERF_CYCLES]        = "cycles",
+        [PERF_INSTRUCTIONS]  = "instructions",
+        [PERF_L1D_MISSES]    = "l1d_misses",
+        [PERF_LLC_MISSES]    = "llc_misses",
+        [PERF_BRANCH_MISSES] = "branch_misses",
+        [PERF_DTLB_MISSES]   = "dtlb_misses",
+};
+
+char const *perf_counter_name(enum perf_counter counter) {
+    return perf_counter_names[counter];
+}
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define PERF_CACHE_EVENT(cache) \
+    ((cache) | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+
+static struct {
+    udword type;
+    uqword config;
+} const perf_counter_events[PERF_COUNTERS] = {
+        [PERF_CYCLES]        = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        [PERF_INSTRUCTIONS]  = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        [PERF_L1D_MISSES]    = {PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(PERF_COUNT_HW_CACHE_L1D)},
+        [PERF_LLC_MISSES]    = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        [PERF_BRANCH_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        [PERF_DTLB_MISSES]   = {PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(PERF_COUNT_HW_CACHE_DTLB)},
+};
+
+// layout of a read with PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+typedef struct perf_read {
+    uqword count;
+    uqword enabled;
+    uqword running;
+    uqword values[PERF_COUNTERS];
+} perf_read;
+
+// a kernel group which counted nothing is reported once, not once per region
+static atomic_bool perf_unscheduled_warned;
+
+bool perf_group_open(perf_group *group) {
+    for (ubyte pair = 0; pair < PERF_GROUPS; pair++)
+        group->leaders[pair] = -1;
+    group->count = 0;
+
+    for (ubyte counter = 0; counter < PERF_COUNTERS; counter++) {
+        int *const leader = &group->leaders[counter / 2];
+        struct perf_event_attr attributes;
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = perf_counter_events[counter].type;
+        attributes.config = perf_counter_events[counter].config;
+        attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attributes.disabled = *leader == -1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+
+        int const descriptor = (int) syscall(SYS_perf_event_open, &attributes, 0, -1, *leader, 0);
+        group->descriptors[counter] = descriptor;
+        if (descriptor == -1)
+            continue;
+        if (*leader == -1)
+            *leader = descriptor;
+        group->count++;
+    }
+    return group->count != 0;
+}
+
+void perf_group_close(perf_group *group) {
+    for (ubyte counter = 0; counter < PERF_COUNTERS; counter++)
+        if (group->descriptors[counter] != -1)
+            close(group->descriptors[counter]);
+    for (ubyte pair = 0; pair < PERF_GROUPS; pair++)
+        group->leaders[pair] = -1;
+    group->count = 0;
+}
+
+void perf_group_begin(perf_group *group) {
+    for (ubyte pair = 0; pair < PERF_GROUPS; pair++) {
+        if (group->leaders[pair] == -1)
+            continue;
+        ioctl(group->leaders[pair], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(group->leaders[pair], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void perf_group_end(perf_group *group, perf_sample *sample) {
+    memset(sample, 0, sizeof(*sample));
+    for (ubyte pair = 0; pair < PERF_GROUPS; pair++)
+        if (group->leaders[pair] != -1)
+            ioctl(group->leaders[pair], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    for (ubyte pair = 0; pair < PERF_GROUPS; pair++) {
+        if (group->leaders[pair] == -1)
+            continue;
+        ubyte members = 0;
+        for (ubyte counter = (ubyte) (2 * pair); counter < PERF_COUNTERS && counter < 2 * pair + 2; counter++)
+            members += group->descriptors[counter] != -1;
+
+        perf_read read_values;
+        ssize_t const length = read(group->leaders[pair], &read_values, sizeof(read_values));
+        if (length < (ssize_t) (3 * sizeof(uqword)) || read_values.count != members)
+            continue;
+        // opened, but never scheduled onto the PMU (its counters taken by others, or none offered at all)
+        if (read_values.running == 0) {
+            if (read_values.enabled != 0 && !atomic_exchange(&perf_unscheduled_warned, true))
+                warnf(__func__, "the %s counters were never scheduled; they are reported as invalid\n",
+                      perf_counter_names[2 * pair]);
+            continue;
+        }
+
+        double const running = (double) read_values.running / (double) read_values.enabled;
+        if (sample->running == 0 || running < sample->running)
+            sample->running = running;
+        // values follow in the order the counters of the pair were opened
+        ubyte member = 0;
+        for (ubyte counter = (ubyte) (2 * pair); counter < PERF_COUNTERS && counter < 2 * pair + 2; counter++) {
+            if (group->descriptors[counter] == -1)
+                continue;
+            sample->values[counter] = (uqword) ((double) read_values.values[member++] / running);
+            sample->valid[counter] = true;
+        }
+    }
+}
+
+#else
+
+bool perf_group_open(perf_group *group) {
+    for (ubyte counter = 0; counter < PERF_COUNTERS; counter++)
+        group->descriptors[counter] = -1;
+    for (ubyte pair = 0; pair < PERF_GROUPS; pair++)
+        group->leaders[pair] = -1;
+    group->count = 0;
+    return false;
+}
+
+void perf_group_close(perf_group *group) {
+    for (ubyte pair = 0; pair < PERF_GROUPS; pair++)
+        group->leaders[pair] = -1;
+    group->count = 0;
+}
+
+void perf_group_begin(perf_group *group) {
+    (void) group;
+}
+
+void perf_group_end(perf_group *group, perf_sample *sample) {
+    (void) group;
+    memset(sample, 0, sizeof(*sample));
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Module: perf
+ * File: perf.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Hardware event counters around a code region, through perf_event_open on Linux. The counters are opened in pairs,
+ * each pair a kernel group scheduled onto the processor together (cycles with instructions, so that their ratio
+ * describes the same instructions), because a group needing more counters than the PMU has free is never scheduled at
+ * all, and a virtual machine may offer as few as two. The kernel multiplexes the pairs when they do not all fit, and
+ * each value is scaled by the time its own pair ran. Counters which cannot be opened (no PMU in a container or virtual
+ * machine, perf_event_paranoid, other platforms) or whose pair never ran are reported as invalid rather than as errors;
+ * a perf_group with no counters at all still begins and ends.
+ */
+
+#ifndef PROJECT_AQUINAS_PERF_H
+#define PROJECT_AQUINAS_PERF_H
+
+#include <stdbool.h>
+#include <platform.h>
+
+enum perf_counter {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_COUNTERS
+};
+
+// kernel groups the counters are opened in
+#define PERF_GROUPS ((PERF_COUNTERS + 1) / 2)
+
+typedef struct perf_group {
+    // file descriptor of each counter, or -1; the first open counter of each pair leads its kernel group
+    int   descriptors[PERF_COUNTERS];
+    int   leaders[PERF_GROUPS];
+    ubyte count;
+} perf_group;
+
+typedef struct perf_sample {
+    uqword values[PERF_COUNTERS];
+    bool   valid[PERF_COUNTERS];
+    // least fraction of the region during which any kernel group was on the processor; each value is scaled up by the
+    // inverse of its own group's fraction
+    double running;
+} perf_sample;
+
+/*
+ * Opens the counters for the calling thread (user space only). Returns false if none of them could be opened.
+ */
+bool perf_group_open(perf_group *group);
+
+void perf_group_close(perf_group *group);
+
+/*
+ * Resets and starts the counters.
+ */
+void perf_group_begin(perf_group *group);
+
+/*
+ * Stops the counters and reads them into `sample`.
+ */
+void perf_group_end(perf_group *group, perf_sample *sample);
+
+char const *perf_counter_name(enum perf_counter counter);
+
+#endif //PROJECT_AQUINAS_PERF_H
@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <limits.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 /*
  * VARIABLES:
@@ -1719,6 +1720,32 @@ void *(*p_get_fn(char *module, char *function))();
  */
 void *(*p_get_fn_offset(char *module, uintptr_t function_offset))();
 
+/*
+ * # `int p_run_process(char *const argv[]);`
+ * Runs the program `argv[0]` (searched for in `PATH`) with the NULL-terminated arguments `argv` and waits for it to exit.
+ *
+ * ## `return int`
+ * The exit status of the program, or -1 if it could not be started or did not exit normally.
+ */
+int p_run_process(char *const argv[]);
+
+/*
+ * # `uqword p_get_peak_resident(void);`
+ * Gets the largest amount of physical memory the process has held at once (peak resident set size) since it started or
+ * since `p_reset_peak_resident`, in bytes; 0 if it is unknown.
+ */
+uqword p_get_peak_resident(void);
+
+/*
+ * # `bool p_reset_peak_resident(void);`
+ * Restarts the peak resident set size from the current resident set size, through /proc/self/clear_refs on Linux.
+ *
+ * ## `return bool`
+ * `false` if the peak cannot be reset (on other platforms, or before Linux 4.0), in which case it keeps growing for the
+ * life of the process.
+ */
+bool p_reset_peak_resident(void);
+
 // currently unused (no implementation)
 int p_get_errno();
 
@@ -1727,12 +1754,37 @@ void p_set_errno(int state);
 
 /*
  * # `uintmax_t p_get_time(enum p_unit unit);`
- * Real-time hardware clock interrupt query.
+ * Monotonic high-resolution clock query.
  *
- * Returns the current real-time clock value stored in a `uintmax_t`.
+ * Returns the time since an arbitrary origin in the given unit. NANOSECONDS and coarser units come from the calibrated
+ * time stamp counter where it is invariant, and from the operating system's monotonic clock otherwise; CYCLES reads the
+ * time stamp counter (nanoseconds on processors without one).
  */
 uintmax_t p_get_time(enum p_time_resolution unit);
 
+/*
+ * Time stamp counter reads ordered against the surrounding instructions, for the start and end of a measured region.
+ * Where there is no time stamp counter both return nanoseconds.
+ */
+uqword p_get_cycles_begin(void);
+
+uqword p_get_cycles_end(void);
+
+/*
+ * Frequency of the time stamp counter in Hz, calibrated on first use against the raw monotonic clock (or taken from
+ * cpuid leaf 0x15 where it reports one). 1000000000 where there is no time stamp counter.
+ */
+uqword p_get_cycle_frequency(void);
+
+/*
+ * Whether the time stamp counter runs at a constant rate in every power state and on every core.
+ */
+bool p_get_cycles_invariant(void);
+
+uqword p_cycles_to_nanoseconds(uqword cycles);
+
+uqword p_nanoseconds_to_cycles(uqword nanoseconds);
+
 /*
  * # `uintmax_t p_get_timestamp();`
  * Gets the current timestamp in the following encoding:
@@ -1749,4 +1801,79 @@ uint64_t p_get_timestamp();
 
 // struct p_device p_get_device();
 
+/*
+ * Cache line size assumed at compile time, for padding which separates data written by different threads. The detected
+ * size is reported by p_get_cpu_topology.
+ */
+#ifndef P_CACHE_LINE_SIZE
+  #define P_CACHE_LINE_SIZE 64
+#endif
+
+// most logical processors p_get_cpu_topology describes; further processors are left out
+#ifndef P_CPU_MAX
+  #define P_CPU_MAX 1024
+#endif
+
+enum p_cache_level {
+    P_CACHE_L1_DATA,
+    P_CACHE_L1_INSTRUCTION,
+    P_CACHE_L2,
+    P_CACHE_L3,
+    P_CACHE_LEVELS
+};
+
+typedef struct p_cache_info {
+    // bytes of one instance of the cache; 0 if there is no such cache or it could not be detected
+    uqword size;
+    udword line_size;
+    // ways; 0 when unknown or fully associative
+    udword associativity;
+    // logical processors which share one instance; 0 when unknown
+    udword shared_by;
+} p_cache_info;
+
+typedef struct p_cpu_topology {
+    // logical processors online (hardware threads)
+    udword       logical_cores;
+    udword       physical_cores;
+    // physical cores with a logical processor this process may run on
+    udword       allowed_cores;
+    udword       packages;
+    // smallest data cache line size; P_CACHE_LINE_SIZE when unknown
+    udword       line_size;
+    p_cache_info caches[P_CACHE_LEVELS];
+    // operating system number of every logical processor, ascending; there may be gaps between them
+    uword        number[P_CPU_MAX];
+    // physical core (numbered from 0 in order of appearance) of every logical processor
+    uword        core_of[P_CPU_MAX];
+    // processor brand string; empty when unknown
+    char         name[49];
+} p_cpu_topology;
+
+/*
+ * Returns the processor topology and cache geometry of the machine, detected on the first call (from sysfs and
+ * sysconf on Linux, GetLogicalProcessorInformation on Windows, and cpuid leaf 4 or 0x8000001D on x86_64 for anything
+ * those leave out). Values which cannot be detected fall back to one package of one core per logical processor and to
+ * zero-sized caches.
+ */
+p_cpu_topology const *p_get_cpu_topology(void);
+
+/*
+ * Writes the logical processors which share a physical core with `cpu` (including `cpu`) to `siblings`, up to
+ * `capacity` of them, and returns how many there are.
+ */
+udword p_get_cpu_siblings(udword cpu, udword *siblings, udword capacity);
+
+/*
+ * Sizes derived from the topology for tuning data structures and thread pools at startup.
+ */
+typedef struct p_tuning {
+    // alignment and padding of data written by different threads
+    udword line_size;
+    // worker threads: one per physical core the process may run on
+    udword workers;
+} p_tuning;
+
+p_tuning const *p_get_tuning(void);
+
 #endif /* PROJECT_AQUINAS_INCLUDE_P_H */
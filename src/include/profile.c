@@ -0,0 +1,261 @@
+/*
+ * Module: profile
+ * File: profile.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+// tested before any header is included, so PLATFORM (from platform.h) is not defined yet
+#if defined(__linux__) || defined(__unix__)
+  // REG_RIP, dladdr and pthread_getattr_np
+  #define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "state.h"
+#include "profile.h"
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+
+#include <errno.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+typedef struct profile_sample {
+    // outermost first; unused entries are NULL, so that equal stacks compare equal byte for byte
+    char const *contexts[PROFILE_CONTEXTS];
+    // innermost first: the interrupted instruction, then return addresses
+    void       *frames[PROFILE_FRAMES];
+} profile_sample;
+
+static profile_sample *profile_samples;
+static atomic_bool     profile_running;
+// slots claimed by handlers, which may exceed PROFILE_SAMPLES, and samples fully written
+static _Atomic uqword  profile_claimed, profile_completed;
+static bool            profile_installed;
+
+// highest address of the calling thread's stack, or 0 while profile_thread has not run on it
+static _Thread_local uintptr_t profile_stack_high;
+
+void profile_thread(void) {
+    pthread_attr_t attributes;
+    void          *low;
+    size_t         size;
+    if (pthread_getattr_np(pthread_self(), &attributes) != 0)
+        return;
+    if (pthread_attr_getstack(&attributes, &low, &size) == 0)
+        profile_stack_high = (uintptr_t) low + size;
+    pthread_attr_destroy(&attributes);
+}
+
+static void profile_registers(ucontext_t const *context, uintptr_t *ip, uintptr_t *fp, uintptr_t *sp) {
+#if ARCH == ARCH_X86_64
+    *ip = (uintptr_t) context->uc_mcontext.gregs[REG_RIP];
+    *fp = (uintptr_t) context->uc_mcontext.gregs[REG_RBP];
+    *sp = (uintptr_t) context->uc_mcontext.gregs[REG_RSP];
+#elif ARCH == ARCH_ARM64
+    *ip = (uintptr_t) context->uc_mcontext.pc;
+    *fp = (uintptr_t) context->uc_mcontext.regs[29];
+    *sp = (uintptr_t) context->uc_mcontext.sp;
+#else
+    (void) context;
+    *ip = *fp = *sp = 0;
+#endif
+}
+
+/*
+ * Async-signal-safe: touches nothing but the claimed slot, the atomics and the interrupted thread's own stack.
+ */
+static void profile_signal(int signal, siginfo_t *info, void *context) {
+    (void) signal;
+    (void) info;
+    if (!atomic_load_explicit(&profile_running, memory_order_relaxed))
+        return;
+    uqword const index = atomic_fetch_add_explicit(&profile_claimed, 1, memory_order_relaxed);
+    if (index >= PROFILE_SAMPLES)
+        return;
+    int const       error = errno;
+    profile_sample *sample = &profile_samples[index];
+
+    uqword const depth = get_context_depth() + 1;
+    uqword const skip = depth > PROFILE_CONTEXTS ? depth - PROFILE_CONTEXTS : 0;
+    for (uqword i = skip; i < depth; i++)
+        sample->contexts[i - skip] = _global_context_stack[i];
+
+    uintptr_t ip, fp, sp;
+    profile_registers(context, &ip, &fp, &sp);
+    sample->frames[0] = (void *) ip;
+    // each frame holds the caller's frame pointer and the return address, and lies above the one it called
+    uintptr_t const high = profile_stack_high;
+    for (udword i = 1; i < PROFILE_FRAMES && high != 0 && fp >= sp && fp <= high - 2 * sizeof(uintptr_t) &&
+                       (fp & (sizeof(uintptr_t) - 1)) == 0; i++) {
+        uintptr_t const *frame = (uintptr_t const *) fp;
+        if (frame[1] == 0)
+            break;
+        sample->frames[i] = (void *) frame[1];
+        if (frame[0] <= fp)
+            break;
+        fp = frame[0];
+    }
+
+    atomic_fetch_add_explicit(&profile_completed, 1, memory_order_release);
+    errno = error;
+}
+
+static bool profile_timer(udword frequency) {
+    struct itimerval timer = {0};
+    if (frequency != 0) {
+        uqword const microseconds = 1000000u / frequency != 0 ? 1000000u / frequency : 1;
+        timer.it_interval.tv_sec = (time_t) (microseconds / 1000000u);
+        timer.it_interval.tv_usec = (suseconds_t) (microseconds % 1000000u);
+        timer.it_value = timer.it_interval;
+    }
+    return setitimer(ITIMER_PROF, &timer, NULL) == 0;
+}
+
+bool profile_start(udword frequency) {
+    if (profile_samples == NULL) {
+        profile_samples = calloc(PROFILE_SAMPLES, sizeof(profile_sample));
+        if (profile_samples == NULL) {
+            warnf(__func__, "unable to allocate %u profile samples\n", PROFILE_SAMPLES);
+            return false;
+        }
+    }
+    // the handler stays installed after profile_stop, so that a signal still pending then is harmless
+    if (!profile_installed) {
+        struct sigaction action = {.sa_sigaction = profile_signal, .sa_flags = SA_SIGINFO | SA_RESTART};
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, NULL) != 0) {
+            warnf(__func__, "unable to handle SIGPROF: %s\n", strerror(errno));
+            return false;
+        }
+        profile_installed = true;
+    }
+    profile_thread();
+
+    atomic_store(&profile_running, true);
+    if (!profile_timer(frequency != 0 ? frequency : PROFILE_DEFAULT_FREQUENCY)) {
+        atomic_store(&profile_running, false);
+        warnf(__func__, "unable to set the profiling timer: %s\n", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void profile_stop(void) {
+    profile_timer(0);
+    atomic_store(&profile_running, false);
+}
+
+void profile_reset(void) {
+    if (profile_samples != NULL)
+        memset(profile_samples, 0, PROFILE_SAMPLES * sizeof(profile_sample));
+    atomic_store(&profile_claimed, 0);
+    atomic_store(&profile_completed, 0);
+}
+
+static int profile_compare(void const *a, void const *b) {
+    return memcmp(a, b, sizeof(profile_sample));
+}
+
+/*
+ * Writes a frame name, after a separator unless it is the first of its stack, with the separators of the folded format
+ * replaced.
+ */
+static void profile_frame(FILE *file, char const *name, bool *first) {
+    if (!*first)
+        fputc(';', file);
+    *first = false;
+    for (; *name != '\0'; name++)
+        fputc(*name == ';' || *name == ' ' || *name == '\n' ? '_' : *name, file);
+}
+
+static void profile_address(FILE *file, void *address, bool *first) {
+    char    name[256];
+    Dl_info info = {0};
+    if (dladdr(address, &info) != 0 && info.dli_sname != NULL) {
+        snprintf(name, sizeof(name), "%s", info.dli_sname);
+    } else if (info.dli_fname != NULL) {
+        char const *module = strrchr(info.dli_fname, '/');
+        snprintf(name, sizeof(name), "%s+0x%llx", module != NULL ? module + 1 : info.dli_fname,
+                 (unsigned long long) ((uintptr_t) address - (uintptr_t) info.dli_fbase));
+    } else {
+        snprintf(name, sizeof(name), "0x%llx", (unsigned long long) (uintptr_t) address);
+    }
+    profile_frame(file, name, first);
+}
+
+bool profile_write(char const *path) {
+    uqword const claimed = atomic_load(&profile_claimed);
+    uqword const count = claimed < PROFILE_SAMPLES ? claimed : PROFILE_SAMPLES;
+    // a handler which claimed its slot before profile_stop may still be writing it
+    while (atomic_load_explicit(&profile_completed, memory_order_acquire) < count)
+        sched_yield();
+    if (claimed > count)
+        warnf(__func__, "dropped %llu samples beyond the %u the buffer holds\n", (unsigned long long) (claimed - count),
+              PROFILE_SAMPLES);
+
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+        return false;
+
+    // equal stacks end up next to one another
+    qsort(profile_samples, count, sizeof(profile_sample), profile_compare);
+    for (uqword i = 0, run; i < count; i += run) {
+        for (run = 1; i + run < count && profile_compare(&profile_samples[i], &profile_samples[i + run]) == 0; run++)
+            continue;
+
+        profile_sample const *sample = &profile_samples[i];
+        bool                  first = true;
+        for (udword j = 0; j < PROFILE_CONTEXTS && sample->contexts[j] != NULL; j++)
+            profile_frame(file, sample->contexts[j], &first);
+        udword frames = 0;
+        while (frames < PROFILE_FRAMES && sample->frames[frames] != NULL)
+            frames++;
+        // a return address follows the call, which may be the last instruction of its function
+        for (udword j = frames; j > 1; j--)
+            profile_address(file, (ubyte *) sample->frames[j - 1] - 1, &first);
+        if (frames != 0)
+            profile_address(file, sample->frames[0], &first);
+        fprintf(file, " %llu\n", (unsigned long long) run);
+    }
+
+    bool const written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
+
+#else
+
+void profile_thread(void) {
+}
+
+bool profile_start(udword frequency) {
+    (void) frequency;
+    warnf(__func__, "sampling is not supported on this platform\n");
+    return false;
+}
+
+void profile_stop(void) {
+}
+
+void profile_reset(void) {
+}
+
+bool profile_write(char const *path) {
+    FILE *file = fopen(path, "w");
+    return file != NULL && fclose(file) == 0;
+}
+
+#endif
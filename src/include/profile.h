@@ -0,0 +1,71 @@
+/*
+ * Module: profile
+ * File: profile.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * In-process sampling profiler for runs where no external profiler is at hand. While profiling, an ITIMER_PROF timer
+ * raises SIGPROF `frequency` times per second of CPU time used by the process; the signal handler records the
+ * interrupted instruction pointer, the return addresses found by following frame pointers, and the context stack of the
+ * interrupted thread into a preallocated buffer, claiming its slot with one atomic increment. profile_write aggregates
+ * the samples into folded stacks, one "frame;frame;... samples" line per distinct stack, for flamegraph.pl, speedscope
+ * or inferno.
+ *
+ * Frame pointers are only followed on threads which called profile_thread (profile_start registers its caller), since
+ * the handler needs the bounds of the stack to walk it safely; elsewhere a sample holds the interrupted function alone.
+ * Stacks are only as complete as the frame pointers: the build keeps them with -fno-omit-frame-pointer, but libraries
+ * built without them break the chain.
+ *
+ * Profiling needs POSIX signals; elsewhere profile_start returns false.
+ */
+
+#ifndef PROJECT_AQUINAS_PROFILE_H
+#define PROJECT_AQUINAS_PROFILE_H
+
+#include <stdbool.h>
+#include <platform.h>
+
+// samples the buffer holds; samples beyond them are counted and dropped
+#ifndef PROFILE_SAMPLES
+  #define PROFILE_SAMPLES 65536
+#endif
+
+// addresses and innermost contexts kept per sample
+#define PROFILE_FRAMES 32
+#define PROFILE_CONTEXTS 8
+
+// samples per second of CPU time; prime so that the timer does not run in step with periodic work. The kernel's timer
+// tick bounds the rate actually reached.
+#define PROFILE_DEFAULT_FREQUENCY 997
+
+/*
+ * Starts sampling `frequency` times per second of CPU time. Returns false if profiling is unsupported or the timer
+ * cannot be set.
+ */
+bool profile_start(udword frequency);
+
+void profile_stop(void);
+
+/*
+ * Discards the samples recorded so far. Must not run while profiling.
+ */
+void profile_reset(void);
+
+/*
+ * Lets samples of the calling thread follow its frame pointers. Threads call this once, before they do work worth
+ * profiling.
+ */
+void profile_thread(void);
+
+/*
+ * Writes the samples as folded stacks weighted by sample count. Must not run while profiling. Returns false if the file
+ * cannot be written.
+ */
+bool profile_write(char const *path);
+
+#endif //PROJECT_AQUINAS_PROFILE_H
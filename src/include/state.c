@@ -9,55 +9,61 @@
  */
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include "state.h"
+#include "logger.h"
 
 
+_Thread_local uqword _global_state;
+_Thread_local char  *_global_context_stack[R_CONTEXT_DEPTH] = {"global"};
+_Thread_local uqword _global_context_depth;
+
+static _Atomic uqword _global_warnings;
+
 static char *aqu_result_messages[] =
         {
                 [R_SUCCESS] = "SUCCESS",
                 [R_FAILURE] = "FAILURE",
         };
 
+void debugf(char const *restrict fn_name, char const *information, ...) {
+    va_list objects;
+    va_start(objects, information);
+    log_submit(LOG_LEVEL_DEBUG, fn_name, get_context(), information, objects);
+    va_end(objects);
+}
+
 void info(char const *restrict fn_name, char const *information, ...) {
-    fputs("[info]", stdout);
-    fputc('[', stdout);
-    fputs(_global_context, stdout);
-    fputs("][", stdout);
-    fputs(fn_name, stdout);
-    fputs("] ", stdout);
     va_list objects;
     va_start(objects, information);
-    vprintf(information, objects);
+    log_submit(LOG_LEVEL_INFO, fn_name, get_context(), information, objects);
     va_end(objects);
 }
 
 void infof(char const *restrict fn_name, char const *information, ...) {
-    fputs("[info][", stdout);
-    fputs(_global_context, stdout);
-    fputs("][", stdout);
-    fputs(fn_name, stdout);
-    fputs("] ", stdout);
     va_list objects;
     va_start(objects, information);
-    vprintf(information, objects);
+    log_submit(LOG_LEVEL_INFO, fn_name, get_context(), information, objects);
     va_end(objects);
 }
 
 void warnf(char const *restrict fn_name, char const *warning, ...) {
-    fputs("[warning][", stdout);
-    fputs(_global_context, stdout);
-    fputs("][", stdout);
-    fputs(fn_name, stdout);
-    fputs("] ", stdout);
+    atomic_fetch_add_explicit(&_global_warnings, 1, memory_order_relaxed);
     va_list objects;
     va_start(objects, warning);
-    vprintf(warning, objects);
+    log_submit(LOG_LEVEL_WARNING, fn_name, get_context(), warning, objects);
     va_end(objects);
 }
 
+uqword get_warning_count(void) {
+    return atomic_load_explicit(&_global_warnings, memory_order_relaxed);
+}
+
 void fatalf(char const *restrict fn_name, char const *error_message, ...) {
+    // everything logged before the error comes out first
+    log_flush();
     fputs("[fatal][", stderr);
-    fputs(_global_context, stderr);
+    fputs(get_context(), stderr);
     fputs("][", stderr);
     fputs(fn_name, stderr);
     fputs("] ", stderr);
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <platform.h>
+#include "trace.h"
 
 // a macro to be used by programs to determine whether or not the build is debug (default: false
 #ifndef R_DEBUG
@@ -22,16 +23,92 @@
 #define R_DEBUG_LOGGING false
 #endif
 
+// levels of R_LOG_LEVEL; the r_* macros below it compile to nothing
+#define R_LOG_DEBUG   0
+#define R_LOG_INFO    1
+#define R_LOG_WARNING 2
+#define R_LOG_NONE    3
+
+// the least level which is logged (default: R_LOG_DEBUG in debug builds, R_LOG_INFO otherwise)
+#ifndef R_LOG_LEVEL
+  #if R_DEBUG || R_DEBUG_LOGGING
+    #define R_LOG_LEVEL R_LOG_DEBUG
+  #else
+    #define R_LOG_LEVEL R_LOG_INFO
+  #endif
+#endif
+
 enum result_code {
     // R for Result
     R_SUCCESS = EXIT_SUCCESS,
     R_FAILURE = EXIT_FAILURE
 };
 
-static uqword _global_state;
+/*
+ * Most contexts one thread may have entered at once, including the "global" context at the bottom of its stack.
+ */
+#ifndef R_CONTEXT_DEPTH
+#define R_CONTEXT_DEPTH 64
+#endif
+
+// every thread has its own state and its own stack of contexts; _global_context_stack[0] is always "global"
+extern _Thread_local uqword _global_state;
+extern _Thread_local char *_global_context_stack[R_CONTEXT_DEPTH];
+extern _Thread_local uqword _global_context_depth;
+
+void debugf(char const *restrict fn_name, char const *restrict information, ...);
+
+void info(char const *restrict fn_name, char const *information, ...);
+
+void infof(char const *restrict fn_name, char const *restrict information, ...);
+
+void warnf(char const *restrict fn_name, char const *restrict warning, ...);
+
+/*
+ * Number of warnings logged so far by every thread.
+ */
+uqword get_warning_count(void);
+
+__attribute__((noreturn))
+void fatalf(char const *restrict fn_name, char const *restrict error_message, ...);
+
+/*
+ * Leveled logging from the calling function: r_debug(format, ...), r_info(format, ...) and r_warn(format, ...).
+ * Below R_LOG_LEVEL a call compiles to nothing and its arguments are not evaluated.
+ *
+ * The _every variants log the first of every `period` calls made by a thread at that call site, for hot loops.
+ */
+#define r_log_disabled(...) do { if (false) infof(__func__, __VA_ARGS__); } while (false)
+
+#define r_log_every(log, period, ...) do { \
+        static _Thread_local uqword r_log_calls; \
+        if (r_log_calls++ % (period) == 0) \
+            log(__func__, __VA_ARGS__); \
+    } while (false)
+
+#if R_LOG_LEVEL <= R_LOG_DEBUG
+  #define r_debug(...) debugf(__func__, __VA_ARGS__)
+  #define r_debug_every(period, ...) r_log_every(debugf, period, __VA_ARGS__)
+#else
+  #define r_debug(...) r_log_disabled(__VA_ARGS__)
+  #define r_debug_every(period, ...) r_log_disabled(__VA_ARGS__)
+#endif
+
+#if R_LOG_LEVEL <= R_LOG_INFO
+  #define r_info(...) infof(__func__, __VA_ARGS__)
+  #define r_info_every(period, ...) r_log_every(infof, period, __VA_ARGS__)
+#else
+  #define r_info(...) r_log_disabled(__VA_ARGS__)
+  #define r_info_every(period, ...) r_log_disabled(__VA_ARGS__)
+#endif
 
-static char *restrict _global_previous_context = "global";
-static char *restrict _global_context = "global";
+#if R_LOG_LEVEL <= R_LOG_WARNING
+  #define r_warn(...) warnf(__func__, __VA_ARGS__)
+  #define r_warn_every(period, ...) r_log_every(warnf, period, __VA_ARGS__)
+#else
+  #define r_warn(...) r_log_disabled(__VA_ARGS__)
+  #define r_warn_every(period, ...) r_log_disabled(__VA_ARGS__)
+#endif
 
 static inline void set_state(uqword state) {
     _global_state = state;
@@ -41,30 +118,47 @@ static inline uqword get_state() {
     return _global_state;
 }
 
-static inline void set_context(char *context) {
-    _global_previous_context = _global_context;
-    _global_context = context;
+/*
+ * Enters a context on the calling thread; while tracing, each context is a slice on the thread's timeline.
+ */
+static inline void push_context(char *context) {
+    if (__builtin_expect(_global_context_depth == R_CONTEXT_DEPTH - 1, false))
+        fatalf(__func__, "more than %d nested contexts\n", R_CONTEXT_DEPTH - 1);
+    _global_context_stack[++_global_context_depth] = context;
+    trace_begin(context);
+}
+
+/*
+ * Leaves the innermost context of the calling thread.
+ */
+static inline void pop_context() {
+    if (__builtin_expect(_global_context_depth == 0, false))
+        fatalf(__func__, "no context to leave\n");
+    _global_context_depth--;
+    trace_end();
 }
 
 static inline char *get_context() {
-    return _global_context;
+    return _global_context_stack[_global_context_depth];
 }
 
 static inline char *get_previous_context() {
-    return _global_previous_context;
+    return _global_context_stack[_global_context_depth - (_global_context_depth != 0)];
 }
 
-static inline void clear_context() {
-    _global_context = _global_previous_context;
+/*
+ * Number of contexts entered and not yet left by the calling thread.
+ */
+static inline uqword get_context_depth() {
+    return _global_context_depth;
 }
 
-void info(char const *restrict fn_name, char const *information, ...);
-
-void infof(char const *restrict fn_name, char const *restrict information, ...);
-
-void warnf(char const *restrict fn_name, char const *restrict warning, ...);
+static inline void set_context(char *context) {
+    push_context(context);
+}
 
-__attribute__((noreturn))
-void fatalf(char const *restrict fn_name, char const *restrict error_message, ...);
+static inline void clear_context() {
+    pop_context();
+}
 
 #endif /* PROJECT_AQUINAS_DEBUG_H */
@@ -0,0 +1,395 @@
+/*
+ * Module: task
+ * File: task.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include "state.h"
+#include "trace.h"
+#include "profile.h"
+#include "task.h"
+
+// rounds without finding a task before an idle worker sleeps
+#define TASK_IDLE_ROUNDS 64
+
+typedef struct task {
+    task_function function;
+    void         *argument;
+    task_group   *group;
+    // next task of the shared queue
+    struct task  *next;
+} task;
+
+typedef struct task_array {
+    qword              capacity;
+    // the array this one replaced; thieves may still be reading it, so it is freed with the pool
+    struct task_array *previous;
+    _Atomic(task *)    tasks[];
+} task_array;
+
+/*
+ * Chase–Lev deque, with the C11 orderings of Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing
+ * for Weak Memory Models" (2013). The owner pushes and takes at the bottom; thieves steal at the top.
+ */
+typedef struct task_deque {
+    // advanced by thieves and by the owner taking the last task
+    _Atomic qword          top;
+    char                   top_padding[P_CACHE_LINE_SIZE - sizeof(qword)];
+    // written by the owner only
+    _Atomic qword          bottom;
+    _Atomic(task_array *)  array;
+    char                   bottom_padding[P_CACHE_LINE_SIZE - sizeof(qword) - sizeof(void *)];
+} task_deque;
+
+typedef struct task_worker {
+    task_deque deque;
+    pthread_t  thread;
+    uqword     random;
+} task_worker;
+
+static task_worker    *task_pool;
+static udword          task_count;
+static atomic_bool     task_running, task_stopping;
+static pthread_mutex_t task_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  task_wake = PTHREAD_COND_INITIALIZER;
+static _Atomic udword  task_sleepers;
+
+// tasks spawned by threads outside the pool, oldest first; guarded by task_lock
+static task          *task_shared_head, *task_shared_tail;
+static _Atomic uqword task_shared_count;
+
+// the worker running on this thread, or NULL outside the pool
+static _Thread_local task_worker *task_self;
+static _Thread_local uqword       task_random;
+
+/* DEQUE */
+
+static task_array *task_new_array(qword capacity) {
+    task_array *array = malloc(sizeof(task_array) + (uqword) capacity * sizeof(_Atomic(task *)));
+    if (array == NULL)
+        fatalf(__func__, "unable to allocate a deque of %lld tasks\n", (long long) capacity);
+    array->capacity = capacity;
+    array->previous = NULL;
+    return array;
+}
+
+static task_array *task_grow(task_deque *deque, task_array *array, qword top, qword bottom) {
+    task_array *grown = task_new_array(array->capacity * 2);
+    for (qword i = top; i < bottom; i++)
+        atomic_store_explicit(&grown->tasks[i & (grown->capacity - 1)],
+                              atomic_load_explicit(&array->tasks[i & (array->capacity - 1)], memory_order_relaxed),
+                              memory_order_relaxed);
+    grown->previous = array;
+    atomic_store_explicit(&deque->array, grown, memory_order_release);
+    return grown;
+}
+
+static void task_push(task_deque *deque, task *pushed) {
+    qword const bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    qword const top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    task_array *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    if (bottom - top > array->capacity - 1)
+        array = task_grow(deque, array, top, bottom);
+    // releases the task's fields to the thief which acquires the slot
+    atomic_store_explicit(&array->tasks[bottom & (array->capacity - 1)], pushed, memory_order_release);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+}
+
+static task *task_take(task_deque *deque) {
+    qword const bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    task_array *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    qword top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    task *taken = NULL;
+    if (top <= bottom) {
+        taken = atomic_load_explicit(&array->tasks[bottom & (array->capacity - 1)], memory_order_relaxed);
+        if (top != bottom)
+            return taken;
+        // the last task: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                     memory_order_relaxed))
+            taken = NULL;
+    }
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return taken;
+}
+
+static task *task_steal(task_deque *deque) {
+    qword top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    qword const bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom)
+        return NULL;
+
+    task_array *array = atomic_load_explicit(&deque->array, memory_order_acquire);
+    task       *stolen = atomic_load_explicit(&array->tasks[top & (array->capacity - 1)], memory_order_acquire);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                 memory_order_relaxed))
+        return NULL;
+    return stolen;
+}
+
+/* SCHEDULING */
+
+/*
+ * xorshift64 for picking victims; the state is never zero.
+ */
+static uqword task_next_random(uqword *state) {
+    if (*state == 0)
+        *state = (uqword) (uintptr_t) state | 1u;
+    *state ^= *state << 13u;
+    *state ^= *state >> 7u;
+    *state ^= *state << 17u;
+    return *state;
+}
+
+static task *task_unshare(void) {
+    if (atomic_load_explicit(&task_shared_count, memory_order_acquire) == 0)
+        return NULL;
+    pthread_mutex_lock(&task_lock);
+    task *shared = task_shared_head;
+    if (shared != NULL) {
+        task_shared_head = shared->next;
+        if (task_shared_head == NULL)
+            task_shared_tail = NULL;
+        atomic_fetch_sub_explicit(&task_shared_count, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&task_lock);
+    return shared;
+}
+
+/*
+ * Finds a task for the calling thread: its own newest, then the oldest shared one, then one stolen from every worker in
+ * turn from a random start.
+ */
+static task *task_find(void) {
+    task *found;
+    if (task_self != NULL && (found = task_take(&task_self->deque)) != NULL)
+        return found;
+    if ((found = task_unshare()) != NULL)
+        return found;
+
+    uqword *random = task_self != NULL ? &task_self->random : &task_random;
+    udword const start = (udword) (task_next_random(random) % task_count);
+    for (udword i = 0; i < task_count; i++) {
+        task_worker *victim = &task_pool[(start + i) % task_count];
+        if (victim != task_self && (found = task_steal(&victim->deque)) != NULL)
+            return found;
+    }
+    return NULL;
+}
+
+static bool task_available(void) {
+    if (atomic_load(&task_shared_count) != 0)
+        return true;
+    for (udword i = 0; i < task_count; i++)
+        if (atomic_load(&task_pool[i].deque.top) < atomic_load(&task_pool[i].deque.bottom))
+            return true;
+    return false;
+}
+
+static void task_run(task *running) {
+    task_group *group = running->group;
+    running->function(running->argument);
+    free(running);
+    atomic_fetch_sub_explicit(&group->pending, 1, memory_order_acq_rel);
+}
+
+/*
+ * Wakes a sleeping worker. The fence orders the publication of the task before the load of the sleepers, against a
+ * worker which counts itself a sleeper before checking for tasks one last time, so that one of the two sees the other.
+ */
+static void task_notify(void) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&task_sleepers, memory_order_relaxed) == 0)
+        return;
+    pthread_mutex_lock(&task_lock);
+    pthread_cond_signal(&task_wake);
+    pthread_mutex_unlock(&task_lock);
+}
+
+static void task_sleep(void) {
+    pthread_mutex_lock(&task_lock);
+    atomic_fetch_add(&task_sleepers, 1);
+    if (!task_available() && !atomic_load(&task_stopping))
+        pthread_cond_wait(&task_wake, &task_lock);
+    atomic_fetch_sub(&task_sleepers, 1);
+    pthread_mutex_unlock(&task_lock);
+}
+
+static void *task_work(void *argument) {
+    task_self = argument;
+    profile_thread();
+    trace_thread_name("task worker");
+
+    udword idle = 0;
+    for (;;) {
+        task *found = task_find();
+        if (found != NULL) {
+            task_run(found);
+            idle = 0;
+        } else if (atomic_load_explicit(&task_stopping, memory_order_acquire)) {
+            return NULL;
+        } else if (++idle < TASK_IDLE_ROUNDS) {
+            sched_yield();
+        } else {
+            task_sleep();
+            idle = 0;
+        }
+    }
+}
+
+/* POOL */
+
+void task_start(udword workers) {
+    pthread_mutex_lock(&task_lock);
+    if (atomic_load(&task_running)) {
+        pthread_mutex_unlock(&task_lock);
+        return;
+    }
+
+    task_count = workers != 0 ? workers : p_get_tuning()->workers;
+    if (task_count == 0)
+        task_count = 1;
+    task_pool = calloc(task_count, sizeof(task_worker));
+    if (task_pool == NULL)
+        fatalf(__func__, "unable to allocate %u workers\n", task_count);
+    for (udword i = 0; i < task_count; i++) {
+        atomic_init(&task_pool[i].deque.array, task_new_array(TASK_DEQUE_CAPACITY));
+        task_pool[i].random = (uqword) i * 0x9E3779B97F4A7C15u | 1u;
+    }
+
+    atomic_store(&task_stopping, false);
+    for (udword i = 0; i < task_count; i++)
+        if (pthread_create(&task_pool[i].thread, NULL, task_work, &task_pool[i]) != 0)
+            fatalf(__func__, "unable to start worker %u of %u\n", i, task_count);
+    atomic_store(&task_running, true);
+    pthread_mutex_unlock(&task_lock);
+}
+
+void task_stop(void) {
+    if (!atomic_load(&task_running))
+        return;
+
+    pthread_mutex_lock(&task_lock);
+    atomic_store(&task_stopping, true);
+    pthread_cond_broadcast(&task_wake);
+    pthread_mutex_unlock(&task_lock);
+    for (udword i = 0; i < task_count; i++)
+        pthread_join(task_pool[i].thread, NULL);
+
+    for (udword i = 0; i < task_count; i++) {
+        task_array *array = atomic_load(&task_pool[i].deque.array);
+        while (array != NULL) {
+            task_array *previous = array->previous;
+            free(array);
+            array = previous;
+        }
+    }
+    free(task_pool);
+    task_pool = NULL;
+    task_count = 0;
+    atomic_store(&task_running, false);
+}
+
+udword task_workers(void) {
+    if (!atomic_load_explicit(&task_running, memory_order_acquire))
+        task_start(0);
+    return task_count;
+}
+
+void task_spawn(task_group *group, task_function function, void *argument) {
+    if (!atomic_load_explicit(&task_running, memory_order_acquire))
+        task_start(0);
+
+    task *spawned = malloc(sizeof(task));
+    if (spawned == NULL)
+        fatalf(__func__, "unable to allocate a task\n");
+    *spawned = (task) {.function = function, .argument = argument, .group = group};
+    atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+
+    if (task_self != NULL) {
+        task_push(&task_self->deque, spawned);
+    } else {
+        pthread_mutex_lock(&task_lock);
+        if (task_shared_tail != NULL)
+            task_shared_tail->next = spawned;
+        else
+            task_shared_head = spawned;
+        task_shared_tail = spawned;
+        atomic_fetch_add_explicit(&task_shared_count, 1, memory_order_release);
+        pthread_mutex_unlock(&task_lock);
+    }
+    task_notify();
+}
+
+void task_sync(task_group *group) {
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) != 0) {
+        task *found = task_find();
+        if (found != NULL)
+            task_run(found);
+        else
+            sched_yield();
+    }
+}
+
+/* PARALLEL FOR */
+
+typedef struct task_range {
+    uqword      begin;
+    uqword      end;
+    uqword      grain;
+    void      (*body)(uqword from, uqword to, void *argument);
+    void       *argument;
+    task_group *group;
+} task_range;
+
+/*
+ * Spawns the upper half of the range until at most a grain is left, and runs that; thieves take the largest halves.
+ */
+static void task_split(void *argument) {
+    task_range *range = argument;
+    while (range->end - range->begin > range->grain) {
+        uqword const middle = range->begin + (range->end - range->begin) / 2;
+        task_range  *upper = malloc(sizeof(task_range));
+        if (upper == NULL)
+            fatalf(__func__, "unable to allocate a range\n");
+        *upper = *range;
+        upper->begin = middle;
+        range->end = middle;
+        task_spawn(range->group, task_split, upper);
+    }
+    range->body(range->begin, range->end, range->argument);
+    free(range);
+}
+
+void task_parallel_for(uqword begin, uqword end, uqword grain, void (*body)(uqword from, uqword to, void *argument),
+                       void *argument) {
+    if (begin >= end)
+        return;
+    if (grain == 0) {
+        grain = (end - begin) / ((uqword) task_workers() * 8u);
+        if (grain == 0)
+            grain = 1;
+    }
+
+    task_group  group = TASK_GROUP_INIT;
+    task_range *range = malloc(sizeof(task_range));
+    if (range == NULL)
+        fatalf(__func__, "unable to allocate a range\n");
+    *range = (task_range) {begin, end, grain, body, argument, &group};
+    task_split(range);
+    task_sync(&group);
+}
@@ -0,0 +1,82 @@
+/*
+ * Module: task
+ * File: task.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * The task runtime: one pool of worker threads, shared by everything in the process which runs work in parallel, so
+ * that no module spawns threads of its own. Work is expressed as fork-join tasks: task_spawn adds a task to a group and
+ * task_sync waits for the group, running tasks itself meanwhile; task_parallel_for splits a range recursively into
+ * tasks of at most `grain` iterations.
+ *
+ * Every worker owns a Chase–Lev deque: it pushes and pops tasks at the bottom in LIFO order, which keeps a subtree of
+ * tasks on the core whose caches hold its data, while idle workers steal the oldest (and typically largest) task from
+ * the top of a victim picked at random. Threads outside the pool spawn into a shared queue and help by stealing while
+ * they sync. Workers with nothing to steal spin briefly and then sleep until a task is spawned.
+ *
+ * The pool starts on first use with one worker per physical core the process may run on (see p_get_tuning), or with
+ * the count given to task_start beforehand.
+ */
+
+#ifndef PROJECT_AQUINAS_TASK_H
+#define PROJECT_AQUINAS_TASK_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <platform.h>
+
+// tasks a deque holds before it first grows; a power of two
+#ifndef TASK_DEQUE_CAPACITY
+  #define TASK_DEQUE_CAPACITY 256
+#endif
+
+typedef void (*task_function)(void *argument);
+
+/*
+ * Tasks spawned and not yet finished; initialize with TASK_GROUP_INIT. A group is synced by the thread which spawns into
+ * it, and must outlive its tasks.
+ */
+typedef struct task_group {
+    _Atomic uqword pending;
+} task_group;
+
+#define TASK_GROUP_INIT {0}
+
+/*
+ * Starts the pool with `workers` threads, or one per physical core if 0. Does nothing if the pool is running.
+ */
+void task_start(udword workers);
+
+/*
+ * Waits for the workers to finish the tasks they hold and stops them. Tasks must not be spawned concurrently.
+ */
+void task_stop(void);
+
+/*
+ * Returns the number of workers, starting the pool if it is not running.
+ */
+udword task_workers(void);
+
+/*
+ * Runs function(argument) on some thread of the pool as part of `group`.
+ */
+void task_spawn(task_group *group, task_function function, void *argument);
+
+/*
+ * Returns once every task of `group`, and every task they spawned into it, has finished; runs other tasks meanwhile.
+ */
+void task_sync(task_group *group);
+
+/*
+ * Calls body(from, to, argument) over subranges of [begin, end) of at most `grain` iterations, in parallel, and returns
+ * once all have finished. A grain of 0 picks one giving every worker about eight subranges.
+ */
+void task_parallel_for(uqword begin, uqword end, uqword grain, void (*body)(uqword from, uqword to, void *argument),
+                       void *argument);
+
+#endif //PROJECT_AQUINAS_TASK_H
@@ -0,0 +1,239 @@
+/*
+ * Module: trace
+ * File: trace.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Each thread appends to a list of blocks which only it writes; a block's count is published with release order, so
+ * trace_write can read every event below it while the thread keeps appending. Buffers outlive their threads so that
+ * the events of finished workers are still exported.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "state.h"
+#include "trace.h"
+
+enum trace_phase {
+    TRACE_PHASE_BEGIN   = 'B',
+    TRACE_PHASE_END     = 'E',
+    TRACE_PHASE_INSTANT = 'i',
+    TRACE_PHASE_COUNTER = 'C'
+};
+
+typedef struct trace_event {
+    // nanoseconds since trace_origin
+    uqword           time;
+    char const      *name;
+    // the innermost context of the recording thread, exported as the category
+    char const      *context;
+    qword            value;
+    enum trace_phase phase;
+} trace_event;
+
+typedef struct trace_block {
+    _Atomic udword               count;
+    _Atomic(struct trace_block *) next;
+    trace_event                  events[TRACE_BLOCK_EVENTS];
+} trace_block;
+
+typedef struct trace_buffer {
+    struct trace_buffer *next;
+    trace_block         *first;
+    // written by the owning thread only
+    trace_block         *last;
+    // slices begun and not yet ended
+    uqword               depth;
+    udword               thread;
+    char const *_Atomic  name;
+} trace_buffer;
+
+atomic_bool trace_recording;
+
+static _Atomic(trace_buffer *) trace_buffers;
+static _Thread_local trace_buffer *trace_thread_buffer;
+static _Atomic udword trace_threads;
+static _Atomic uqword trace_origin;
+
+static uqword trace_clock(void) {
+    return (uqword) p_get_time(NANOSECONDS);
+}
+
+static trace_block *trace_new_block(void) {
+    trace_block *block = malloc(sizeof(trace_block));
+    if (block == NULL)
+        fatalf(__func__, "unable to allocate %zu bytes for trace events\n", sizeof(trace_block));
+    atomic_init(&block->count, 0);
+    atomic_init(&block->next, NULL);
+    return block;
+}
+
+static trace_buffer *trace_acquire_buffer(void) {
+    trace_buffer *buffer = malloc(sizeof(trace_buffer));
+    if (buffer == NULL)
+        fatalf(__func__, "unable to allocate a trace buffer\n");
+    buffer->first = buffer->last = trace_new_block();
+    buffer->depth = 0;
+    buffer->thread = atomic_fetch_add_explicit(&trace_threads, 1, memory_order_relaxed) + 1;
+    atomic_init(&buffer->name, NULL);
+
+    buffer->next = atomic_load_explicit(&trace_buffers, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&trace_buffers, &buffer->next, buffer, memory_order_release,
+                                                  memory_order_relaxed));
+    return trace_thread_buffer = buffer;
+}
+
+static void trace_append(enum trace_phase phase, char const *name, qword value) {
+    trace_buffer *buffer = trace_thread_buffer;
+    if (buffer == NULL)
+        buffer = trace_acquire_buffer();
+
+    trace_block *block = buffer->last;
+    udword       count = atomic_load_explicit(&block->count, memory_order_relaxed);
+    if (count == TRACE_BLOCK_EVENTS) {
+        trace_block *next = trace_new_block();
+        atomic_store_explicit(&block->next, next, memory_order_release);
+        buffer->last = block = next;
+        count = 0;
+    }
+
+    block->events[count] = (trace_event) {
+            .time = trace_clock() - atomic_load_explicit(&trace_origin, memory_order_relaxed),
+            .name = name,
+            .context = get_context(),
+            .value = value,
+            .phase = phase
+    };
+    atomic_store_explicit(&block->count, count + 1, memory_order_release);
+}
+
+void trace_start(void) {
+    uqword expected = 0;
+    // the first start fixes time zero of the whole trace
+    atomic_compare_exchange_strong(&trace_origin, &expected, trace_clock());
+    atomic_store(&trace_recording, true);
+}
+
+void trace_stop(void) {
+    atomic_store(&trace_recording, false);
+}
+
+void trace_reset(void) {
+    for (trace_buffer *buffer = atomic_load(&trace_buffers); buffer != NULL; buffer = buffer->next) {
+        trace_block *block = atomic_load(&buffer->first->next);
+        while (block != NULL) {
+            trace_block *next = atomic_load(&block->next);
+            free(block);
+            block = next;
+        }
+        atomic_store(&buffer->first->next, NULL);
+        atomic_store(&buffer->first->count, 0);
+        buffer->last = buffer->first;
+        buffer->depth = 0;
+    }
+    atomic_store(&trace_origin, trace_clock());
+}
+
+void trace_thread_name(char const *name) {
+    trace_buffer *buffer = trace_thread_buffer;
+    if (buffer == NULL)
+        buffer = trace_acquire_buffer();
+    atomic_store_explicit(&buffer->name, name, memory_order_release);
+}
+
+void trace_begin_event(char const *name) {
+    trace_append(TRACE_PHASE_BEGIN, name, 0);
+    trace_thread_buffer->depth++;
+}
+
+void trace_end_event(void) {
+    trace_buffer *buffer = trace_thread_buffer;
+    // a slice begun before trace_start has no begin event to match
+    if (buffer == NULL || buffer->depth == 0)
+        return;
+    buffer->depth--;
+    trace_append(TRACE_PHASE_END, NULL, 0);
+}
+
+void trace_instant_event(char const *name) {
+    trace_append(TRACE_PHASE_INSTANT, name, 0);
+}
+
+void trace_counter_event(char const *name, qword value) {
+    trace_append(TRACE_PHASE_COUNTER, name, value);
+}
+
+/* EXPORT */
+
+static void trace_write_string(FILE *file, char const *string) {
+    fputc('"', file);
+    for (char const *c = string; *c; c++) {
+        switch (*c) {
+            case '"':
+            case '\\':
+                fputc('\\', file);
+                fputc(*c, file);
+                break;
+            default:
+                if ((ubyte) *c < 0x20)
+                    fprintf(file, "\\u%04x", (ubyte) *c);
+                else
+                    fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+static void trace_write_event(FILE *file, trace_event const *event, udword thread) {
+    fputs(",\n{\"ph\":\"", file);
+    fputc(event->phase, file);
+    fprintf(file, "\",\"ts\":%llu.%03llu,\"pid\":1,\"tid\":%u", (unsigned long long) (event->time / 1000u),
+            (unsigned long long) (event->time % 1000u), thread);
+    if (event->phase != TRACE_PHASE_END) {
+        fputs(",\"name\":", file);
+        trace_write_string(file, event->name);
+        fputs(",\"cat\":", file);
+        trace_write_string(file, event->context);
+    }
+    if (event->phase == TRACE_PHASE_INSTANT)
+        fputs(",\"s\":\"t\"", file);
+    else if (event->phase == TRACE_PHASE_COUNTER)
+        fprintf(file, ",\"args\":{\"value\":%lld}", (long long) event->value);
+    fputc('}', file);
+}
+
+bool trace_write(char const *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+        return false;
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+          "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"Project-Aquinas\"}}", file);
+
+    for (trace_buffer *buffer = atomic_load_explicit(&trace_buffers, memory_order_acquire); buffer != NULL;
+         buffer = buffer->next) {
+        char const *name = atomic_load_explicit(&buffer->name, memory_order_acquire);
+        if (name != NULL) {
+            fprintf(file, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":",
+                    buffer->thread);
+            trace_write_string(file, name);
+            fputs("}}", file);
+        }
+
+        for (trace_block *block = buffer->first; block != NULL;
+             block = atomic_load_explicit(&block->next, memory_order_acquire)) {
+            udword const count = atomic_load_explicit(&block->count, memory_order_acquire);
+            for (udword i = 0; i < count; i++)
+                trace_write_event(file, &block->events[i], buffer->thread);
+        }
+    }
+
+    fputs("\n]}\n", file);
+    bool const written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
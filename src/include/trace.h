@@ -0,0 +1,121 @@
+/*
+ * Module: trace
+ * File: trace.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Timeline events in the Chrome trace event format, which chrome://tracing and Perfetto open directly. Events are
+ * appended to a buffer owned by the calling thread without locking; trace_write exports the events of every thread as
+ * one JSON file. Recording is off until trace_start, and every call costs one load and one branch while it is off.
+ *
+ * Slices are begun and ended on the same thread and nest; set_context and clear_context begin and end a slice named
+ * after the context, and every other event is filed under the innermost context of its thread as its category. Event
+ * names are stored by address and must have static storage duration.
+ */
+
+#ifndef PROJECT_AQUINAS_TRACE_H
+#define PROJECT_AQUINAS_TRACE_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <platform.h>
+
+/*
+ * Events per block of a thread's buffer; buffers grow a block at a time and are kept until trace_reset.
+ */
+#ifndef TRACE_BLOCK_EVENTS
+  #define TRACE_BLOCK_EVENTS 4096
+#endif
+
+extern atomic_bool trace_recording;
+
+static inline bool trace_enabled(void) {
+    return atomic_load_explicit(&trace_recording, memory_order_relaxed);
+}
+
+void trace_start(void);
+
+void trace_stop(void);
+
+/*
+ * Discards the events of every thread. Must not run concurrently with recording.
+ */
+void trace_reset(void);
+
+/*
+ * Names the calling thread in the exported trace.
+ */
+void trace_thread_name(char const *name);
+
+/* RECORDING */
+
+void trace_begin_event(char const *name);
+
+void trace_end_event(void);
+
+void trace_instant_event(char const *name);
+
+void trace_counter_event(char const *name, qword value);
+
+/*
+ * Begins a slice on the calling thread.
+ */
+static inline void trace_begin(char const *name) {
+    if (trace_enabled())
+        trace_begin_event(name);
+}
+
+/*
+ * Ends the most recent slice begun on the calling thread.
+ */
+static inline void trace_end(void) {
+    if (trace_enabled())
+        trace_end_event();
+}
+
+/*
+ * Marks a point in time on the calling thread.
+ */
+static inline void trace_instant(char const *name) {
+    if (trace_enabled())
+        trace_instant_event(name);
+}
+
+/*
+ * Records the value of a named counter, drawn as a track of its own.
+ */
+static inline void trace_counter(char const *name, qword value) {
+    if (trace_enabled())
+        trace_counter_event(name, value);
+}
+
+static inline void trace_scope_end(bool const *begun) {
+    if (*begun)
+        trace_end_event();
+}
+
+/*
+ * Begins a slice which ends when the enclosing block is left. The slice is only ended if it was begun, so starting or
+ * stopping the trace inside the block keeps slices balanced.
+ */
+#define trace_scope(name) \
+    bool const trace_scope_concat(trace_scope_, __LINE__) __attribute__((cleanup(trace_scope_end))) = \
+            trace_enabled() ? (trace_begin_event(name), true) : false
+
+#define trace_scope_concat(a, b) trace_scope_concat_(a, b)
+#define trace_scope_concat_(a, b) a##b
+
+/* EXPORT */
+
+/*
+ * Writes the events recorded so far by every thread to `path` as Chrome trace JSON. Threads may keep recording while
+ * the file is written; their later events are left out. Returns false if the file cannot be written.
+ */
+bool trace_write(char const *path);
+
+#endif //PROJECT_AQUINAS_TRACE_H
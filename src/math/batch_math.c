@@ -0,0 +1,295 @@
+/*
+ * Module: batch_math
+ * File: batch_math.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <string.h>
+#include "batch_math.h"
+
+#if ARCH_BYTE_ORDER != BYTE_ORDER_LO_TO_HI
+  #error "[build][fatal][batch_math] fix_t lanes assume the low half is stored first"
+#endif
+
+#if BATCH_LANES != 4
+  #error "[build][fatal][batch_math] the lane shuffles assume BATCH_LANES == 4"
+#endif
+
+/*
+ * Lanes are passed by address: passing vectors wider than the baseline registers by value changes the ABI.
+ */
+static inline void batch_load(uqword_lanes *lanes, void const *source) {
+    memcpy(lanes, source, sizeof(*lanes));
+}
+
+static inline void batch_store(void *destination, uqword_lanes const *lanes) {
+    memcpy(destination, lanes, sizeof(*lanes));
+}
+
+static inline bool batch_any(uqword_lanes const *lanes) {
+    uqword any = 0;
+    for (ubyte lane = 0; lane < BATCH_LANES; lane++)
+        any |= (*lanes)[lane];
+    return any != 0;
+}
+
+/* frac_t */
+
+typedef struct frc_lanes {
+    qword_lanes numerator;
+    qword_lanes denominator;
+    // every term fits in 31 bits, so cross products and their sums fit in a lane
+    bool        narrow;
+} frc_lanes;
+
+/*
+ * Decodes BATCH_LANES values; mirrors frc_rdnum and frc_rdden (fields are ordered from the least significant bit).
+ */
+static inline void frc_lanes_decode(frc_lanes *lanes, frac_t const *source) {
+    uqword_lanes value;
+    batch_load(&value, source);
+
+    uqword_lanes const divider     = (value >> 1u) & 63u;
+    uqword_lanes const significand = value >> 7u;
+    uqword_lanes const magnitude   = significand >> divider;
+    uqword_lanes const denominator = significand & (((uqword_lanes) {1, 1, 1, 1} << divider) - 1u);
+    // all ones in negative lanes
+    qword_lanes const  negative    = -(qword_lanes) (value & 1u);
+
+    uqword_lanes const wide        = (magnitude | denominator) >> 31u;
+
+    lanes->numerator = ((qword_lanes) magnitude ^ negative) - negative;
+    lanes->denominator = (qword_lanes) denominator;
+    lanes->narrow = !batch_any(&wide);
+}
+
+enum frc_batch_operation {
+    FRC_BATCH_ADD,
+    FRC_BATCH_SUB,
+    FRC_BATCH_MUL
+};
+
+static inline frac_t frc_batch_scalar(enum frc_batch_operation operation, frac_t a, frac_t b) {
+    switch (operation) {
+        case FRC_BATCH_ADD:
+            return frc_add(a, b);
+        case FRC_BATCH_SUB:
+            return frc_sub(a, b);
+        default:
+            return frc_mul(a, b);
+    }
+}
+
+static inline void frc_batch_binary(enum frc_batch_operation operation, frac_t *out, frac_t const *a, frac_t const *b,
+                                    uqword count) {
+    uqword i = 0;
+
+    for (; i + BATCH_LANES <= count; i += BATCH_LANES) {
+        frc_lanes x, y;
+        frc_lanes_decode(&x, a + i);
+        frc_lanes_decode(&y, b + i);
+
+        if (!(x.narrow && y.narrow)) {
+            for (ubyte lane = 0; lane < BATCH_LANES; lane++)
+                out[i + lane] = frc_batch_scalar(operation, a[i + lane], b[i + lane]);
+            continue;
+        }
+
+        qword_lanes numerator;
+        switch (operation) {
+            case FRC_BATCH_ADD:
+                numerator = x.numerator * y.denominator + y.numerator * x.denominator;
+                break;
+            case FRC_BATCH_SUB:
+                numerator = x.numerator * y.denominator - y.numerator * x.denominator;
+                break;
+            default:
+                numerator = x.numerator * y.numerator;
+                break;
+        }
+        qword_lanes const denominator = x.denominator * y.denominator;
+
+        // reduction to lowest terms has no lane equivalent
+        for (ubyte lane = 0; lane < BATCH_LANES; lane++)
+            out[i + lane] = frc_pack(numerator[lane], (udqword) denominator[lane]);
+    }
+
+    for (; i < count; i++)
+        out[i] = frc_batch_scalar(operation, a[i], b[i]);
+}
+
+void frc_batch_add(frac_t *out, frac_t const *a, frac_t const *b, uqword count) {
+    frc_batch_binary(FRC_BATCH_ADD, out, a, b, count);
+}
+
+void frc_batch_sub(frac_t *out, frac_t const *a, frac_t const *b, uqword count) {
+    frc_batch_binary(FRC_BATCH_SUB, out, a, b, count);
+}
+
+void frc_batch_mul(frac_t *out, frac_t const *a, frac_t const *b, uqword count) {
+    frc_batch_binary(FRC_BATCH_MUL, out, a, b, count);
+}
+
+void frc_batch_cmp(sbyte *out, frac_t const *a, frac_t const *b, uqword count) {
+    uqword i = 0;
+
+    for (; i + BATCH_LANES <= count; i += BATCH_LANES) {
+        frc_lanes x, y;
+        frc_lanes_decode(&x, a + i);
+        frc_lanes_decode(&y, b + i);
+
+        if (!(x.narrow && y.narrow)) {
+            for (ubyte lane = 0; lane < BATCH_LANES; lane++)
+                out[i + lane] = frc_cmp(a[i + lane], b[i + lane]);
+            continue;
+        }
+
+        qword_lanes const left  = x.numerator * y.denominator;
+        qword_lanes const right = y.numerator * x.denominator;
+        // comparisons yield -1 in lanes where they hold
+        qword_lanes const order = (left < right) - (left > right);
+        for (ubyte lane = 0; lane < BATCH_LANES; lane++)
+            out[i + lane] = (sbyte) order[lane];
+    }
+
+    for (; i < count; i++)
+        out[i] = frc_cmp(a[i], b[i]);
+}
+
+void frc_batch_normalize(frac_t *out, frac_t const *a, uqword count) {
+    uqword i = 0;
+
+    for (; i + BATCH_LANES <= count; i += BATCH_LANES) {
+        frc_lanes x;
+        frc_lanes_decode(&x, a + i);
+        for (ubyte lane = 0; lane < BATCH_LANES; lane++)
+            out[i + lane] = frc_pack(x.numerator[lane], (udqword) x.denominator[lane]);
+    }
+
+    for (; i < count; i++)
+        out[i] = frc_simplify(a[i]);
+}
+
+void frc_batch_to_fix(fix_t *out, frac_t const *a, uqword count) {
+    uqword i = 0;
+
+    for (; i + BATCH_LANES <= count; i += BATCH_LANES) {
+        frc_lanes x;
+        frc_lanes_decode(&x, a + i);
+        for (ubyte lane = 0; lane < BATCH_LANES; lane++)
+            out[i + lane] = fix_div_q(x.numerator[lane], x.denominator[lane], FIX_FRACTION_BITS,
+                                      FIX_ROUND_NEAREST_EVEN, true);
+    }
+
+    for (; i < count; i++)
+        out[i] = fix_div_q(frc_rdnum(a[i]), frc_rdden(a[i]), FIX_FRACTION_BITS, FIX_ROUND_NEAREST_EVEN, true);
+}
+
+/* fix_t */
+
+/*
+ * Splits BATCH_LANES values into their low and high halves.
+ */
+static inline void fix_lanes_load(fix_t const *source, uqword_lanes *lo, uqword_lanes *hi) {
+    uqword_lanes first, second;
+    batch_load(&first, source);
+    batch_load(&second, source + BATCH_LANES / 2);
+    *lo = __builtin_shuffle(first, second, (uqword_lanes) {0, 2, 4, 6});
+    *hi = __builtin_shuffle(first, second, (uqword_lanes) {1, 3, 5, 7});
+}
+
+static inline void fix_lanes_store(fix_t *destination, uqword_lanes const *lo, uqword_lanes const *hi) {
+    uqword_lanes const first  = __builtin_shuffle(*lo, *hi, (uqword_lanes) {0, 4, 1, 5});
+    uqword_lanes const second = __builtin_shuffle(*lo, *hi, (uqword_lanes) {2, 6, 3, 7});
+    batch_store(destination, &first);
+    batch_store(destination + BATCH_LANES / 2, &second);
+}
+
+void fix_batch_add(fix_t *out, fix_t const *a, fix_t const *b, uqword count) {
+    uqword i = 0;
+
+    for (; i + BATCH_LANES <= count; i += BATCH_LANES) {
+        uqword_lanes a_lo, a_hi, b_lo, b_hi;
+        fix_lanes_load(a + i, &a_lo, &a_hi);
+        fix_lanes_load(b + i, &b_lo, &b_hi);
+
+        uqword_lanes const lo = a_lo + b_lo;
+        // the carry mask is all ones where the low half wrapped
+        uqword_lanes const hi = a_hi + b_hi - (uqword_lanes) (lo < a_lo);
+        fix_lanes_store(out + i, &lo, &hi);
+    }
+
+    for (; i < count; i++)
+        out[i] = fix_add(a[i], b[i]);
+}
+
+void fix_batch_sub(fix_t *out, fix_t const *a, fix_t const *b, uqword count) {
+    uqword i = 0;
+
+    for (; i + BATCH_LANES <= count; i += BATCH_LANES) {
+        uqword_lanes a_lo, a_hi, b_lo, b_hi;
+        fix_lanes_load(a + i, &a_lo, &a_hi);
+        fix_lanes_load(b + i, &b_lo, &b_hi);
+
+        uqword_lanes const lo = a_lo - b_lo;
+        // the borrow mask is all ones where the low half wrapped
+        uqword_lanes const hi = a_hi - b_hi + (uqword_lanes) (a_lo < b_lo);
+        fix_lanes_store(out + i, &lo, &hi);
+    }
+
+    for (; i < count; i++)
+        out[i] = fix_sub(a[i], b[i]);
+}
+
+void fix_batch_mul(fix_t *out, fix_t const *a, fix_t const *b, uqword count) {
+    for (uqword i = 0; i < count; i++)
+        out[i] = fix_mul(a[i], b[i]);
+}
+
+void fix_batch_cmp(sbyte *out, fix_t const *a, fix_t const *b, uqword count) {
+    uqword i = 0;
+
+    for (; i + BATCH_LANES <= count; i += BATCH_LANES) {
+        uqword_lanes a_lo, a_hi, b_lo, b_hi;
+        fix_lanes_load(a + i, &a_lo, &a_hi);
+        fix_lanes_load(b + i, &b_lo, &b_hi);
+
+        // the high halves compare signed, the low halves unsigned; comparisons yield -1 where they hold
+        qword_lanes const equal   = (qword_lanes) a_hi == (qword_lanes) b_hi;
+        qword_lanes const less    = ((qword_lanes) a_hi < (qword_lanes) b_hi) | (equal & (a_lo < b_lo));
+        qword_lanes const greater = ((qword_lanes) a_hi > (qword_lanes) b_hi) | (equal & (a_lo > b_lo));
+        qword_lanes const order   = less - greater;
+        for (ubyte lane = 0; lane < BATCH_LANES; lane++)
+            out[i + lane] = (sbyte) order[lane];
+    }
+
+    for (; i < count; i++)
+        out[i] = (sbyte) ((a[i] > b[i]) - (a[i] < b[i]));
+}
+
+fix_t fix_batch_sum(fix_t const *a, uqword count) {
+    uqword_lanes sum_lo = {0}, sum_hi = {0};
+    uqword       i      = 0;
+
+    for (; i + BATCH_LANES <= count; i += BATCH_LANES) {
+        uqword_lanes lo, hi;
+        fix_lanes_load(a + i, &lo, &hi);
+
+        uqword_lanes const next = sum_lo + lo;
+        sum_hi += hi - (uqword_lanes) (next < sum_lo);
+        sum_lo = next;
+    }
+
+    fix_t sum = 0;
+    for (ubyte lane = 0; lane < BATCH_LANES; lane++)
+        sum = fix_add(sum, (fix_t) (((udqword) sum_hi[lane] << 64) | sum_lo[lane]));
+    for (; i < count; i++)
+        sum = fix_add(sum, a[i]);
+    return sum;
+}
@@ -0,0 +1,81 @@
+/*
+ * Module: batch_math
+ * File: batch_math.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Array kernels over frac_t and fix_t. Each kernel processes BATCH_LANES values per step in 64 bit vector lanes and
+ * finishes the remainder with the scalar operation, so every kernel produces exactly the result of its scalar
+ * counterpart applied element by element:
+ * - frac_t values are decoded in vector lanes; while every term of a step fits in 31 bits the cross products are
+ *   formed in the lanes as well, otherwise the step falls back to the scalar operation.
+ * - fix_t values are split into low and high halves so that addition, subtraction and comparison run as 64 bit lane
+ *   operations with an explicit carry.
+ * Output arrays may alias an input array exactly, but must not otherwise overlap.
+ */
+
+#ifndef PROJECT_AQUINAS_BATCH_MATH_H
+#define PROJECT_AQUINAS_BATCH_MATH_H
+
+#include <platform.h>
+#include "frc_math.h"
+#include "fix_math.h"
+
+/*
+ * Number of values per vector step.
+ */
+#define BATCH_LANES 4
+
+typedef uqword uqword_lanes __attribute__((vector_size(BATCH_LANES * sizeof(uqword))));
+typedef qword  qword_lanes __attribute__((vector_size(BATCH_LANES * sizeof(qword))));
+
+/* frac_t */
+
+void frc_batch_add(frac_t *out, frac_t const *a, frac_t const *b, uqword count);
+
+void frc_batch_sub(frac_t *out, frac_t const *a, frac_t const *b, uqword count);
+
+void frc_batch_mul(frac_t *out, frac_t const *a, frac_t const *b, uqword count);
+
+/*
+ * Writes frc_cmp(a[i], b[i]) to out[i].
+ */
+void frc_batch_cmp(sbyte *out, frac_t const *a, frac_t const *b, uqword count);
+
+/*
+ * Reduces every value to lowest terms.
+ */
+void frc_batch_normalize(frac_t *out, frac_t const *a, uqword count);
+
+/*
+ * Converts every value to the nearest fix_t (ties to even, saturating).
+ */
+void frc_batch_to_fix(fix_t *out, frac_t const *a, uqword count);
+
+/* fix_t */
+
+void fix_batch_add(fix_t *out, fix_t const *a, fix_t const *b, uqword count);
+
+void fix_batch_sub(fix_t *out, fix_t const *a, fix_t const *b, uqword count);
+
+/*
+ * Writes fix_mul(a[i], b[i]) to out[i]. There is no 128 bit lane multiply, so this is a scalar loop kept for symmetry.
+ */
+void fix_batch_mul(fix_t *out, fix_t const *a, fix_t const *b, uqword count);
+
+/*
+ * Writes -1, 0 or 1 to out[i] as a[i] is less than, equal to or greater than b[i].
+ */
+void fix_batch_cmp(sbyte *out, fix_t const *a, fix_t const *b, uqword count);
+
+/*
+ * Returns the wrapping sum of every value.
+ */
+fix_t fix_batch_sum(fix_t const *a, uqword count);
+
+#endif //PROJECT_AQUINAS_BATCH_MATH_H
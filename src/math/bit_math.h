@@ -166,6 +166,50 @@ static inline uqword zero_high_bits(register uqword src, register uqword index)
     #endif
 }
 
+/*
+ * Portable bit counts, used where there is no instruction for them. Each folds or searches the word in a fixed number of
+ * steps rather than looping over its bits.
+ */
+
+/*
+ * Compute the number of significant bits in the given uqword by binary search; 0 counts as 1 bit, as in sigbits.
+ */
+__attribute__((hot, const))
+static inline uqword sigbits_portable(register uqword bit_string) {
+    ubyte k = 0;
+    if (bit_string > 0xFFFFFFFFu) { bit_string >>= 32; k  = 32; }
+    if (bit_string > 0x0000FFFFu) { bit_string >>= 16; k |= 16; }
+    if (bit_string > 0x000000FFu) { bit_string >>= 8;  k |= 8;  }
+    if (bit_string > 0x0000000Fu) { bit_string >>= 4;  k |= 4;  }
+    if (bit_string > 0x00000003u) { bit_string >>= 2;  k |= 2;  }
+    k |= (bit_string & 2u) >> 1u;
+    return k + 1u;
+}
+
+/*
+ * Count the number of ones in a bit_string by summing bits in parallel: pairs, then nibbles, then bytes by multiplication.
+ */
+__attribute__((hot, const))
+static inline uqword ones_portable(register uqword bit_string) {
+    bit_string -= (bit_string >> 1u) & 0x5555555555555555u;
+    bit_string = (bit_string & 0x3333333333333333u) + ((bit_string >> 2u) & 0x3333333333333333u);
+    bit_string = (bit_string + (bit_string >> 4u)) & 0x0F0F0F0F0F0F0F0Fu;
+    return (bit_string * 0x0101010101010101u) >> 56u;
+}
+
+__attribute__((hot, const))
+static inline uqword cntlz_portable(register uqword bit_string) {
+    return bit_string ? bitwidth(bit_string) - sigbits_portable(bit_string) : bitwidth(bit_string);
+}
+
+/*
+ * The trailing zeroes become the only ones of (x & -x) - 1.
+ */
+__attribute__((hot, const))
+static inline uqword cnttz_portable(register uqword bit_string) {
+    return bit_string ? ones_portable((bit_string & -bit_string) - 1u) : bitwidth(bit_string);
+}
+
 /*
  * Count the number of leading zeroes in bit_string.
  */
@@ -176,14 +220,7 @@ static inline uqword cntlz(register uqword bit_string) {
     #elif ARCH == ARCH_X86_64
     return __x64_lzcnt(bit_string);
     #else
-    ubyte zeroes = 0;
-    // zeroes to ones
-    bit_string = ~bit_string;
-    ubyte loop_condition;
-    for (uqword i = bitwidth(bit_string) - 1u; i < bitwidth(bit_string) && (loop_condition = (bit_string >> i) & 1u); i++) {
-        zeroes += loop_condition;
-    }
-    return zeroes;
+    return cntlz_portable(bit_string);
     #endif
 }
 
@@ -197,14 +234,7 @@ static inline uqword cnttz(register uqword bit_string) {
     #elif ARCH == ARCH_X86_64
     return __x64_tzcnt(bit_string);
     #else
-    ubyte zeroes = 0;
-    // zeroes to ones
-    bit_string = ~bit_string;
-    ubyte loop_condition;
-    for (uqword i = 0; i < bitwidth(bit_string) && (loop_condition = (bit_string >> i) & 1u); i++) {
-        zeroes += loop_condition;
-    }
-    return zeroes;
+    return cnttz_portable(bit_string);
     #endif
 }
 
@@ -218,14 +248,7 @@ static inline uqword ones(register uqword bit_string) {
     #elif ARCH == ARCH_X86_64
     return __x64_popcnt(bit_string);
     #else
-    ubyte zeroes = 0;
-    // zeroes to ones
-    bit_string = ~bit_string;
-    ubyte loop_condition;
-    for (uqword i = 0; i < bitwidth(bit_string) && (loop_condition = (bit_string >> i) & 1u); i++) {
-        zeroes += loop_condition;
-    }
-    return zeroes;
+    return ones_portable(bit_string);
     #endif
 }
 
@@ -388,11 +411,15 @@ static inline udqword umod2pN8(register sbyte sign, register ubyte exp, register
     //    uqword a
 }
 
+// maintain grouping of functions
+static inline udqword euclid_udivq(uqword, uqword);
+
 /*
- * Evaluates fast modulus as a mod b to machine precision using bit math.
+ * Evaluates fast modulus as a mod b to machine precision. A modulus of 0 leaves x unchanged.
  */
 __attribute__((const))
 static inline uqword umodq(register uqword x, register uqword modulus) {
+    return (uqword) euclid_udivq(x, modulus);
 }
 
 /*
@@ -507,16 +534,52 @@ static inline udqword umulq(register uqword multiplicand, register uqword multip
 //}
 
 /*
- * Uses a fast Euclidean division algorithm to compute divides to machine precision.
+ * Uses a fast Euclidean division algorithm to compute divides to machine precision. The quotient is returned in the
+ * high uqword and the remainder in the low one, from a single hardware divide. A divisor of 0 gives a quotient of ~0
+ * and a remainder of the dividend, as udiv6 does.
  */
+__attribute__((const))
 static inline udqword euclid_udivq(register uqword dividend, register uqword divisor) {
-    // 64.64 fixed-point register
-    register udqword quotient = dividend;
-    register uqword  remainder;
+    if (divisor == 0)
+        return (udqword) ~(uqword) 0 << bitwidth(uqword) | dividend;
+    register uqword const quotient  = dividend / divisor;
+    register uqword const remainder = dividend - quotient * divisor;
+    return (udqword) quotient << bitwidth(uqword) | remainder;
+}
+
+/*
+ * Computes euclid_udivq by restoring shift-and-subtract division, one quotient bit per significant bit of the dividend.
+ */
+__attribute__((const))
+static inline udqword euclid_udivq_portable(register uqword dividend, register uqword divisor) {
+    if (divisor == 0)
+        return (udqword) ~(uqword) 0 << bitwidth(uqword) | dividend;
+    register uqword quotient = 0, remainder = 0;
+    for (qword bit = (qword) sigbits_portable(dividend) - 1; bit >= 0; bit--) {
+        // the remainder is below the divisor, which may use every bit, so shifting it may carry out
+        register uqword const carry = remainder >> (bitwidth(uqword) - 1u);
+        remainder = remainder << 1u | ((dividend >> bit) & 1u);
+        if (carry || remainder >= divisor) {
+            remainder -= divisor;
+            quotient |= 1ull << bit;
+        }
+    }
+    return (udqword) quotient << bitwidth(uqword) | remainder;
 }
 
+__attribute__((const))
 static inline uqword udivq(register uqword dividend, register uqword divisor) {
-    return (uqword) (euclid_udivq(dividend, divisor) >> sizeof(uqword));
+    return (uqword) (euclid_udivq(dividend, divisor) >> bitwidth(uqword));
+}
+
+__attribute__((const))
+static inline uqword udivq_portable(register uqword dividend, register uqword divisor) {
+    return (uqword) (euclid_udivq_portable(dividend, divisor) >> bitwidth(uqword));
+}
+
+__attribute__((const))
+static inline uqword umodq_portable(register uqword x, register uqword modulus) {
+    return (uqword) euclid_udivq_portable(x, modulus);
 }
 
 /*
@@ -547,14 +610,7 @@ static inline uqword sigbits(register uqword bit_string) {
             #error "ARM variant not supported"
           #endif
         #else
-    ubyte  k = 0;
-    if (bit_string > 0xFFFFFFFFu) { bit_string >>= 32; k  = 32; }
-    if (bit_string > 0x0000FFFFu) { bit_string >>= 16; k |= 16; }
-    if (bit_string > 0x000000FFu) { bit_string >>= 8;  k |= 8;  }
-    if (bit_string > 0x0000000Fu) { bit_string >>= 4;  k |= 4;  }
-    if (bit_string > 0x00000003u) { bit_string >>= 2;  k |= 2;  }
-    k |= (bit_string & 2u) >> 1u;
-    return k;
+    return sigbits_portable(bit_string);
     #endif
 }
 
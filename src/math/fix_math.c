@@ -0,0 +1,276 @@
+/*
+ * Module: fix_math
+ * File: fix_math.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Division, square root, logarithm and exponential for fix_t. Each is computed with integer operations only: division
+ * by long division in chunks as wide as the divisor allows, square root by Newton's method on the exact 256 bit
+ * radicand, the logarithm by repeated squaring (one result bit per square) and the exponential as a product of the
+ * constants 2^(2^-k) selected by the bits of the fraction.
+ */
+
+#include "fix_math.h"
+
+/*
+ * 2^(2^-k) for k in [1, 126] in 1.127 fixed point, rounded to nearest; stored as {hi, lo}.
+ */
+static uqword const FIX_EXP2_ROOTS[][2] = {
+        {0xb504f333f9de6484, 0x597d89b3754abe9f},
+        {0x9837f0518db8a96f, 0x46ad23182e42f6f6},
+        {0x8b95c1e3ea8bd6e6, 0xfbe4628758a53c90},
+        {0x85aac367cc487b14, 0xc5c95b8c2154c1b2},
+        {0x82cd8698ac2ba1d7, 0x3e2a475b46520bff},
+        {0x8164d1f3bc030773, 0x7be56527bd14def5},
+        {0x80b1ed4fd999ab6c, 0x25335719b6e6fd20},
+        {0x8058d7d2d5e5f6b0, 0x94d589f608ee4aa2},
+        {0x802c6436d0e04f50, 0xff8ce94a6797b3ce},
+        {0x8016302f17467628, 0x3690dfe44d11d008},
+        {0x800b179c82028fd0, 0x945e54e2ae18f2f0},
+        {0x80058baf7fee3b5d, 0x1c718b38e549cb93},
+        {0x8002c5d00fdcfcb6, 0xb6566a58c048be1f},
+        {0x800162e61bed4a48, 0xe84c2e1a463473da},
+        {0x8000b17292f702a3, 0xaa22beacca949013},
+        {0x800058b92abbae02, 0x030c5fa5256f41fe},
+        {0x80002c5c8dade4d7, 0x1776c0f4dbea67d6},
+        {0x8000162e44eaf636, 0x526be456600bdbe5},
+        {0x80000b1721fa7c18, 0x8307016c1cd4e8b7},
+        {0x8000058b90de7e4c, 0xecfc487503488bb2},
+        {0x800002c5c8678f36, 0xcbfce50a6de60b14},
+        {0x80000162e431db9f, 0x80b2347b5d62e516},
+        {0x800000b1721872d0, 0xc7b08cf1e0114153},
+        {0x80000058b90c1aa8, 0xa5c3736cb77e8e00},
+        {0x8000002c5c8605a4, 0x635f2efc2362d978},
+        {0x800000162e4300e6, 0x35cf4a109e3939bd},
+        {0x8000000b17217ff8, 0x1bef9c551590cf83},
+        {0x800000058b90bfdd, 0x4e39cd52c0cfa27d},
+        {0x80000002c5c85fe6, 0xf72d669e0e76e412},
+        {0x8000000162e42ff1, 0x8f9ad35186d0df28},
+        {0x80000000b17217f8, 0x4cce71aa0dcfffe8},
+        {0x8000000058b90bfc, 0x07a77ad56ed22aaa},
+        {0x800000002c5c85fd, 0xfc23cdead40da8d7},
+        {0x80000000162e42fe, 0xfc25eb1571853a66},
+        {0x800000000b17217f, 0x7d97f692baacded5},
+        {0x80000000058b90bf, 0xbead3b8b5dd254d8},
+        {0x8000000002c5c85f, 0xdf4eedd62f084e68},
+        {0x800000000162e42f, 0xefa58aef378bf587},
+        {0x8000000000b17217, 0xf7d24a78a3c7ef03},
+        {0x800000000058b90b, 0xfbe9067c93e474a6},
+        {0x80000000002c5c85, 0xfdf47b8e5a72599f},
+        {0x8000000000162e42, 0xfefa3bdb315934a3},
+        {0x80000000000b1721, 0x7f7d1d7299b49c46},
+        {0x8000000000058b90, 0xbfbe8e9a8d1c4ea0},
+        {0x800000000002c5c8, 0x5fdf4745969ea76f},
+        {0x80000000000162e4, 0x2fefa3a0df5373c0},
+        {0x800000000000b172, 0x17f7d1cff4aac1e2},
+        {0x80000000000058b9, 0x0bfbe8e7db95a2f1},
+        {0x8000000000002c5c, 0x85fdf473e61ae1f9},
+        {0x800000000000162e, 0x42fefa39f121751c},
+        {0x8000000000000b17, 0x217f7d1cf815bb96},
+        {0x800000000000058b, 0x90bfbe8e7bec1e0d},
+        {0x80000000000002c5, 0xc85fdf473dee5f17},
+        {0x8000000000000162, 0xe42fefa39ef54390},
+        {0x80000000000000b1, 0x7217f7d1cf7a26c9},
+        {0x8000000000000058, 0xb90bfbe8e7bcf4a5},
+        {0x800000000000002c, 0x5c85fdf473de72a2},
+        {0x8000000000000016, 0x2e42fefa39ef3765},
+        {0x800000000000000b, 0x17217f7d1cf79b38},
+        {0x8000000000000005, 0x8b90bfbe8e7bcd7d},
+        {0x8000000000000002, 0xc5c85fdf473de6b7},
+        {0x8000000000000001, 0x62e42fefa39ef359},
+        {0x8000000000000000, 0xb17217f7d1cf79ac},
+        {0x8000000000000000, 0x58b90bfbe8e7bcd6},
+        {0x8000000000000000, 0x2c5c85fdf473de6b},
+        {0x8000000000000000, 0x162e42fefa39ef35},
+        {0x8000000000000000, 0x0b17217f7d1cf79b},
+        {0x8000000000000000, 0x058b90bfbe8e7bcd},
+        {0x8000000000000000, 0x02c5c85fdf473de7},
+        {0x8000000000000000, 0x0162e42fefa39ef3},
+        {0x8000000000000000, 0x00b17217f7d1cf7a},
+        {0x8000000000000000, 0x0058b90bfbe8e7bd},
+        {0x8000000000000000, 0x002c5c85fdf473de},
+        {0x8000000000000000, 0x00162e42fefa39ef},
+        {0x8000000000000000, 0x000b17217f7d1cf8},
+        {0x8000000000000000, 0x00058b90bfbe8e7c},
+        {0x8000000000000000, 0x0002c5c85fdf473e},
+        {0x8000000000000000, 0x000162e42fefa39f},
+        {0x8000000000000000, 0x0000b17217f7d1cf},
+        {0x8000000000000000, 0x000058b90bfbe8e8},
+        {0x8000000000000000, 0x00002c5c85fdf474},
+        {0x8000000000000000, 0x0000162e42fefa3a},
+        {0x8000000000000000, 0x00000b17217f7d1d},
+        {0x8000000000000000, 0x0000058b90bfbe8e},
+        {0x8000000000000000, 0x000002c5c85fdf47},
+        {0x8000000000000000, 0x00000162e42fefa4},
+        {0x8000000000000000, 0x000000b17217f7d2},
+        {0x8000000000000000, 0x00000058b90bfbe9},
+        {0x8000000000000000, 0x0000002c5c85fdf4},
+        {0x8000000000000000, 0x000000162e42fefa},
+        {0x8000000000000000, 0x0000000b17217f7d},
+        {0x8000000000000000, 0x000000058b90bfbf},
+        {0x8000000000000000, 0x00000002c5c85fdf},
+        {0x8000000000000000, 0x0000000162e42ff0},
+        {0x8000000000000000, 0x00000000b17217f8},
+        {0x8000000000000000, 0x0000000058b90bfc},
+        {0x8000000000000000, 0x000000002c5c85fe},
+        {0x8000000000000000, 0x00000000162e42ff},
+        {0x8000000000000000, 0x000000000b17217f},
+        {0x8000000000000000, 0x00000000058b90c0},
+        {0x8000000000000000, 0x0000000002c5c860},
+        {0x8000000000000000, 0x000000000162e430},
+        {0x8000000000000000, 0x0000000000b17218},
+        {0x8000000000000000, 0x000000000058b90c},
+        {0x8000000000000000, 0x00000000002c5c86},
+        {0x8000000000000000, 0x0000000000162e43},
+        {0x8000000000000000, 0x00000000000b1721},
+        {0x8000000000000000, 0x0000000000058b91},
+        {0x8000000000000000, 0x000000000002c5c8},
+        {0x8000000000000000, 0x00000000000162e4},
+        {0x8000000000000000, 0x000000000000b172},
+        {0x8000000000000000, 0x00000000000058b9},
+        {0x8000000000000000, 0x0000000000002c5d},
+        {0x8000000000000000, 0x000000000000162e},
+        {0x8000000000000000, 0x0000000000000b17},
+        {0x8000000000000000, 0x000000000000058c},
+        {0x8000000000000000, 0x00000000000002c6},
+        {0x8000000000000000, 0x0000000000000163},
+        {0x8000000000000000, 0x00000000000000b1},
+        {0x8000000000000000, 0x0000000000000059},
+        {0x8000000000000000, 0x000000000000002c},
+        {0x8000000000000000, 0x0000000000000016},
+        {0x8000000000000000, 0x000000000000000b},
+        {0x8000000000000000, 0x0000000000000006},
+        {0x8000000000000000, 0x0000000000000003},
+        {0x8000000000000000, 0x0000000000000001},
+};
+
+static inline qword fix_sigbits(udqword value) {
+    uqword hi = (uqword) (value >> 64);
+    if (hi)
+        return 128 - __builtin_clzll(hi);
+    return value ? 64 - __builtin_clzll((uqword) value) : 0;
+}
+
+/*
+ * Returns floor((a << shift) / b) and its remainder; the quotient must fit in 128 bits, which `overflow` reports.
+ * Requires b <= 2^127.
+ */
+static udqword fix_udiv_shift(udqword a, udqword b, ubyte shift, udqword *remainder, bool *overflow) {
+    udqword     quotient = a / b;
+    udqword     rest     = a % b;
+    // the remainder is below b, so it can take as many bits per step as b has leading zeroes (at least one)
+    qword const zeroes   = 128 - fix_sigbits(b);
+    ubyte const step     = (ubyte) (zeroes ? zeroes : 1);
+
+    *overflow = shift && quotient >> (128 - shift);
+    for (ubyte left = shift; left;) {
+        ubyte const bits = left < step ? left : step;
+        rest <<= bits;
+        quotient = (quotient << bits) | (rest / b);
+        rest %= b;
+        left -= bits;
+    }
+    *remainder = rest;
+    return quotient;
+}
+
+fix_t fix_div_q(fix_t a, fix_t b, ubyte shift, enum fix_rounding mode, bool saturate) {
+    bool const negative = (a < 0) ^ (b < 0);
+
+    if (b == 0) {
+        if (!saturate)
+            fatalf(__func__, "division by zero\n");
+        return a == 0 ? 0 : a < 0 ? FIX_MIN : FIX_MAX;
+    }
+
+    udqword const divisor = fix_magnitude(b);
+    udqword       remainder;
+    bool          overflow;
+    udqword       quotient = fix_udiv_shift(fix_magnitude(a), divisor, shift, &remainder, &overflow);
+    // remainder < divisor <= 2^127, so doubling it cannot overflow
+    sbyte const   compare  = (sbyte) ((remainder << 1 > divisor) - (remainder << 1 < divisor));
+
+    if (fix_round_increment(mode, negative, quotient & 1u, compare, remainder != 0))
+        overflow |= ++quotient == 0;
+    return fix_signed(quotient, negative, overflow, saturate);
+}
+
+fix_t fix_sqrt(fix_t a) {
+    if (a < 0)
+        fatalf(__func__, "square root of a negative value\n");
+    if (a == 0)
+        return 0;
+
+    // floor(sqrt(a * 2^n)) by Newton's method from an initial guess above the root, which then decreases monotonically
+    qword const bits = fix_sigbits((udqword) a) + FIX_FRACTION_BITS;
+    udqword     x    = (udqword) 1 << ((bits + 1) / 2);
+    udqword     remainder;
+    bool        overflow;
+
+    for (;;) {
+        udqword const y = (x + fix_udiv_shift((udqword) a, x, FIX_FRACTION_BITS, &remainder, &overflow)) >> 1;
+        if (y >= x)
+            return (fix_t) x;
+        x = y;
+    }
+}
+
+fix_t fix_log2(fix_t a) {
+    if (a <= 0)
+        fatalf(__func__, "logarithm of a value which is not positive\n");
+
+    qword const msb      = fix_sigbits((udqword) a) - 1;
+    // mantissa in [1, 2) as 2.126 fixed point
+    udqword     mantissa = (udqword) a << (126 - msb);
+    udqword     fraction = 0;
+
+    for (ubyte i = 0; i < FIX_FRACTION_BITS; i++) {
+        udqword hi, lo;
+        fix_umul256(mantissa, mantissa, &hi, &lo);
+        // the square is in [1, 4) as 4.252 fixed point; at or above 2 the next bit is set and the square is halved
+        bool const bit = (hi >> 125) != 0;
+        mantissa = (hi << (2 - bit)) | (lo >> (126 + bit));
+        fraction = (fraction << 1) | bit;
+    }
+
+    return (fix_t) (((udqword) (dqword) (msb - FIX_FRACTION_BITS) << FIX_FRACTION_BITS) + fraction);
+}
+
+fix_t fix_exp2(fix_t a) {
+    // a = integer + fraction with the fraction in [0, 1)
+    qword const   integer  = (qword) (a >> FIX_FRACTION_BITS);
+    udqword const fraction = (udqword) a & ((udqword) FIX_ONE - 1u);
+    // 2^fraction in [1, 2) as 1.127 fixed point
+    udqword       power    = (udqword) 1 << 127;
+
+    for (ubyte k = 1; k <= FIX_FRACTION_BITS; k++)
+        if ((fraction >> (FIX_FRACTION_BITS - k)) & 1u) {
+            udqword const root = ((udqword) FIX_EXP2_ROOTS[k - 1][0] << 64) | FIX_EXP2_ROOTS[k - 1][1];
+            udqword       hi, lo;
+            bool    overflow;
+            fix_umul256(power, root, &hi, &lo);
+            // the product is below 2, so it cannot round out of 1.127
+            power = fix_shift_round(hi, lo, 127, FIX_ROUND_NEAREST_EVEN, false, &overflow);
+        }
+
+    if (integer <= -128)
+        return 0;
+
+    // result = power * 2^(integer + n - 127)
+    qword const shift = 127 - FIX_FRACTION_BITS - integer;
+    bool        overflow = false;
+
+    if (shift <= 0)
+        return FIX_MAX;
+    if (shift > 128)
+        return 0;
+    if (shift == 128)
+        return power > (udqword) 1 << 127;
+    return fix_signed(fix_shift_round(0, power, (ubyte) shift, FIX_ROUND_NEAREST_EVEN, false, &overflow), false,
+                      overflow, true);
+}
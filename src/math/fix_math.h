@@ -0,0 +1,255 @@
+/*
+ * Module: fix_math
+ * File: fix_math.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Signed binary fixed point in a 128 bit word. The default layout, Q(127 - FIX_FRACTION_BITS).FIX_FRACTION_BITS, is
+ * 64.64; the *_q variants take the fraction bits (the shift) explicitly so that mixed layouts, such as a 64.64 value
+ * multiplied by an integer, share the same exact integer core. Every operation is computed exactly in 256 bits and
+ * rounded once in the requested mode.
+ */
+
+#ifndef PROJECT_AQUINAS_FIX_MATH_H
+#define PROJECT_AQUINAS_FIX_MATH_H
+
+#include <stdbool.h>
+#include <platform.h>
+#include "state.h"
+
+/*
+ * Number of fraction bits of fix_t. Defaults to 64.64.
+ */
+#ifndef FIX_FRACTION_BITS
+  #define FIX_FRACTION_BITS 64
+#endif
+
+#if FIX_FRACTION_BITS < 1 || FIX_FRACTION_BITS > 126
+  #error "[build][fatal][fix_math] FIX_FRACTION_BITS must be in [1, 126]"
+#endif
+
+typedef dqword fix_t;
+
+#define FIX_ONE ((fix_t) 1 << FIX_FRACTION_BITS)
+#define FIX_MAX ((fix_t) (~(udqword) 0 >> 1))
+#define FIX_MIN (-FIX_MAX - 1)
+
+/*
+ * Direction in which a result which is not representable is rounded.
+ */
+enum fix_rounding {
+    // toward negative infinity
+    FIX_ROUND_DOWN,
+    // toward positive infinity
+    FIX_ROUND_UP,
+    FIX_ROUND_TOWARD_ZERO,
+    FIX_ROUND_NEAREST_EVEN,
+    FIX_ROUND_NEAREST_AWAY
+};
+
+/* INTERNAL */
+
+static inline __attribute__((const)) udqword fix_magnitude(fix_t a) {
+    return a < 0 ? ~(udqword) a + 1u : (udqword) a;
+}
+
+/*
+ * Decides whether a truncated magnitude is incremented. `half` compares the discarded part against one half of the
+ * last kept unit: negative below, zero equal, positive above.
+ */
+static inline __attribute__((const)) bool fix_round_increment(enum fix_rounding mode, bool negative, bool odd,
+                                                              sbyte half, bool inexact) {
+    switch (mode) {
+        case FIX_ROUND_DOWN:
+            return negative & inexact;
+        case FIX_ROUND_UP:
+            return !negative & inexact;
+        case FIX_ROUND_TOWARD_ZERO:
+            return false;
+        case FIX_ROUND_NEAREST_EVEN:
+            return half > 0 || (half == 0 && odd);
+        default:
+            return half >= 0;
+    }
+}
+
+/*
+ * Applies the sign to a magnitude; out of range magnitudes either saturate or wrap.
+ */
+static inline __attribute__((const)) fix_t fix_signed(udqword magnitude, bool negative, bool overflow, bool saturate) {
+    if (saturate && (overflow || magnitude > (udqword) FIX_MAX + negative))
+        return negative ? FIX_MIN : FIX_MAX;
+    return (fix_t) (negative ? ~magnitude + 1u : magnitude);
+}
+
+/*
+ * Exact 128 x 128 -> 256 bit unsigned product.
+ */
+static inline void fix_umul256(udqword a, udqword b, udqword *hi, udqword *lo) {
+    udqword const a0 = (uqword) a, a1 = a >> 64;
+    udqword const b0 = (uqword) b, b1 = b >> 64;
+    udqword const p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    // sum of the middle column: at most three 64 bit values
+    udqword const middle = (p00 >> 64) + (uqword) p01 + (uqword) p10;
+
+    *lo = (middle << 64) | (uqword) p00;
+    *hi = p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64);
+}
+
+/*
+ * Shifts the 256 bit magnitude hi:lo right by `shift` in [0, 127] and rounds.
+ */
+static inline udqword fix_shift_round(udqword hi, udqword lo, ubyte shift, enum fix_rounding mode, bool negative,
+                                      bool *overflow) {
+    if (shift == 0) {
+        *overflow = hi != 0;
+        return lo;
+    }
+
+    udqword const half      = (udqword) 1 << (shift - 1);
+    udqword const remainder = lo & ((half << 1) - 1u);
+    udqword       quotient  = (hi << (128 - shift)) | (lo >> shift);
+    sbyte const   compare   = (sbyte) ((remainder > half) - (remainder < half));
+
+    *overflow = (hi >> shift) != 0;
+    if (fix_round_increment(mode, negative, quotient & 1u, compare, remainder != 0))
+        *overflow |= ++quotient == 0;
+    return quotient;
+}
+
+/* CONVERSION */
+
+static inline __attribute__((const)) fix_t fix_from_int(qword a) {
+    return (fix_t) ((udqword) (dqword) a << FIX_FRACTION_BITS);
+}
+
+/*
+ * Builds a value from an integer part and the top bits of a 0.64 binary fraction.
+ */
+static inline __attribute__((const)) fix_t fix_from_parts(qword integer, uqword fraction) {
+    return fix_from_int(integer) + (fix_t) (((udqword) fraction << 64) >> (128 - FIX_FRACTION_BITS));
+}
+
+/*
+ * Rounds to an integral fix_t in the given mode.
+ */
+static inline __attribute__((const)) fix_t fix_round(fix_t a, enum fix_rounding mode) {
+    bool const    negative = a < 0;
+    udqword const raw      = fix_magnitude(a);
+    bool          overflow;
+    udqword const integer  = fix_shift_round(0, raw, FIX_FRACTION_BITS, mode, negative, &overflow);
+    return fix_signed(integer << FIX_FRACTION_BITS, negative, integer >> (127 - FIX_FRACTION_BITS), true);
+}
+
+/*
+ * Converts to an integer in the given mode; out of range values saturate.
+ */
+static inline __attribute__((const)) qword fix_to_int(fix_t a, enum fix_rounding mode) {
+    bool const    negative = a < 0;
+    bool          overflow;
+    udqword const integer  = fix_shift_round(0, fix_magnitude(a), FIX_FRACTION_BITS, mode, negative, &overflow);
+
+    if (integer > (udqword) INT64_MAX + negative)
+        return negative ? INT64_MIN : INT64_MAX;
+    return negative ? (qword) (~(uqword) integer + 1u) : (qword) integer;
+}
+
+/*
+ * Converts to the nearest machine double; intended for display, not computation.
+ */
+static inline __attribute__((const)) double fix_to_double(fix_t a) {
+    return (double) a / (double) FIX_ONE;
+}
+
+/* ARITHMETIC */
+
+static inline __attribute__((hot, const)) fix_t fix_add(fix_t a, fix_t b) {
+    return (fix_t) ((udqword) a + (udqword) b);
+}
+
+static inline __attribute__((hot, const)) fix_t fix_sub(fix_t a, fix_t b) {
+    return (fix_t) ((udqword) a - (udqword) b);
+}
+
+static inline __attribute__((hot, const)) fix_t fix_add_sat(fix_t a, fix_t b) {
+    fix_t result;
+    if (__builtin_add_overflow(a, b, &result))
+        return b < 0 ? FIX_MIN : FIX_MAX;
+    return result;
+}
+
+static inline __attribute__((hot, const)) fix_t fix_sub_sat(fix_t a, fix_t b) {
+    fix_t result;
+    if (__builtin_sub_overflow(a, b, &result))
+        return b < 0 ? FIX_MAX : FIX_MIN;
+    return result;
+}
+
+/*
+ * Returns (a * b) >> shift rounded in the given mode, where shift is in [0, 127]. Overflow wraps unless `saturate`.
+ */
+static inline __attribute__((hot, const)) fix_t fix_mul_q(fix_t a, fix_t b, ubyte shift, enum fix_rounding mode,
+                                                           bool saturate) {
+    bool const negative = (a < 0) ^ (b < 0);
+    udqword    hi, lo;
+    bool       overflow;
+
+    fix_umul256(fix_magnitude(a), fix_magnitude(b), &hi, &lo);
+    udqword const magnitude = fix_shift_round(hi, lo, shift, mode, negative, &overflow);
+    return fix_signed(magnitude, negative, overflow, saturate);
+}
+
+static inline __attribute__((hot, const)) fix_t fix_mul(fix_t a, fix_t b) {
+    return fix_mul_q(a, b, FIX_FRACTION_BITS, FIX_ROUND_NEAREST_EVEN, false);
+}
+
+static inline __attribute__((hot, const)) fix_t fix_mul_sat(fix_t a, fix_t b) {
+    return fix_mul_q(a, b, FIX_FRACTION_BITS, FIX_ROUND_NEAREST_EVEN, true);
+}
+
+/*
+ * Returns (a << shift) / b rounded in the given mode, where shift is in [0, 127]. Overflow wraps unless `saturate`;
+ * division by zero is fatal unless `saturate`, in which case it returns the extreme of the dividend's sign (0 / 0 is 0).
+ */
+fix_t fix_div_q(fix_t a, fix_t b, ubyte shift, enum fix_rounding mode, bool saturate);
+
+static inline fix_t fix_div(fix_t a, fix_t b) {
+    return fix_div_q(a, b, FIX_FRACTION_BITS, FIX_ROUND_NEAREST_EVEN, false);
+}
+
+static inline fix_t fix_div_sat(fix_t a, fix_t b) {
+    return fix_div_q(a, b, FIX_FRACTION_BITS, FIX_ROUND_NEAREST_EVEN, true);
+}
+
+/* FUNCTIONS */
+
+/*
+ * Square root rounded toward zero; fatal for negative values.
+ */
+fix_t fix_sqrt(fix_t a);
+
+/*
+ * Base 2 logarithm rounded toward negative infinity, accurate to within one unit in the last place; fatal for values
+ * which are not positive.
+ */
+fix_t fix_log2(fix_t a);
+
+/*
+ * Base 2 exponential with a relative error below 2^-122 (within one unit in the last place for results below 2^60 at
+ * the default layout); saturates to FIX_MAX on overflow and underflows to 0.
+ */
+fix_t fix_exp2(fix_t a);
+
+/*
+ * Linearly interpolates between lower (t = 0) and upper (t = FIX_ONE).
+ */
+static inline __attribute__((hot, const)) fix_t fix_lerp(fix_t lower, fix_t upper, fix_t t) {
+    return fix_add(lower, fix_mul(fix_sub(upper, lower), t));
+}
+
+#endif //PROJECT_AQUINAS_FIX_MATH_H
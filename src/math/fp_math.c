@@ -8,7 +8,292 @@
  * Copyright &copy; 2021 Christi Crucifixi, LLC. All rights reserved.
  *
  * License: See LICENSE.txt
+ *
+ * Software floating point engine. Every value is unpacked into (sign, exponent, significand) such that
+ * value = (-1)^sign * significand * 2^exponent, the operation is computed exactly (or with a sticky bit) in 128 bits,
+ * and the result is rounded once by fp_pack.
  */
 
 
 #include "fp_math.h"
+
+enum fp_class {
+    FP_ZERO,
+    FP_FINITE,
+    FP_INFINITE,
+    FP_NAN
+};
+
+typedef struct fp_unpacked {
+    enum fp_class class;
+    bool          sign;
+    qword         exponent;
+    uqword        significand;
+} fp_unpacked;
+
+static inline uqword fp_mask(uqword bits) {
+    return bits >= 64 ? ~0ull : (1ull << bits) - 1u;
+}
+
+static inline qword fp_bias(fp_format format) {
+    return ((qword) 1 << (format.exponent_bits - 1)) - 1;
+}
+
+static inline qword fp_exponent_max(fp_format format) {
+    return ((qword) 1 << format.exponent_bits) - 1;
+}
+
+static inline uqword fp_sign_bit(fp_format format) {
+    return 1ull << (format.mantissa_bits + format.exponent_bits);
+}
+
+static inline uqword fp_infinity(fp_format format, bool sign) {
+    return (sign ? fp_sign_bit(format) : 0) | ((uqword) fp_exponent_max(format) << format.mantissa_bits);
+}
+
+static inline uqword fp_nan(fp_format format) {
+    return fp_infinity(format, false) | (1ull << (format.mantissa_bits - 1u));
+}
+
+/*
+ * Number of significant bits in a udqword.
+ */
+static inline qword fp_sigbits(udqword value) {
+    uqword hi = (uqword) (value >> 64);
+    if (hi)
+        return 128 - __builtin_clzll(hi);
+    return value ? 64 - __builtin_clzll((uqword) value) : 0;
+}
+
+/*
+ * Shifts right by `bits`, or-ing every discarded bit into the least significant bit.
+ */
+static inline udqword fp_shift_sticky(udqword value, uqword bits) {
+    if (bits == 0)
+        return value;
+    if (bits >= 128)
+        return value != 0;
+    return (value >> bits) | ((value & (((udqword) 1 << bits) - 1u)) != 0);
+}
+
+/*
+ * Shifts right by `bits` and rounds to nearest, ties to even.
+ */
+static inline uqword fp_shift_round(udqword value, qword bits) {
+    if (bits > 128)
+        return 0;
+    if (bits == 128)
+        return value > ((udqword) 1 << 127);
+    udqword const half      = (udqword) 1 << (bits - 1);
+    udqword const remainder = value & ((half << 1) - 1u);
+    udqword       quotient  = value >> bits;
+    quotient += (remainder > half) | ((remainder == half) & (quotient & 1u));
+    return (uqword) quotient;
+}
+
+static fp_unpacked fp_unpack(fp_format format, uqword bits) {
+    uqword const m        = format.mantissa_bits;
+    uqword const fraction = bits & fp_mask(m);
+    qword const  biased   = (qword) ((bits >> m) & fp_mask(format.exponent_bits));
+    fp_unpacked  result   = {.sign = (bits & fp_sign_bit(format)) != 0};
+
+    if (biased == fp_exponent_max(format)) {
+        result.class = fraction ? FP_NAN : FP_INFINITE;
+        result.significand = fraction;
+    } else if (biased == 0) {
+        result.class = fraction ? FP_FINITE : FP_ZERO;
+        result.exponent = 1 - fp_bias(format) - (qword) m;
+        result.significand = fraction;
+    } else {
+        result.class = FP_FINITE;
+        result.exponent = biased - fp_bias(format) - (qword) m;
+        result.significand = fraction | (1ull << m);
+    }
+    return result;
+}
+
+/*
+ * Rounds (-1)^sign * significand * 2^exponent into the given format.
+ */
+static uqword fp_pack(fp_format format, bool sign, qword exponent, udqword significand) {
+    uqword const m         = format.mantissa_bits;
+    qword const  bias      = fp_bias(format);
+    uqword const sign_bits = sign ? fp_sign_bit(format) : 0;
+
+    if (!significand)
+        return sign_bits;
+
+    qword const length = fp_sigbits(significand);
+    qword       biased = exponent + length - 1 + bias;
+    // number of low bits which do not fit in the result: normals keep m + 1 bits, subnormals keep everything at or
+    // above the smallest subnormal's exponent
+    qword const drop   = biased > 0 ? length - (qword) (m + 1u) : (1 - bias - (qword) m) - exponent;
+    uqword fraction = drop <= 0 ? (uqword) (significand << -drop) : fp_shift_round(significand, drop);
+
+    if (biased > 0) {
+        // rounding carried out of the significand
+        if (fraction >> (m + 1u)) {
+            fraction >>= 1u;
+            biased++;
+        }
+        if (biased >= fp_exponent_max(format))
+            return fp_infinity(format, sign);
+    } else
+        // a subnormal which rounded up into the normal range gains the hidden bit
+        biased = (qword) (fraction >> m);
+
+    return sign_bits | ((uqword) biased << m) | (fraction & fp_mask(m));
+}
+
+static inline uqword fp_propagate_nan(fp_format format, uqword a, fp_unpacked ua, uqword b) {
+    return (ua.class == FP_NAN ? a : b) | (1ull << (format.mantissa_bits - 1u));
+}
+
+uqword fp_soft_add(fp_format format, uqword a, uqword b) {
+    fp_unpacked x = fp_unpack(format, a);
+    fp_unpacked y = fp_unpack(format, b);
+
+    if (x.class == FP_NAN || y.class == FP_NAN)
+        return fp_propagate_nan(format, a, x, b);
+    if (x.class == FP_INFINITE)
+        return y.class == FP_INFINITE && x.sign != y.sign ? fp_nan(format) : a;
+    if (y.class == FP_INFINITE)
+        return b;
+    if (x.class == FP_ZERO)
+        return y.class == FP_ZERO ? fp_pack(format, x.sign & y.sign, 0, 0) : b;
+    if (y.class == FP_ZERO)
+        return a;
+
+    if (x.exponent < y.exponent) {
+        fp_unpacked z = x;
+        x = y;
+        y = z;
+    }
+
+    // shift the larger operand up by at most 64 bits (exact), then the smaller one down with a sticky bit; past 64
+    // bits of separation the smaller operand can only ever affect rounding
+    uqword  distance      = (uqword) (x.exponent - y.exponent);
+    uqword  shift         = distance > 64 ? 64 : distance;
+    udqword significand_x = (udqword) x.significand << shift;
+    udqword significand_y = fp_shift_sticky(y.significand, distance - shift);
+    qword   exponent      = x.exponent - (qword) shift;
+
+    if (x.sign == y.sign)
+        return fp_pack(format, x.sign, exponent, significand_x + significand_y);
+    if (significand_x == significand_y)
+        return fp_pack(format, false, 0, 0);
+    if (significand_x > significand_y)
+        return fp_pack(format, x.sign, exponent, significand_x - significand_y);
+    return fp_pack(format, y.sign, exponent, significand_y - significand_x);
+}
+
+uqword fp_soft_sub(fp_format format, uqword a, uqword b) {
+    fp_unpacked y = fp_unpack(format, b);
+    // NaN operands keep their sign
+    return fp_soft_add(format, a, y.class == FP_NAN ? b : b ^ fp_sign_bit(format));
+}
+
+uqword fp_soft_mul(fp_format format, uqword a, uqword b) {
+    fp_unpacked x    = fp_unpack(format, a);
+    fp_unpacked y    = fp_unpack(format, b);
+    bool        sign = x.sign ^ y.sign;
+
+    if (x.class == FP_NAN || y.class == FP_NAN)
+        return fp_propagate_nan(format, a, x, b);
+    if (x.class == FP_INFINITE || y.class == FP_INFINITE)
+        return x.class == FP_ZERO || y.class == FP_ZERO ? fp_nan(format) : fp_infinity(format, sign);
+    if (x.class == FP_ZERO || y.class == FP_ZERO)
+        return fp_pack(format, sign, 0, 0);
+
+    // (m + 1) * 2 <= 124 bits: the product is exact
+    return fp_pack(format, sign, x.exponent + y.exponent, (udqword) x.significand * y.significand);
+}
+
+uqword fp_soft_div(fp_format format, uqword a, uqword b) {
+    fp_unpacked x    = fp_unpack(format, a);
+    fp_unpacked y    = fp_unpack(format, b);
+    bool        sign = x.sign ^ y.sign;
+
+    if (x.class == FP_NAN || y.class == FP_NAN)
+        return fp_propagate_nan(format, a, x, b);
+    if (x.class == FP_INFINITE)
+        return y.class == FP_INFINITE ? fp_nan(format) : fp_infinity(format, sign);
+    if (y.class == FP_INFINITE)
+        return fp_pack(format, sign, 0, 0);
+    if (y.class == FP_ZERO)
+        return x.class == FP_ZERO ? fp_nan(format) : fp_infinity(format, sign);
+    if (x.class == FP_ZERO)
+        return fp_pack(format, sign, 0, 0);
+
+    // normalize both significands to [2^63, 2^64) so the quotient carries at least 64 significant bits
+    qword const normalize_x = 64 - fp_sigbits(x.significand);
+    qword const normalize_y = 64 - fp_sigbits(y.significand);
+    udqword     dividend    = (udqword) (x.significand << normalize_x) << 64;
+    uqword      divisor     = y.significand << normalize_y;
+    udqword     quotient    = dividend / divisor;
+    quotient |= (dividend % divisor) != 0;
+
+    return fp_pack(format, sign, (x.exponent - normalize_x) - (y.exponent - normalize_y) - 64, quotient);
+}
+
+/*
+ * Maps a bit pattern onto a signed integer which orders the same way as the value (both zeroes map to 0).
+ */
+static inline qword fp_ordinal(fp_format format, uqword a) {
+    qword magnitude = (qword) (a & (fp_sign_bit(format) - 1u));
+    return a & fp_sign_bit(format) ? -magnitude : magnitude;
+}
+
+bool fp_soft_lt(fp_format format, uqword a, uqword b) {
+    if (fp_unpack(format, a).class == FP_NAN || fp_unpack(format, b).class == FP_NAN)
+        return false;
+    return fp_ordinal(format, a) < fp_ordinal(format, b);
+}
+
+bool fp_soft_eq(fp_format format, uqword a, uqword b) {
+    if (fp_unpack(format, a).class == FP_NAN || fp_unpack(format, b).class == FP_NAN)
+        return false;
+    return fp_ordinal(format, a) == fp_ordinal(format, b);
+}
+
+uqword fp_soft_from_qword(fp_format format, qword a) {
+    uqword magnitude = a < 0 ? ~((uqword) a) + 1u : (uqword) a;
+    return fp_pack(format, a < 0, 0, magnitude);
+}
+
+qword fp_soft_to_qword(fp_format format, uqword a) {
+    fp_unpacked x = fp_unpack(format, a);
+    uqword      magnitude;
+
+    switch (x.class) {
+        case FP_NAN:
+        case FP_ZERO:
+            return 0;
+        case FP_INFINITE:
+            return x.sign ? INT64_MIN : INT64_MAX;
+        default:
+            break;
+    }
+
+    if (x.exponent >= 0) {
+        if (x.exponent >= 64 || (x.significand >> (63 - x.exponent)))
+            return x.sign ? INT64_MIN : INT64_MAX;
+        magnitude = x.significand << x.exponent;
+    } else
+        magnitude = x.exponent <= -64 ? 0 : x.significand >> -x.exponent;
+
+    return x.sign ? -(qword) magnitude : (qword) magnitude;
+}
+
+uqword fp_soft_convert(fp_format to, fp_format from, uqword a) {
+    fp_unpacked x = fp_unpack(from, a);
+
+    switch (x.class) {
+        case FP_NAN:
+            return fp_nan(to) | (x.sign ? fp_sign_bit(to) : 0);
+        case FP_INFINITE:
+            return fp_infinity(to, x.sign);
+        default:
+            return fp_pack(to, x.sign, x.exponent, x.significand);
+    }
+}
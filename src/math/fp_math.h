@@ -8,6 +8,11 @@
  * Copyright &copy; 2021 Christi Crucifixi, LLC. All rights reserved.
  *
  * License: See LICENSE.txt
+ *
+ * Configurable-precision floating point. The layout of fp_float is set at build time by FP_MANTISSA_BITS and
+ * FP_EXPONENT_BITS; when the layout is bit-identical to an IEEE 754 interchange format that the machine implements,
+ * every operation is dispatched to the hardware, otherwise the software engine in fp_math.c is used. The software
+ * engine rounds to nearest, ties to even, and supports subnormals, infinities and NaNs for every layout.
  */
 
 
@@ -15,35 +20,216 @@
 #ifndef PROJECT_AQUINAS_FP_MATH_H
   #define PROJECT_AQUINAS_FP_MATH_H
 
+#include <stdbool.h>
+
 typedef float       machine_float;
 typedef double      machine_double;
 typedef long double machine_long_double;
 
-  #ifndef FP_INTERNAL_FLOAT_DATATYPE
-    #define FP_INTERNAL_FLOAT_DATATYPE uqword
+/*
+ * Number of explicitly stored significand bits (the hidden bit is not counted). Defaults to IEEE 754 binary64.
+ */
+  #ifndef FP_MANTISSA_BITS
+    #define FP_MANTISSA_BITS 52
   #endif
 
-  #ifndef FP_MANTISSA_BITS
-    #define FP_MANTISSA_BITS
+/*
+ * Number of biased exponent bits. Defaults to IEEE 754 binary64.
+ */
+  #ifndef FP_EXPONENT_BITS
+    #define FP_EXPONENT_BITS 11
+  #endif
+
+  #if FP_EXPONENT_BITS < 2 || FP_EXPONENT_BITS > 30
+    #error "[build][fatal][fp_math] FP_EXPONENT_BITS must be in [2, 30]"
+  #endif
+
+  #if FP_MANTISSA_BITS < 1 || FP_MANTISSA_BITS + FP_EXPONENT_BITS + 1 > 64
+    #error "[build][fatal][fp_math] fp_float layout must fit in 64 bits with at least one mantissa bit"
+  #endif
+
+/*
+ * Storage type of fp_float; defaults to the smallest word which holds the configured layout.
+ */
+  #ifndef FP_INTERNAL_FLOAT_DATATYPE
+    #if FP_MANTISSA_BITS + FP_EXPONENT_BITS + 1 <= 32
+      #define FP_INTERNAL_FLOAT_DATATYPE udword
+    #else
+      #define FP_INTERNAL_FLOAT_DATATYPE uqword
+    #endif
   #endif
 
+/*
+ * Permits dispatching to the floating point unit when the configured layout matches IEEE 754 binary32 or binary64.
+ * Define as 0 to force the software engine (useful for testing it against the hardware).
+ */
   #ifndef FP_USE_IEEE754
-    #define FP_USE_IEEE754 24
+    #define FP_USE_IEEE754 1
   #endif
 
+  #if FP_USE_IEEE754 && ARCH_BYTE_ORDER == BYTE_ORDER_LO_TO_HI
+    #if FP_MANTISSA_BITS == 23 && FP_EXPONENT_BITS == 8
+      #define FP_HARDWARE_DATATYPE machine_float
+    #elif FP_MANTISSA_BITS == 52 && FP_EXPONENT_BITS == 11
+      #define FP_HARDWARE_DATATYPE machine_double
+    #endif
+  #endif
+
+/*
+ * A floating point layout given at runtime; used by the software engine so that a single implementation serves every
+ * layout (including conversions between layouts).
+ */
+typedef struct fp_format {
+    ubyte mantissa_bits;
+    ubyte exponent_bits;
+} fp_format;
+
+#define FP_FORMAT          ((fp_format) {.mantissa_bits = FP_MANTISSA_BITS, .exponent_bits = FP_EXPONENT_BITS})
+#define FP_FORMAT_BINARY32 ((fp_format) {.mantissa_bits = 23, .exponent_bits = 8})
+#define FP_FORMAT_BINARY64 ((fp_format) {.mantissa_bits = 52, .exponent_bits = 11})
+
+/*
+ * A floating point value in the configured layout. Fields are ordered from the least significant bit.
+ */
 typedef union fp_float {
+    struct {
+        FP_INTERNAL_FLOAT_DATATYPE significand: FP_MANTISSA_BITS;
+        FP_INTERNAL_FLOAT_DATATYPE exponent: FP_EXPONENT_BITS;
+        FP_INTERNAL_FLOAT_DATATYPE sign: 1;
+    };
+    FP_INTERNAL_FLOAT_DATATYPE value;
+  #ifdef FP_HARDWARE_DATATYPE
+    FP_HARDWARE_DATATYPE hardware;
+  #endif
 } fp_float;
 
-typedef struct fp_double {
-} fp_double;
+/* software engine (fp_math.c); operands and results are raw bit patterns of the given format */
+
+uqword fp_soft_add(fp_format format, uqword a, uqword b);
 
-typedef struct fp_long_double {
-} fp_long_double;
+uqword fp_soft_sub(fp_format format, uqword a, uqword b);
 
-typedef union fp_rational {
-} fp_rational;
+uqword fp_soft_mul(fp_format format, uqword a, uqword b);
 
-static fp_float fp_add(fp_float a, fp_float b) {
+uqword fp_soft_div(fp_format format, uqword a, uqword b);
+
+/*
+ * Returns a < b; false if either operand is NaN.
+ */
+bool fp_soft_lt(fp_format format, uqword a, uqword b);
+
+/*
+ * Returns a == b; +0 equals -0 and NaN equals nothing.
+ */
+bool fp_soft_eq(fp_format format, uqword a, uqword b);
+
+uqword fp_soft_from_qword(fp_format format, qword a);
+
+/*
+ * Truncates toward zero. Out of range values saturate; NaN converts to 0.
+ */
+qword fp_soft_to_qword(fp_format format, uqword a);
+
+/*
+ * Converts the bit pattern `a` of format `from` into format `to` with a single rounding.
+ */
+uqword fp_soft_convert(fp_format to, fp_format from, uqword a);
+
+/* configured layout */
+
+#define fp_raw(bits) ((fp_float) {.value = (FP_INTERNAL_FLOAT_DATATYPE) (bits)})
+
+  #ifdef FP_HARDWARE_DATATYPE
+    #define fp_hw(expression) ({ fp_float fp_hw_result = {.value = 0}; fp_hw_result.hardware = (expression); fp_hw_result; })
+  #endif
+
+static inline fp_float fp_add(fp_float a, fp_float b) {
+  #ifdef FP_HARDWARE_DATATYPE
+    return fp_hw(a.hardware + b.hardware);
+  #else
+    return fp_raw(fp_soft_add(FP_FORMAT, a.value, b.value));
+  #endif
+}
+
+static inline fp_float fp_sub(fp_float a, fp_float b) {
+  #ifdef FP_HARDWARE_DATATYPE
+    return fp_hw(a.hardware - b.hardware);
+  #else
+    return fp_raw(fp_soft_sub(FP_FORMAT, a.value, b.value));
+  #endif
+}
+
+static inline fp_float fp_mul(fp_float a, fp_float b) {
+  #ifdef FP_HARDWARE_DATATYPE
+    return fp_hw(a.hardware * b.hardware);
+  #else
+    return fp_raw(fp_soft_mul(FP_FORMAT, a.value, b.value));
+  #endif
+}
+
+static inline fp_float fp_div(fp_float a, fp_float b) {
+  #ifdef FP_HARDWARE_DATATYPE
+    return fp_hw(a.hardware / b.hardware);
+  #else
+    return fp_raw(fp_soft_div(FP_FORMAT, a.value, b.value));
+  #endif
+}
+
+static inline fp_float fp_neg(fp_float a) {
+    a.sign ^= 1u;
+    return a;
+}
+
+static inline fp_float fp_abs(fp_float a) {
+    a.sign = 0;
+    return a;
+}
+
+static inline bool fp_lt(fp_float a, fp_float b) {
+  #ifdef FP_HARDWARE_DATATYPE
+    return a.hardware < b.hardware;
+  #else
+    return fp_soft_lt(FP_FORMAT, a.value, b.value);
+  #endif
+}
+
+static inline bool fp_eq(fp_float a, fp_float b) {
+  #ifdef FP_HARDWARE_DATATYPE
+    return a.hardware == b.hardware;
+  #else
+    return fp_soft_eq(FP_FORMAT, a.value, b.value);
+  #endif
+}
+
+static inline fp_float fp_from_qword(qword a) {
+  #ifdef FP_HARDWARE_DATATYPE
+    return fp_hw((FP_HARDWARE_DATATYPE) a);
+  #else
+    return fp_raw(fp_soft_from_qword(FP_FORMAT, a));
+  #endif
+}
+
+static inline qword fp_to_qword(fp_float a) {
+    // the hardware conversion is undefined for out of range values, so both paths share the saturating engine
+    return fp_soft_to_qword(FP_FORMAT, a.value);
+}
+
+static inline fp_float fp_from_double(machine_double a) {
+  #ifdef FP_HARDWARE_DATATYPE
+    return fp_hw((FP_HARDWARE_DATATYPE) a);
+  #else
+    union { machine_double value; uqword bits; } binary64 = {.value = a};
+    return fp_raw(fp_soft_convert(FP_FORMAT, FP_FORMAT_BINARY64, binary64.bits));
+  #endif
+}
+
+static inline machine_double fp_to_double(fp_float a) {
+  #ifdef FP_HARDWARE_DATATYPE
+    return (machine_double) a.hardware;
+  #else
+    union { machine_double value; uqword bits; } binary64 = {.bits = fp_soft_convert(FP_FORMAT_BINARY64, FP_FORMAT, a.value)};
+    return binary64.value;
+  #endif
 }
 
 #endif //PROJECT_AQUINAS_FP_MATH_H
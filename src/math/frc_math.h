@@ -13,6 +13,7 @@
 
 #include "platform.h"
 #include "asm.h"
+#include "state.h"
 
 typedef union decimal {
     struct {
@@ -28,31 +29,69 @@ typedef union decimal {
     uqword value;
 } frac_t;
 
+// bit fields are ordered from the least significant bit
 typedef union ieee_float32 {
     struct {
-        uint32_t sign: 1;
-        uint32_t exponent: 8;
         uint32_t significand: 23;
+        uint32_t exponent: 8;
+        uint32_t sign: 1;
     };
+    uint32_t bits;
     float value;
 } ieee_float32;
 
 typedef union ieee_float64 {
     struct {
-        uint64_t sign: 1;
-        uint64_t exponent: 11;
         uint64_t significand: 52;
+        uint64_t exponent: 11;
+        uint64_t sign: 1;
     };
+    uint64_t bits;
     double value;
 } ieee_float64;
 
+/*
+ * Size of a buffer sufficient for frc_print_flt and frc_print_dbl, including the null terminator.
+ */
+#define FRC_PRINT_BUFFER_SIZE 32
+
+/*
+ * Parses a decimal floating point literal from [first, last) into the nearest double (ties to even), using the
+ * Eisel-Lemire algorithm. Accepts an optional sign, digits with an optional decimal point, an optional exponent
+ * (e or E), as well as inf, infinity and nan (case insensitive).
+ *
+ * Returns a pointer past the last consumed character, or `first` if no literal could be parsed.
+ */
+char const *frc_parse_dbl(char const *first, char const *last, ieee_float64 *result);
+
+/*
+ * As frc_parse_dbl, rounding to the nearest float.
+ */
+char const *frc_parse_flt(char const *first, char const *last, ieee_float32 *result);
+
+/*
+ * Writes the shortest decimal literal which parses back to `value` (choosing the closest one when several are equally
+ * short) into `buffer`, which must hold at least FRC_PRINT_BUFFER_SIZE bytes. The output is null-terminated and uses
+ * positional notation for decimal exponents in [-6, 21), scientific notation otherwise.
+ *
+ * Returns the length of the output excluding the null terminator.
+ */
+uqword frc_print_dbl(ieee_float64 value, char *buffer);
+
+/*
+ * As frc_print_dbl for floats; the output is the shortest literal which parses back to the same float.
+ */
+uqword frc_print_flt(ieee_float32 value, char *buffer);
+
 
+#ifndef bitwidth
 #define bitwidth(Type) (sizeof(Type) * MIN_BITS)
+#endif
 #define truncate(value, bits) ( (value << (sizeof(typeof(value)) * MIN_BITS - bits)) >> (sizeof(typeof(value)) * MIN_BITS - bits) )
 static inline uqword frc_sigbits(register uqword bit_string) {
 #if defined(__GNUC__)
 #if DATA_MODEL == LLP64 || DATA_MODEL == ILP64 || DATA_MODEL == SILP64
-    r_info("LLP64 or ILP64 or SILP64");
+    r_debug_every(1u << 20, "LLP64 or ILP64 or SILP64\n");
     return bitwidth(typeof(bit_string)) - __builtin_clzll((bit_string | 1ull));
 #elif DATA_MODEL == LP64
     return bitwidth(typeof(bit_string)) - __builtin_clzll((bit_string | 1ul));
@@ -88,28 +127,11 @@ static inline uqword frc_sigbits(register uqword bit_string) {
 static inline uqword frc_bitmaskv(register uqword value, register uqword bit_count) {
     return truncate(~value, bit_count) ^ value;
 }
-static inline uqword frc_gcdi(register uqword a, register uqword b);
-static inline frac_t frc(register int32_t numerator, register int32_t denominator) {
-    #define max(a, b) ( (a) > (b) ? (a) : (b) )
-    frac_t fraction;
-    fraction.sign = numerator < 0;
-    fraction.divider = frc_sigbits(denominator);
-    register uqword r0 = frc_gcdi(numerator, denominator);
-    register uqword r1;
-    numerator = numerator / r0;
-    denominator = denominator / r0;
-    r0 = frc_sigbits(denominator);
-    r1 = frc_sigbits(numerator);
-
-    if ((r0 = (r0 + r1)) > 57) {
-        r0 = (r0 - 57) >> 1;
-        numerator >>= r0;
-        denominator >>= r0;
-    }
+static inline uqword frc_gcdi(uqword a, uqword b);
+static inline frac_t frc_pack(dqword numerator, udqword denominator);
 
-    fraction.significand = (numerator << fraction.divider) | denominator;
-    return fraction;
-    #undef max
+static inline frac_t frc(register int32_t numerator, register int32_t denominator) {
+    return denominator < 0 ? frc_pack(-(dqword) numerator, -(dqword) denominator) : frc_pack(numerator, denominator);
 }
 
 //static inline frac_t flt_to_frc(ieee_float32 a) {
@@ -124,12 +146,19 @@ static inline frac_t frc(register int32_t numerator, register int32_t denominato
 //static inline ieee_float64 frc_to_dbl(frac_t a) {
 //}
 
-static inline int32_t frc_rdnum(register frac_t a) {
-    return (-1 * a.sign) * (a.significand >> a.divider);
+/*
+ * Reads the signed numerator.
+ */
+static inline qword frc_rdnum(register frac_t a) {
+    register qword magnitude = (qword) (a.significand >> a.divider);
+    return a.sign ? -magnitude : magnitude;
 }
 
-static inline int32_t frc_rdden(register frac_t a) {
-    return (-1 * a.sign) * (a.significand & frc_bitmaskv(a.significand, 63 - a.divider));
+/*
+ * Reads the (always positive) denominator.
+ */
+static inline uqword frc_rdden(register frac_t a) {
+    return a.significand & ((1ull << a.divider) - 1u);
 }
 
 //static inline uqword frc_ctz10(register uqword a) {
@@ -137,66 +166,33 @@ static inline int32_t frc_rdden(register frac_t a) {
 //}
 
 static inline frac_t frc_add(register frac_t a, register frac_t b) {
-    register int32_t a_num = frc_rdnum(a);
-    register int32_t a_den = frc_rdden(a);
-    register int32_t b_num = frc_rdnum(b);
-    register qword   b_den = frc_rdden(b);
-    // normalize fractions
-    if (b_den != a_den) {
-        b_num = b_num * a_den;
-        a_num = a_num * b_den;
-    }
-
-    // add numerators
-    a_num = a_num + b_num;
-    a.divider = frc_sigbits((uqword) a_den);
-    a.significand = (a_num << a.divider) | a_den;
-    return a;
+    return frc_pack((dqword) frc_rdnum(a) * frc_rdden(b) + (dqword) frc_rdnum(b) * frc_rdden(a),
+                    (udqword) frc_rdden(a) * frc_rdden(b));
 }
 
 static inline frac_t frc_sub(register frac_t a, register frac_t b) {
-    register int32_t a_num = frc_rdnum(a);
-    register int32_t a_den = frc_rdden(a);
-    register int32_t b_num = frc_rdnum(b);
-    register int32_t b_den = frc_rdden(b);
-    // normalize fractions
-    if (b_den != a_den) {
-        b_num = b_num * a_den;
-        a_num = a_num * b_den;
-    }
-
-    // subtract numerators
-    a_num = a_num - b_num;
-    a.divider = frc_sigbits((uqword) a_den);
-    a.significand = (a_num << a.divider) | a_den;
-    return a;
+    return frc_pack((dqword) frc_rdnum(a) * frc_rdden(b) - (dqword) frc_rdnum(b) * frc_rdden(a),
+                    (udqword) frc_rdden(a) * frc_rdden(b));
 }
 
 static inline frac_t frc_mul(register frac_t a, register frac_t b) {
-    register int32_t a_num = frc_rdnum(a);
-    register int32_t a_den = frc_rdden(a);
-    register int32_t b_num = frc_rdnum(b);
-    register int32_t b_den = frc_rdden(b);
-    // multiply the fractions
-    a_num = a_num * b_num;
-    a_den = a_den * b_den;
-    a.divider = frc_sigbits((uqword) a_den);
-    a.significand = (a_num << a.divider) | a_den;
-    return a;
+    return frc_pack((dqword) frc_rdnum(a) * frc_rdnum(b), (udqword) frc_rdden(a) * frc_rdden(b));
 }
 
 static inline frac_t frc_div(register frac_t a, register frac_t b) {
-    register int32_t a_num = frc_rdnum(a);
-    register int32_t a_den = frc_rdden(a);
-    register int32_t b_num = frc_rdnum(b);
-    register int32_t b_den = frc_rdden(b);
-
-    // divide the fractions (via multiply)
-    a_num = a_num * b_den;
-    a_den = a_den * b_num;
-    a.divider = frc_sigbits((uqword) a_den);
-    a.significand = (a_num << a.divider) | a_den;
-    return a;
+    register qword const b_num = frc_rdnum(b);
+    // the divisor's numerator becomes the denominator, which carries no sign
+    register dqword const numerator = (dqword) frc_rdnum(a) * frc_rdden(b);
+    return frc_pack(b_num < 0 ? -numerator : numerator, (udqword) frc_rdden(a) * (uqword) (b_num < 0 ? -b_num : b_num));
+}
+
+/*
+ * Returns -1, 0 or 1 as a is less than, equal to or greater than b.
+ */
+static inline sbyte frc_cmp(register frac_t a, register frac_t b) {
+    register dqword const x = (dqword) frc_rdnum(a) * frc_rdden(b);
+    register dqword const y = (dqword) frc_rdnum(b) * frc_rdden(a);
+    return (sbyte) ((x > y) - (x < y));
 }
 
 static inline int32_t frc_absi(int32_t a) {
@@ -210,8 +206,13 @@ static inline frac_t frc_abs(register frac_t a) {
 
 #define max(a, b) ( (a) > (b) ? (a) : (b) )
 #define min(a, b) ( (a) < (b) ? (a) : (b) )
+// shared with bit_math.h
+#ifndef abs
 #define abs(a) ( (a) > 0 ? (a) : -(a) )
+#endif
+#ifndef abs_diff
 #define abs_diff(a, b) ( abs((a) - (b)) )
+#endif
 
 static inline uqword frc_log2i(register uqword a) {
     return frc_sigbits(a) - 1u;
@@ -225,35 +226,86 @@ static inline void frc_swap_max(register uqword *a, register uqword *b) {
 }
 
 static inline uqword frc_gcdi(uqword a, uqword b) {
-    // 11c
-    register uqword delta = min(frc_log2i(a), frc_log2i(b));
-    a >>= delta;
-    b >>= delta;
-    a >>= __x64_tzcnt(a);
-    b >>= __x64_tzcnt(b);
-    // 32 * (8) = 256c
-    while(b) {
-        frc_swap_max(&a, &b);
-        b = b - a;
-        b >>= __x64_tzcnt(b);
-    }
-    // 2c
-    return a << delta;
+    if (!a || !b)
+        return a | b;
+    // binary gcd: the common power of two, then subtract the smaller odd value from the larger
+    register uqword const shift = __builtin_ctzll(a | b);
+    a >>= __builtin_ctzll(a);
+    do {
+        b >>= __builtin_ctzll(b);
+        if (a > b)
+            frc_swap_max(&b, &a);
+        b -= a;
+    } while (b);
+    return a << shift;
 }
 
 static inline uqword frc_gcd(register frac_t a) {
-    return frc_gcdi(frc_rdnum(a), frc_rdden(a));
+    register qword const numerator = frc_rdnum(a);
+    return frc_gcdi((uqword) (numerator < 0 ? -numerator : numerator), frc_rdden(a));
+}
+
+static inline uqword frc_sigbitsq(register udqword a) {
+    return a >> 64 ? 64 + frc_sigbits((uqword) (a >> 64)) : a ? frc_sigbits((uqword) a) : 0;
+}
+
+/*
+ * Packs numerator / denominator in lowest terms. When the reduced terms still need more than the 57 available bits, the
+ * denominator is shifted right by about half the excess and the magnitude recomputed from it, rounded, so that both
+ * terms give up the same precision and a small denominator does not distort the value. A value too large for 56 bits
+ * saturates.
+ */
+static inline frac_t frc_pack(dqword numerator, udqword denominator) {
+    if (!denominator)
+        fatalf(__func__, "zero denominator\n");
+
+    frac_t  fraction  = {.value = 0};
+    udqword magnitude = numerator < 0 ? -(udqword) numerator : (udqword) numerator;
 
+    if (!magnitude)
+        denominator = 1;
+    // terms wider than 64 bits are narrowed before the (64 bit) reduction
+    register uqword shift = max(frc_sigbitsq(magnitude), frc_sigbitsq(denominator));
+    shift = shift > 64 ? shift - 64 : 0;
+    magnitude >>= shift;
+    denominator = max(denominator >> shift, 1u);
+
+    register uqword const gcd = frc_gcdi((uqword) magnitude, (uqword) denominator);
+    magnitude /= gcd;
+    denominator /= gcd;
+
+    shift = frc_sigbitsq(magnitude) + frc_sigbitsq(denominator);
+    if (shift > 57) {
+        // each step of the denominator's shift takes about a bit off both terms; both are below 2^64 here
+        register uqword const denominator_bits = frc_sigbitsq(denominator);
+        for (shift = (shift - 57 + 1) / 2;; shift++) {
+            if (shift >= denominator_bits)
+                shift = denominator_bits - 1;
+            udqword const narrowed = denominator >> shift;
+            udqword const rounded = (magnitude * narrowed + denominator / 2) / denominator;
+            if (frc_sigbitsq(rounded) + frc_sigbitsq(narrowed) <= 57 || narrowed == 1) {
+                magnitude = rounded;
+                denominator = narrowed;
+                break;
+            }
+        }
+        if (frc_sigbitsq(magnitude) + frc_sigbitsq(denominator) > 57)
+            magnitude = ((udqword) 1 << 56u) - 1;
+        if (!magnitude)
+            denominator = 1;
+    }
+
+    fraction.sign = numerator < 0 && magnitude;
+    fraction.divider = frc_sigbitsq(denominator);
+    fraction.significand = (uqword) ((magnitude << fraction.divider) | denominator);
+    return fraction;
 }
 
 /*
  * Simplifies the given value without loss of information.
  */
-//static inline frac_t frc_simplify(register frac_t a) {
-//    register uqword gcd = frc_gcd(a);
-//    register uint32_t numerator = frc_rdnum(a);
-//    register uint32_t denominator = frc_rdden(a);
-//
-//}
+static inline frac_t frc_simplify(register frac_t a) {
+    return frc_pack(frc_rdnum(a), frc_rdden(a));
+}
 
 #endif //CATHOLICUS_FRAC_MATH_H
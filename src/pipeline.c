@@ -0,0 +1,317 @@
+/*
+ * Module: pipeline
+ * File: pipeline.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include "state.h"
+#include "trace.h"
+#include "profile.h"
+#include "pipeline.h"
+
+// polls of an empty or full link before a waiting stage yields its core
+#define PIPELINE_SPINS 64
+
+static void pipeline_wait(udword *spins) {
+    if (++*spins >= PIPELINE_SPINS)
+        sched_yield();
+}
+
+pipeline *pipeline_create(udword stages, uqword batch_bytes, udword depth) {
+    // a batch must hold a length byte and at least one byte of a token
+    if (batch_bytes < 2)
+        fatalf(__func__, "batches of %llu bytes are too small\n", (unsigned long long) batch_bytes);
+    pipeline *pipe = calloc(1, sizeof(pipeline));
+    if (!pipe || !(pipe->stages = calloc(stages, sizeof(pipeline_stage))) ||
+        (stages > 1 && !(pipe->links = calloc(stages - 1, sizeof(pipeline_link)))))
+        fatalf(__func__, "failed to allocate a pipeline of %u stages\n", stages);
+    pipe->stage_count = stages;
+    if (depth == 0)
+        depth = 1;
+
+    for (udword i = 0; i + 1 < stages; i++) {
+        pipeline_link *link = &pipe->links[i];
+        link->full = spsc_create(depth);
+        link->empty = spsc_create(depth);
+        link->depth = depth;
+        atomic_init(&link->closed, false);
+        link->batches = calloc(depth, sizeof(pipeline_batch *));
+        if (!link->batches)
+            fatalf(__func__, "failed to allocate the batches of link %u\n", i);
+        for (udword j = 0; j < depth; j++) {
+            pipeline_batch *batch = malloc(sizeof(pipeline_batch) + batch_bytes);
+            if (!batch)
+                fatalf(__func__, "failed to allocate a batch of %llu bytes\n", (unsigned long long) batch_bytes);
+            batch->length = 0;
+            batch->capacity = batch_bytes;
+            link->batches[j] = batch;
+        }
+        spsc_enqueue(link->empty, (void *const *) link->batches, depth);
+    }
+    return pipe;
+}
+
+void pipeline_free(pipeline *pipe) {
+    if (!pipe)
+        return;
+    for (udword i = 0; i + 1 < pipe->stage_count; i++) {
+        pipeline_link *link = &pipe->links[i];
+        for (udword j = 0; j < link->depth; j++)
+            free(link->batches[j]);
+        free(link->batches);
+        spsc_free(link->full);
+        spsc_free(link->empty);
+    }
+    free(pipe->links);
+    free(pipe->stages);
+    free(pipe);
+}
+
+void pipeline_set_stage(pipeline *pipe, udword index, char const *name, pipeline_function function, void *state) {
+    pipe->stages[index] = (pipeline_stage) {name, function, state};
+}
+
+pipeline_batch *pipeline_acquire(pipeline_link *output) {
+    void  *batch;
+    udword spins = 0;
+    while (spsc_dequeue(output->empty, &batch, 1) == 0)
+        pipeline_wait(&spins);
+    ((pipeline_batch *) batch)->length = 0;
+    return batch;
+}
+
+void pipeline_send(pipeline_link *output, pipeline_batch *batch) {
+    // the ring holds every batch of the link, so there is always room
+    spsc_enqueue(output->full, (void *const *) &batch, 1);
+}
+
+pipeline_batch *pipeline_receive(pipeline_link *input) {
+    void  *batch;
+    udword spins = 0;
+    while (spsc_dequeue(input->full, &batch, 1) == 0) {
+        // the last batch is sent before the link is closed, so it is in the ring by now if it was sent at all
+        if (atomic_load_explicit(&input->closed, memory_order_acquire))
+            return spsc_dequeue(input->full, &batch, 1) != 0 ? batch : NULL;
+        pipeline_wait(&spins);
+    }
+    return batch;
+}
+
+void pipeline_release(pipeline_link *input, pipeline_batch *batch) {
+    spsc_enqueue(input->empty, (void *const *) &batch, 1);
+}
+
+typedef struct pipeline_thread {
+    pipeline *pipe;
+    udword    index;
+    pthread_t thread;
+} pipeline_thread;
+
+static void *pipeline_stage_main(void *argument) {
+    pipeline_thread *self = argument;
+    pipeline_stage  *stage = &self->pipe->stages[self->index];
+    pipeline_link   *input = self->index != 0 ? &self->pipe->links[self->index - 1] : NULL;
+    pipeline_link   *output = self->index + 1 < self->pipe->stage_count ? &self->pipe->links[self->index] : NULL;
+
+    profile_thread();
+    trace_thread_name(stage->name);
+    push_context((char *) stage->name);
+    stage->function(input, output, stage->state);
+    pop_context();
+    if (output)
+        atomic_store_explicit(&output->closed, true, memory_order_release);
+    return NULL;
+}
+
+void pipeline_run(pipeline *pipe) {
+    pipeline_thread *threads = calloc(pipe->stage_count, sizeof(pipeline_thread));
+    if (!threads)
+        fatalf(__func__, "failed to allocate %u stage threads\n", pipe->stage_count);
+
+    for (udword i = 0; i + 1 < pipe->stage_count; i++)
+        atomic_store(&pipe->links[i].closed, false);
+    for (udword i = 0; i < pipe->stage_count; i++) {
+        threads[i] = (pipeline_thread) {.pipe = pipe, .index = i};
+        if (pthread_create(&threads[i].thread, NULL, pipeline_stage_main, &threads[i]) != 0)
+            fatalf(__func__, "failed to start stage %s\n", pipe->stages[i].name);
+    }
+    for (udword i = 0; i < pipe->stage_count; i++)
+        pthread_join(threads[i].thread, NULL);
+    free(threads);
+}
+
+/* TEXT PIPELINE */
+
+typedef struct pipeline_text_state {
+    char const           *text;
+    uqword                length;
+    workload_text        *output;
+    context              *metrics;
+    pipeline_text_result *result;
+} pipeline_text_state;
+
+static bool pipeline_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+/*
+ * Cuts the text into batches which end after whitespace, so that no token spans two of them.
+ */
+static void pipeline_split(pipeline_link *input, pipeline_link *output, void *argument) {
+    (void) input;
+    pipeline_text_state const *state = argument;
+    for (uqword offset = 0; offset < state->length;) {
+        pipeline_batch *batch = pipeline_acquire(output);
+        uqword          length = state->length - offset;
+        if (length > batch->capacity) {
+            length = batch->capacity;
+            while (length > 1 && !pipeline_space(state->text[offset + length - 1]))
+                length--;
+            // no whitespace in the whole batch: the token is cut
+            if (length == 1 && !pipeline_space(state->text[offset]))
+                length = batch->capacity;
+        }
+        memcpy(batch->data, state->text + offset, length);
+        batch->length = length;
+        offset += length;
+        pipeline_send(output, batch);
+    }
+}
+
+/*
+ * Appends a token to `*batch`, sending it on and starting another when it is full.
+ */
+static void pipeline_token(pipeline_link *output, pipeline_batch **batch, ubyte const *token, uqword length) {
+    while (length != 0) {
+        // tokens longer than a length byte or a batch holds are cut
+        uqword part = length < 255 ? length : 255;
+        if (part > (*batch)->capacity - 1)
+            part = (*batch)->capacity - 1;
+        if ((*batch)->length != 0 && (*batch)->length + part + 1 > (*batch)->capacity) {
+            pipeline_send(output, *batch);
+            *batch = pipeline_acquire(output);
+        }
+        (*batch)->data[(*batch)->length] = (ubyte) part;
+        memcpy((*batch)->data + (*batch)->length + 1, token, part);
+        (*batch)->length += part + 1;
+        token += part;
+        length -= part;
+    }
+}
+
+/*
+ * Splits batches of text into tokens as workload_tokenize counts them: words, ';' and ":=".
+ */
+static void pipeline_lex(pipeline_link *input, pipeline_link *output, void *argument) {
+    pipeline_text_state const *state = argument;
+    pipeline_batch            *in;
+    uqword                     tokens = 0;
+
+    while ((in = pipeline_receive(input))) {
+        uqword const    start = p_get_time(NANOSECONDS);
+        pipeline_batch *out = pipeline_acquire(output);
+        uqword const    before = tokens;
+        ubyte const    *data = in->data;
+        for (uqword i = 0; i < in->length;) {
+            if (pipeline_space((char) data[i])) {
+                i++;
+                continue;
+            }
+            uqword length = 1;
+            if (data[i] == ':' && i + 1 < in->length && data[i + 1] == '=')
+                length = 2;
+            else if (data[i] != ';')
+                while (i + length < in->length && !pipeline_space((char) data[i + length]) && data[i + length] != ';' &&
+                       !(data[i + length] == ':' && i + length + 1 < in->length && data[i + length + 1] == '='))
+                    length++;
+            pipeline_token(output, &out, data + i, length);
+            tokens++;
+            i += length;
+        }
+        pipeline_release(input, in);
+        pipeline_send(output, out);
+
+        if (state->metrics) {
+            context_count(state->metrics, C_TOKENS_LEXED, tokens - before);
+            context_time(state->metrics, C_PHASE_LEX, p_get_time(NANOSECONDS) - start);
+        }
+    }
+    state->result->tokens = tokens;
+}
+
+/*
+ * Counts the statements, each ended by ';', and passes the tokens on.
+ */
+static void pipeline_parse(pipeline_link *input, pipeline_link *output, void *argument) {
+    pipeline_text_state const *state = argument;
+    pipeline_batch            *in;
+    uqword                     statements = 0;
+
+    while ((in = pipeline_receive(input))) {
+        for (uqword i = 0; i < in->length; i += in->data[i] + 1u)
+            statements += in->data[i] == 1 && in->data[i + 1] == ';';
+        pipeline_batch *out = pipeline_acquire(output);
+        memcpy(out->data, in->data, in->length);
+        out->length = in->length;
+        pipeline_release(input, in);
+        pipeline_send(output, out);
+    }
+    state->result->statements = statements;
+}
+
+/*
+ * Writes the tokens as text: separated by spaces, with a line break after each ';'.
+ */
+static void pipeline_emit(pipeline_link *input, pipeline_link *output, void *argument) {
+    (void) output;
+    pipeline_text_state const *state = argument;
+    pipeline_batch            *in;
+    uqword                     bytes = 0;
+
+    while ((in = pipeline_receive(input))) {
+        uqword const start = p_get_time(NANOSECONDS);
+        uqword const before = bytes;
+        for (uqword i = 0; i < in->length; i += in->data[i] + 1u) {
+            ubyte const length = in->data[i];
+            bool const  last = length == 1 && in->data[i + 1] == ';';
+            if (state->output) {
+                workload_append(state->output, (char const *) in->data + i + 1, length);
+                workload_append(state->output, last ? "\n" : " ", 1);
+            }
+            bytes += length + 1u;
+        }
+        pipeline_release(input, in);
+
+        if (state->metrics) {
+            context_count(state->metrics, C_BYTES_EMITTED, bytes - before);
+            context_time(state->metrics, C_PHASE_EMIT, p_get_time(NANOSECONDS) - start);
+        }
+    }
+    state->result->bytes = bytes;
+}
+
+pipeline_text_result pipeline_text(char const *text, uqword length, uqword batch_bytes, udword depth,
+                                   workload_text *output, context *metrics) {
+    pipeline_text_result result = {0};
+    pipeline_text_state  state = {text, length, output, metrics, &result};
+    pipeline            *pipe = pipeline_create(4, batch_bytes, depth);
+    pipeline_set_stage(pipe, 0, "split", pipeline_split, &state);
+    pipeline_set_stage(pipe, 1, "lex", pipeline_lex, &state);
+    pipeline_set_stage(pipe, 2, "parse", pipeline_parse, &state);
+    pipeline_set_stage(pipe, 3, "emit", pipeline_emit, &state);
+    pipeline_run(pipe);
+    pipeline_free(pipe);
+    if (output)
+        output->tokens += result.tokens;
+    return result;
+}
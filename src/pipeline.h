@@ -0,0 +1,115 @@
+/*
+ * Module: pipeline
+ * File: pipeline.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Pipelined execution: every stage runs on a thread of its own and passes batches to the next through a link, so that
+ * the stages overlap and throughput approaches that of the slowest stage. A link owns a fixed number of batches (its
+ * depth) which circulate between two SPSC rings, one carrying full batches downstream and one returning them empty;
+ * a stage which runs ahead finds no empty batch and waits, which is the backpressure, and memory stays proportional to
+ * the depth of the pipeline rather than to the size of the input.
+ *
+ * The text pipeline runs Anno Domini text through split -> lex -> parse -> emit: split cuts the input into batches at
+ * whitespace, lex encodes each token as its length byte followed by its bytes, parse counts the statements, and emit
+ * writes the tokens back out as text, one statement per line.
+ */
+
+#ifndef PROJECT_AQUINAS_PIPELINE_H
+#define PROJECT_AQUINAS_PIPELINE_H
+
+#include <stdatomic.h>
+#include <platform.h>
+#include "queue.h"
+#include "compiler.h"
+#include "workload.h"
+
+typedef struct pipeline_batch {
+    // bytes of data in use
+    uqword length;
+    uqword capacity;
+    ubyte  data[];
+} pipeline_batch;
+
+typedef struct pipeline_link {
+    spsc_queue      *full;
+    spsc_queue      *empty;
+    // set by the upstream stage when it has sent its last batch
+    atomic_bool      closed;
+    pipeline_batch **batches;
+    udword           depth;
+} pipeline_link;
+
+/*
+ * A stage receives batches from `input` and sends batches to `output`; the first stage has no input and the last no
+ * output. A stage must receive until pipeline_receive returns NULL, so that the stage before it never waits forever.
+ */
+typedef void (*pipeline_function)(pipeline_link *input, pipeline_link *output, void *state);
+
+typedef struct pipeline_stage {
+    // static name of the stage, which becomes the context and trace name of its thread
+    char const       *name;
+    pipeline_function function;
+    void             *state;
+} pipeline_stage;
+
+typedef struct pipeline {
+    udword          stage_count;
+    pipeline_stage *stages;
+    // stage_count - 1 links; link i runs from stage i to stage i + 1
+    pipeline_link  *links;
+} pipeline;
+
+/*
+ * Creates a pipeline of `stages` stages whose links hold `depth` batches of `batch_bytes` bytes each. The process
+ * terminates if `batch_bytes` is below 2 or it cannot be allocated.
+ */
+pipeline *pipeline_create(udword stages, uqword batch_bytes, udword depth);
+
+void pipeline_free(pipeline *pipe);
+
+void pipeline_set_stage(pipeline *pipe, udword index, char const *name, pipeline_function function, void *state);
+
+/*
+ * Runs every stage on a thread of its own and returns once all have returned.
+ */
+void pipeline_run(pipeline *pipe);
+
+/*
+ * Returns an empty batch of `output`, waiting while every batch is in flight.
+ */
+pipeline_batch *pipeline_acquire(pipeline_link *output);
+
+void pipeline_send(pipeline_link *output, pipeline_batch *batch);
+
+/*
+ * Returns the next full batch of `input`, waiting for one, or NULL once the stage before has returned and every batch
+ * it sent has been received.
+ */
+pipeline_batch *pipeline_receive(pipeline_link *input);
+
+/*
+ * Returns a received batch to the stage before for reuse.
+ */
+void pipeline_release(pipeline_link *input, pipeline_batch *batch);
+
+typedef struct pipeline_text_result {
+    uqword tokens;
+    uqword statements;
+    uqword bytes;
+} pipeline_text_result;
+
+/*
+ * Runs `text` through the text pipeline in batches of `batch_bytes` (tokens longer than a batch are cut), with
+ * `depth` batches per link. Appends the emitted text to `output` unless it is NULL; records tokens lexed, bytes emitted
+ * and the time of each lexed and emitted batch in `metrics` unless it is NULL.
+ */
+pipeline_text_result pipeline_text(char const *text, uqword length, uqword batch_bytes, udword depth,
+                                   workload_text *output, context *metrics);
+
+#endif //PROJECT_AQUINAS_PIPELINE_H
@@ -73,3 +73,85 @@ void *(*p_get_fn_offset(char *module, uintptr_t function_offset))() {
 }
 #pragma clang diagnostic pop
 #pragma GCC diagnostic pop
+
+#if PLATFORM == P_WINDOWS || ENVIRONMENT == P_WINDOWS
+
+	#include <process.h>
+	#include <psapi.h>
+
+int p_run_process(char *const argv[]) {
+	intptr_t const status = _spawnvp(_P_WAIT, argv[0], (char const *const *) argv);
+	return status == -1 ? -1 : (int) status;
+}
+
+uqword p_get_peak_resident(void) {
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return (uqword) counters.PeakWorkingSetSize;
+}
+
+bool p_reset_peak_resident(void) {
+	return false;
+}
+
+#elif PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+
+	#include <errno.h>
+	#include <spawn.h>
+	#include <stdio.h>
+	#include <sys/resource.h>
+	#include <sys/wait.h>
+	#include "state.h"
+
+extern char **environ;
+
+int p_run_process(char *const argv[]) {
+	pid_t process;
+	if (posix_spawnp(&process, argv[0], NULL, NULL, argv, environ) != 0)
+		return -1;
+
+	int status;
+	while (waitpid(process, &status, 0) == -1) {
+		// only a signal is worth waiting through; anything else (ECHILD, EINVAL) will fail again
+		if (errno != EINTR) {
+			warnf(__func__, "waiting for %s failed (errno %d)\n", argv[0], errno);
+			return -1;
+		}
+	}
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+uqword p_get_peak_resident(void) {
+	// VmHWM follows resets of the peak; ru_maxrss never goes down
+	FILE *status = fopen("/proc/self/status", "r");
+	if (status) {
+		char line[256];
+		unsigned long long kilobytes = 0;
+		bool found = false;
+		while (!found && fgets(line, sizeof(line), status))
+			found = sscanf(line, "VmHWM: %llu kB", &kilobytes) == 1;
+		fclose(status);
+		if (found)
+			return (uqword) kilobytes * 1024u;
+	}
+
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	// Linux reports kilobytes
+	return (uqword) usage.ru_maxrss * 1024u;
+}
+
+bool p_reset_peak_resident(void) {
+	FILE *clear_refs = fopen("/proc/self/clear_refs", "w");
+	if (!clear_refs)
+		return false;
+	// 5 resets the high-water mark of the resident set
+	bool const written = fputs("5", clear_refs) >= 0;
+	return fclose(clear_refs) == 0 && written;
+}
+
+#else
+	#error "[build][fatal][p_run_process] platform not yet supported"
+#endif
@@ -0,0 +1,418 @@
+/*
+ * Module: platform
+ * File: platform_cpu.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Processor topology and cache geometry. Each source fills in what it knows and leaves the rest for the next:
+ * the operating system first, then cpuid, then the defaults.
+ */
+
+#if defined(__linux__)
+  // sched_getaffinity
+  #define _GNU_SOURCE
+#endif
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "state.h"
+
+#if PLATFORM == P_WINDOWS || ENVIRONMENT == P_WINDOWS
+  #include <windows.h>
+#elif PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+  #include <unistd.h>
+  #if defined(__linux__)
+    #include <sched.h>
+  #endif
+#endif
+
+#if ARCH == ARCH_X86_64
+  #include "asm.h"
+#endif
+
+enum p_cpu_state {
+    P_CPU_UNDETECTED,
+    P_CPU_DETECTING,
+    P_CPU_DETECTED
+};
+
+static _Atomic ubyte  p_cpu_state;
+static p_cpu_topology p_cpu;
+static p_tuning       p_cpu_tuning;
+
+/*
+ * Records a cache unless an earlier source already did.
+ */
+static void p_cpu_set_cache(enum p_cache_level level, uqword size, udword line_size, udword associativity,
+                            udword shared_by) {
+    p_cache_info *cache = &p_cpu.caches[level];
+    if (cache->size != 0 || size == 0)
+        return;
+    *cache = (p_cache_info) {
+            .size = size, .line_size = line_size, .associativity = associativity, .shared_by = shared_by
+    };
+}
+
+/*
+ * Maps the cache level and type numbering shared by cpuid, sysfs and Windows (type: 1 data, 2 instruction, 3 unified).
+ */
+static bool p_cpu_cache_level(udword level, udword type, enum p_cache_level *out) {
+    if (level == 1 && (type == 1 || type == 2)) {
+        *out = type == 1 ? P_CACHE_L1_DATA : P_CACHE_L1_INSTRUCTION;
+        return true;
+    }
+    if ((level == 2 || level == 3) && type != 2) {
+        *out = level == 2 ? P_CACHE_L2 : P_CACHE_L3;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Numbers physical cores densely in order of appearance; `key` identifies a core across packages.
+ */
+static uword p_cpu_core_index(uqword *keys, uqword key) {
+    for (uword core = 0; core < p_cpu.physical_cores; core++)
+        if (keys[core] == key)
+            return core;
+    keys[p_cpu.physical_cores] = key;
+    return (uword) p_cpu.physical_cores++;
+}
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+
+static bool p_cpu_read(char const *path, char *buffer, uqword capacity) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+        return false;
+    bool const read = fgets(buffer, (int) capacity, file) != NULL;
+    fclose(file);
+    return read;
+}
+
+static bool p_cpu_read_number(char const *path, uqword *value) {
+    char buffer[64];
+    if (!p_cpu_read(path, buffer, sizeof(buffer)))
+        return false;
+
+    char *end;
+    *value = strtoull(buffer, &end, 10);
+    // sysfs cache sizes carry a unit
+    if (*end == 'K')
+        *value <<= 10;
+    else if (*end == 'M')
+        *value <<= 20;
+    else if (*end == 'G')
+        *value <<= 30;
+    return end != buffer;
+}
+
+/*
+ * Writes the numbers of the processors in a list such as "0-3,8-11" to `numbers`, up to `capacity` of them, and returns
+ * how many there are.
+ */
+static udword p_cpu_list(char const *list, uword *numbers, udword capacity) {
+    udword count = 0;
+    while (*list >= '0' && *list <= '9') {
+        char *end;
+        uqword const first = strtoull(list, &end, 10);
+        uqword       last  = first;
+        if (*end == '-')
+            last = strtoull(end + 1, &end, 10);
+        for (uqword number = first; number <= last && numbers; number++)
+            if (count + number - first < capacity)
+                numbers[count + number - first] = (uword) number;
+        count += (udword) (last - first + 1);
+        list = *end == ',' ? end + 1 : end;
+    }
+    return count;
+}
+
+// sysconf reports unknown values as 0 or -1
+static udword p_cpu_sysconf(int name) {
+    long const value = sysconf(name);
+    return value > 0 ? (udword) value : 0;
+}
+
+static void p_cpu_detect_os(void) {
+    // online processors may be numbered with gaps (offline or hot-plugged ones); without the list, assume none
+    char online[1024];
+    if (p_cpu_read("/sys/devices/system/cpu/online", online, sizeof(online)))
+        p_cpu.logical_cores = p_cpu_list(online, p_cpu.number, P_CPU_MAX);
+    if (p_cpu.logical_cores == 0) {
+        long const count = sysconf(_SC_NPROCESSORS_ONLN);
+        p_cpu.logical_cores = count > 0 ? (udword) count : 1;
+        for (udword cpu = 0; cpu < p_cpu.logical_cores && cpu < P_CPU_MAX; cpu++)
+            p_cpu.number[cpu] = (uword) cpu;
+    }
+    if (p_cpu.logical_cores > P_CPU_MAX)
+        p_cpu.logical_cores = P_CPU_MAX;
+
+    // topology: cores are identified by (package, core id)
+    static uqword core_keys[P_CPU_MAX];
+    static uqword package_keys[P_CPU_MAX];
+    char          path[128];
+    for (udword cpu = 0; cpu < p_cpu.logical_cores; cpu++) {
+        uqword package, core;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", p_cpu.number[cpu]);
+        bool found = p_cpu_read_number(path, &package);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/core_id", p_cpu.number[cpu]);
+        found = found && p_cpu_read_number(path, &core);
+        if (!found) {
+            // a core of its own
+            package = 0;
+            core = (uqword) 1 << 32 | p_cpu.number[cpu];
+        }
+
+        udword known = 0;
+        while (known < p_cpu.packages && package_keys[known] != package)
+            known++;
+        if (known == p_cpu.packages)
+            package_keys[p_cpu.packages++] = package;
+        p_cpu.core_of[cpu] = p_cpu_core_index(core_keys, package << 33 | core);
+    }
+
+#if defined(__linux__)
+    // cores this process may run on, which taskset or a cpuset may restrict to fewer than are online
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        static bool counted[P_CPU_MAX];
+        for (udword cpu = 0; cpu < p_cpu.logical_cores; cpu++) {
+            if (p_cpu.number[cpu] >= CPU_SETSIZE || !CPU_ISSET(p_cpu.number[cpu], &allowed) ||
+                counted[p_cpu.core_of[cpu]])
+                continue;
+            counted[p_cpu.core_of[cpu]] = true;
+            p_cpu.allowed_cores++;
+        }
+    }
+#endif
+
+    // caches of the first online processor
+    for (udword index = 0;; index++) {
+        uqword level, size, line_size = 0, associativity = 0;
+        char   type[32], shared[256], cache_path[64];
+        snprintf(cache_path, sizeof(cache_path), "/sys/devices/system/cpu/cpu%u/cache/index%u", p_cpu.number[0], index);
+        snprintf(path, sizeof(path), "%s/level", cache_path);
+        if (!p_cpu_read_number(path, &level))
+            break;
+        snprintf(path, sizeof(path), "%s/size", cache_path);
+        if (!p_cpu_read_number(path, &size))
+            continue;
+        snprintf(path, sizeof(path), "%s/type", cache_path);
+        if (!p_cpu_read(path, type, sizeof(type)))
+            continue;
+        snprintf(path, sizeof(path), "%s/coherency_line_size", cache_path);
+        p_cpu_read_number(path, &line_size);
+        snprintf(path, sizeof(path), "%s/ways_of_associativity", cache_path);
+        p_cpu_read_number(path, &associativity);
+        snprintf(path, sizeof(path), "%s/shared_cpu_list", cache_path);
+        udword const shared_by = p_cpu_read(path, shared, sizeof(shared)) ? p_cpu_list(shared, NULL, 0) : 0;
+
+        udword const numbered = strncmp(type, "Data", 4) == 0 ? 1 : strncmp(type, "Instruction", 11) == 0 ? 2 : 3;
+        enum p_cache_level cache;
+        if (p_cpu_cache_level((udword) level, numbered, &cache))
+            p_cpu_set_cache(cache, size, (udword) line_size, (udword) associativity, shared_by);
+    }
+
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+    p_cpu_set_cache(P_CACHE_L1_DATA, p_cpu_sysconf(_SC_LEVEL1_DCACHE_SIZE), p_cpu_sysconf(_SC_LEVEL1_DCACHE_LINESIZE),
+                    p_cpu_sysconf(_SC_LEVEL1_DCACHE_ASSOC), 0);
+    p_cpu_set_cache(P_CACHE_L1_INSTRUCTION, p_cpu_sysconf(_SC_LEVEL1_ICACHE_SIZE),
+                    p_cpu_sysconf(_SC_LEVEL1_ICACHE_LINESIZE), p_cpu_sysconf(_SC_LEVEL1_ICACHE_ASSOC), 0);
+    p_cpu_set_cache(P_CACHE_L2, p_cpu_sysconf(_SC_LEVEL2_CACHE_SIZE), p_cpu_sysconf(_SC_LEVEL2_CACHE_LINESIZE),
+                    p_cpu_sysconf(_SC_LEVEL2_CACHE_ASSOC), 0);
+    p_cpu_set_cache(P_CACHE_L3, p_cpu_sysconf(_SC_LEVEL3_CACHE_SIZE), p_cpu_sysconf(_SC_LEVEL3_CACHE_LINESIZE),
+                    p_cpu_sysconf(_SC_LEVEL3_CACHE_ASSOC), 0);
+#endif
+}
+
+#elif PLATFORM == P_WINDOWS || ENVIRONMENT == P_WINDOWS
+
+static void p_cpu_detect_os(void) {
+    SYSTEM_INFO system_info;
+    GetNativeSystemInfo(&system_info);
+    p_cpu.logical_cores = system_info.dwNumberOfProcessors;
+    if (p_cpu.logical_cores > P_CPU_MAX)
+        p_cpu.logical_cores = P_CPU_MAX;
+    for (udword cpu = 0; cpu < p_cpu.logical_cores; cpu++) {
+        p_cpu.number[cpu] = (uword) cpu;
+        p_cpu.core_of[cpu] = UINT16_MAX;
+    }
+
+    DWORD length = 0;
+    GetLogicalProcessorInformation(NULL, &length);
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION *information = malloc(length);
+    if (information == NULL || !GetLogicalProcessorInformation(information, &length)) {
+        free(information);
+        length = 0;
+    }
+
+    for (DWORD i = 0; i < length / sizeof(*information); i++) {
+        SYSTEM_LOGICAL_PROCESSOR_INFORMATION const *entry = &information[i];
+        switch (entry->Relationship) {
+            case RelationProcessorCore:
+                // logical processors of the first processor group, one bit each
+                for (udword cpu = 0; cpu < p_cpu.logical_cores && cpu < sizeof(ULONG_PTR) * CHAR_BIT; cpu++)
+                    if (entry->ProcessorMask >> cpu & 1u)
+                        p_cpu.core_of[cpu] = (uword) p_cpu.physical_cores;
+                p_cpu.physical_cores++;
+                break;
+            case RelationProcessorPackage:
+                p_cpu.packages++;
+                break;
+            case RelationCache: {
+                CACHE_DESCRIPTOR const *descriptor = &entry->Cache;
+                udword const type = descriptor->Type == CacheData ? 1 : descriptor->Type == CacheInstruction ? 2 : 3;
+                enum p_cache_level cache;
+                if (p_cpu_cache_level(descriptor->Level, type, &cache))
+                    p_cpu_set_cache(cache, descriptor->Size, descriptor->LineSize, descriptor->Associativity == 0xFF
+                                                                                  ? 0 : descriptor->Associativity,
+                                    (udword) __builtin_popcountll(entry->ProcessorMask));
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    free(information);
+
+    // processors of other groups are cores of their own
+    for (udword cpu = 0; cpu < p_cpu.logical_cores; cpu++)
+        if (p_cpu.core_of[cpu] == UINT16_MAX)
+            p_cpu.core_of[cpu] = (uword) p_cpu.physical_cores++;
+}
+
+#else
+
+static void p_cpu_detect_os(void) {
+    p_cpu.logical_cores = 1;
+}
+
+#endif
+
+#if ARCH == ARCH_X86_64
+
+/*
+ * Reads the deterministic cache parameters of cpuid leaf 4 (Intel) or 0x8000001D (AMD), which share one layout.
+ */
+static void p_cpu_detect_cpuid(void) {
+    if (!__x64_cpuid_supported())
+        return;
+
+    // the brand string is 48 bytes across leaves 0x80000002 to 0x80000004, padded with spaces or NULs
+    if (__x64_cpuid(0x80000000u).eax >= 0x80000004u) {
+        for (uint32_t part = 0; part < 3; part++) {
+            struct cpuid_function_values const values = __x64_cpuid(0x80000002u + part);
+            memcpy(p_cpu.name + part * 16, &values, 16);
+        }
+        p_cpu.name[48] = '\0';
+        char *start = p_cpu.name;
+        while (*start == ' ')
+            start++;
+        memmove(p_cpu.name, start, strlen(start) + 1);
+        for (uqword length = strlen(p_cpu.name); length != 0 && p_cpu.name[length - 1] == ' '; length--)
+            p_cpu.name[length - 1] = '\0';
+    }
+
+    uint32_t leaf = 0;
+    if (__x64_cpuid(0).eax >= 4)
+        leaf = 4;
+    // AMD reports topology extensions in bit 22 of ecx
+    if (__x64_cpuid(0x80000000u).eax >= 0x8000001Du && __x64_cpuid(0x80000001u).ecx >> 22 & 1u)
+        leaf = 0x8000001Du;
+    if (leaf == 0)
+        return;
+
+    for (uint32_t index = 0; index < 16; index++) {
+        struct cpuid_function_values const values = __x64_cpuid_count(leaf, index);
+        udword const type = values.eax & 0x1Fu;
+        if (type == 0)
+            break;
+
+        udword const level         = values.eax >> 5 & 7u;
+        udword const shared_by     = (values.eax >> 14 & 0xFFFu) + 1;
+        udword const ways          = (values.ebx >> 22) + 1;
+        udword const partitions    = (values.ebx >> 12 & 0x3FFu) + 1;
+        udword const line_size     = (values.ebx & 0xFFFu) + 1;
+        uqword const sets          = (uqword) values.ecx + 1;
+        bool const   fully_mapped  = values.eax >> 9 & 1u;
+
+        enum p_cache_level cache;
+        if (p_cpu_cache_level(level, type, &cache))
+            p_cpu_set_cache(cache, (uqword) ways * partitions * line_size * sets, line_size, fully_mapped ? 0 : ways,
+                            shared_by);
+    }
+}
+
+#else
+
+static void p_cpu_detect_cpuid(void) {
+}
+
+#endif
+
+static void p_cpu_detect(void) {
+    p_cpu_detect_os();
+    p_cpu_detect_cpuid();
+
+    if (p_cpu.physical_cores == 0) {
+        for (udword cpu = 0; cpu < p_cpu.logical_cores; cpu++)
+            p_cpu.core_of[cpu] = (uword) cpu;
+        p_cpu.physical_cores = p_cpu.logical_cores;
+    }
+    if (p_cpu.allowed_cores == 0)
+        p_cpu.allowed_cores = p_cpu.physical_cores;
+    if (p_cpu.packages == 0)
+        p_cpu.packages = 1;
+
+    p_cpu.line_size = p_cpu.caches[P_CACHE_L1_DATA].line_size;
+    if (p_cpu.line_size == 0)
+        p_cpu.line_size = P_CACHE_LINE_SIZE;
+
+    p_cpu_tuning = (p_tuning) {.line_size = p_cpu.line_size, .workers = p_cpu.allowed_cores};
+}
+
+p_cpu_topology const *p_get_cpu_topology(void) {
+    ubyte state = atomic_load_explicit(&p_cpu_state, memory_order_acquire);
+    if (state == P_CPU_DETECTED)
+        return &p_cpu;
+
+    if (state == P_CPU_UNDETECTED && atomic_compare_exchange_strong(&p_cpu_state, &state, P_CPU_DETECTING)) {
+        p_cpu_detect();
+        atomic_store_explicit(&p_cpu_state, P_CPU_DETECTED, memory_order_release);
+        return &p_cpu;
+    }
+
+    // another thread is detecting
+    while (atomic_load_explicit(&p_cpu_state, memory_order_acquire) != P_CPU_DETECTED);
+    return &p_cpu;
+}
+
+udword p_get_cpu_siblings(udword cpu, udword *siblings, udword capacity) {
+    p_cpu_topology const *topology = p_get_cpu_topology();
+    if (cpu >= topology->logical_cores)
+        fatalf(__func__, "processor %u is not one of the %u online processors\n", cpu, topology->logical_cores);
+
+    udword count = 0;
+    for (udword other = 0; other < topology->logical_cores; other++) {
+        if (topology->core_of[other] != topology->core_of[cpu])
+            continue;
+        if (count < capacity)
+            siblings[count] = other;
+        count++;
+    }
+    return count;
+}
+
+p_tuning const *p_get_tuning(void) {
+    p_get_cpu_topology();
+    return &p_cpu_tuning;
+}
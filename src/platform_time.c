@@ -0,0 +1,211 @@
+/*
+ * Module: platform
+ * File: platform_time.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Monotonic time from the time stamp counter. Cycles are converted to nanoseconds as (cycles * scale) >> 32 in 128 bit
+ * arithmetic, where scale is fixed at calibration, so a conversion costs one multiplication.
+ */
+
+#include <stdatomic.h>
+#include <time.h>
+#include "platform.h"
+#include "state.h"
+
+#if PLATFORM == P_WINDOWS || ENVIRONMENT == P_WINDOWS
+  #include <windows.h>
+#endif
+
+#if ARCH == ARCH_X86_64
+  #include "asm.h"
+#endif
+
+// how long the counter is compared against the operating system's clock
+#define P_TIME_CALIBRATION_NANOSECONDS 25000000u
+#define P_TIME_NANOSECONDS_PER_SECOND  1000000000u
+
+enum p_time_state {
+    P_TIME_UNCALIBRATED,
+    P_TIME_CALIBRATING,
+    P_TIME_CALIBRATED
+};
+
+static _Atomic ubyte p_time_state;
+static uqword        p_time_frequency;
+static bool          p_time_invariant;
+static bool          p_time_rdtscp;
+// nanoseconds per cycle and cycles per nanosecond as 32.32 fixed point
+static udqword       p_time_to_nanoseconds;
+static udqword       p_time_to_cycles;
+
+/*
+ * The operating system's monotonic clock in nanoseconds, unaffected by clock adjustments where possible.
+ */
+static uqword p_time_os(void) {
+#if PLATFORM == P_WINDOWS || ENVIRONMENT == P_WINDOWS
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uqword) ((udqword) counter.QuadPart * P_TIME_NANOSECONDS_PER_SECOND / (udqword) frequency.QuadPart);
+#else
+    struct timespec now;
+  #if defined(CLOCK_MONOTONIC_RAW)
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+  #else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+  #endif
+    return (uqword) now.tv_sec * P_TIME_NANOSECONDS_PER_SECOND + (uqword) now.tv_nsec;
+#endif
+}
+
+#if ARCH == ARCH_X86_64
+
+/*
+ * Reads the clock and the counter at (nearly) the same instant: of several attempts, keeps the one in which the two
+ * clock reads around the counter read are closest together.
+ */
+static void p_time_sample(uqword *nanoseconds, uqword *cycles) {
+    uqword best = UINT64_MAX;
+    // the first attempt always replaces these; set here so that the compiler can see it
+    *nanoseconds = 0;
+    *cycles = 0;
+    for (ubyte attempt = 0; attempt < 16; attempt++) {
+        uqword const before  = p_time_os();
+        uqword const counter = __x64_rdtsc_begin();
+        uqword const after   = p_time_os();
+        if (after - before < best) {
+            best = after - before;
+            *nanoseconds = before + (after - before) / 2;
+            *cycles = counter;
+        }
+    }
+}
+
+static uqword p_time_measure_frequency(void) {
+    uqword start_nanoseconds = 0, start_cycles = 0, end_nanoseconds = 0, end_cycles = 0;
+    p_time_sample(&start_nanoseconds, &start_cycles);
+    while (p_time_os() - start_nanoseconds < P_TIME_CALIBRATION_NANOSECONDS);
+    p_time_sample(&end_nanoseconds, &end_cycles);
+
+    return (uqword) ((udqword) (end_cycles - start_cycles) * P_TIME_NANOSECONDS_PER_SECOND /
+                     (end_nanoseconds - start_nanoseconds));
+}
+
+static void p_time_detect(void) {
+    p_time_invariant = false;
+    p_time_rdtscp = false;
+    p_time_frequency = 0;
+
+    if (__x64_cpuid_supported()) {
+        uint32_t const extended = __x64_cpuid(0x80000000u).eax;
+        if (extended >= 0x80000001u)
+            p_time_rdtscp = __x64_cpuid(0x80000001u).edx >> 27 & 1u;
+        if (extended >= 0x80000007u)
+            p_time_invariant = __x64_cpuid(0x80000007u).edx >> 8 & 1u;
+
+        // leaf 0x15: the counter runs at crystal * ebx / eax
+        if (__x64_cpuid(0).eax >= 0x15) {
+            struct cpuid_function_values const ratio = __x64_cpuid(0x15);
+            if (ratio.eax != 0 && ratio.ebx != 0 && ratio.ecx != 0)
+                p_time_frequency = (uqword) ratio.ecx * ratio.ebx / ratio.eax;
+        }
+    }
+
+    if (p_time_frequency == 0)
+        p_time_frequency = p_time_measure_frequency();
+}
+
+#else
+
+static void p_time_detect(void) {
+    p_time_invariant = false;
+    p_time_frequency = P_TIME_NANOSECONDS_PER_SECOND;
+}
+
+#endif
+
+static void p_time_calibrate(void) {
+    ubyte state = atomic_load_explicit(&p_time_state, memory_order_acquire);
+    if (state == P_TIME_CALIBRATED)
+        return;
+
+    if (state == P_TIME_UNCALIBRATED && atomic_compare_exchange_strong(&p_time_state, &state, P_TIME_CALIBRATING)) {
+        p_time_detect();
+        if (p_time_frequency == 0)
+            fatalf(__func__, "unable to calibrate the time stamp counter\n");
+        p_time_to_nanoseconds = ((udqword) P_TIME_NANOSECONDS_PER_SECOND << 32) / p_time_frequency;
+        p_time_to_cycles = ((udqword) p_time_frequency << 32) / P_TIME_NANOSECONDS_PER_SECOND;
+        atomic_store_explicit(&p_time_state, P_TIME_CALIBRATED, memory_order_release);
+        return;
+    }
+
+    // another thread is calibrating
+    while (atomic_load_explicit(&p_time_state, memory_order_acquire) != P_TIME_CALIBRATED);
+}
+
+uqword p_get_cycle_frequency(void) {
+    p_time_calibrate();
+    return p_time_frequency;
+}
+
+bool p_get_cycles_invariant(void) {
+    p_time_calibrate();
+    return p_time_invariant;
+}
+
+uqword p_cycles_to_nanoseconds(uqword cycles) {
+    p_time_calibrate();
+    return (uqword) ((udqword) cycles * p_time_to_nanoseconds >> 32);
+}
+
+uqword p_nanoseconds_to_cycles(uqword nanoseconds) {
+    p_time_calibrate();
+    return (uqword) ((udqword) nanoseconds * p_time_to_cycles >> 32);
+}
+
+uqword p_get_cycles_begin(void) {
+#if ARCH == ARCH_X86_64
+    return __x64_rdtsc_begin();
+#else
+    return p_time_os();
+#endif
+}
+
+uqword p_get_cycles_end(void) {
+#if ARCH == ARCH_X86_64
+    p_time_calibrate();
+    return p_time_rdtscp ? __x64_rdtscp_end() : __x64_rdtsc_begin();
+#else
+    return p_time_os();
+#endif
+}
+
+uintmax_t p_get_time(enum p_time_resolution unit) {
+    p_time_calibrate();
+
+    uqword nanoseconds;
+#if ARCH == ARCH_X86_64
+    if (unit == CYCLES)
+        return __x64_rdtsc();
+    nanoseconds = p_time_invariant ? (uqword) ((udqword) __x64_rdtsc() * p_time_to_nanoseconds >> 32) : p_time_os();
+#else
+    nanoseconds = p_time_os();
+#endif
+
+    switch (unit) {
+        case MICROSECONDS:
+            return nanoseconds / 1000u;
+        case MILLISECONDS:
+            return nanoseconds / 1000000u;
+        case SECONDS:
+            return nanoseconds / P_TIME_NANOSECONDS_PER_SECOND;
+        default:
+            return nanoseconds;
+    }
+}
@@ -0,0 +1,449 @@
+/*
+ * Module: runner
+ * File: runner.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "state.h"
+#include "logger.h"
+#include "runner.h"
+#include "baseline.h"
+#include "profile.h"
+
+#if PLATFORM == P_WINDOWS || ENVIRONMENT == P_WINDOWS
+  #include <direct.h>
+#elif PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+  #include <unistd.h>
+#endif
+
+// iteration counts stop doubling here, whatever the repetition takes
+#define RUNNER_MAX_ITERATIONS (1ull << 40)
+
+static _Thread_local uqword runner_bytes, runner_items;
+
+static char const runner_usage[] =
+        "usage: Project-Aquinas [options] [pattern...]\n"
+        "  pattern            run the tests and benchmarks whose names match ('*' and '?' are wildcards)\n"
+        "  --list             list the selected entries instead of running them\n"
+        "  --tests            select tests (the default without patterns)\n"
+        "  --benchmarks       select benchmarks\n"
+        "  --all              select tests and benchmarks\n"
+        "  --repetitions=N    measured repetitions of each benchmark (default 30)\n"
+        "  --warmup=N         unmeasured repetitions before them (default 3)\n"
+        "  --min-time=MS      milliseconds one repetition takes at least (default 10)\n"
+        "  --no-counters      do not read hardware counters\n"
+        "  --json=FILE        write the benchmark results to FILE as JSON ('-' for stdout)\n"
+        "  --baseline=FILE    compare the benchmark results with those in FILE\n"
+        "  --compare=BUILD    run the benchmarks of this build and of BUILD interleaved and compare them\n"
+        "  --rounds=N         rounds of the comparison (default 5)\n"
+        "  --alpha=P          significance level of a regression (default 0.01)\n"
+        "  --threshold=PCT    slowdown of the median below which nothing regresses (default 2)\n"
+        "  --profile=FILE     sample the run and write its stacks to FILE as folded stacks\n"
+        "  --profile-hz=N     samples per second of CPU time (default 997)\n";
+
+void runner_processed(uqword bytes, uqword items) {
+    runner_bytes += bytes;
+    runner_items += items;
+}
+
+static uqword runner_number(char const *option, char const *value) {
+    char        *end;
+    uqword const number = strtoull(value, &end, 10);
+    if (end == value || *end != '\0')
+        fatalf(__func__, "%s expects a number, not '%s'\n%s", option, value, runner_usage);
+    return number;
+}
+
+static double runner_real(char const *option, char const *value) {
+    char        *end;
+    double const number = strtod(value, &end);
+    if (end == value || *end != '\0' || number < 0)
+        fatalf(__func__, "%s expects a non-negative number, not '%s'\n%s", option, value, runner_usage);
+    return number;
+}
+
+void runner_parse(runner_options *options, int argc, char **argv) {
+    *options = (runner_options) {
+            .repetitions = 30,
+            .warmup = 3,
+            .repetition_nanoseconds = 10000000,
+            .counters = true,
+            .patterns = argv + 1,
+            .pattern_count = 0,
+            .program = argv[0],
+            .rounds = 5,
+            .alpha = 0.01,
+            .threshold = 0.02,
+            .profile_frequency = PROFILE_DEFAULT_FREQUENCY
+    };
+    bool kinds = false;
+
+    for (int i = 1; i < argc; i++) {
+        char *const argument = argv[i];
+        if (strncmp(argument, "--", 2) != 0) {
+            options->patterns[options->pattern_count++] = argument;
+            continue;
+        }
+
+        char const *value = strchr(argument, '=');
+        value = value != NULL ? value + 1 : "";
+        if (strcmp(argument, "--list") == 0)
+            options->list = true;
+        else if (strcmp(argument, "--tests") == 0)
+            options->tests = kinds = true;
+        else if (strcmp(argument, "--benchmarks") == 0)
+            options->benchmarks = kinds = true;
+        else if (strcmp(argument, "--all") == 0)
+            options->tests = options->benchmarks = kinds = true;
+        else if (strncmp(argument, "--repetitions=", 14) == 0)
+            options->repetitions = (udword) runner_number("--repetitions", value);
+        else if (strncmp(argument, "--warmup=", 9) == 0)
+            options->warmup = (udword) runner_number("--warmup", value);
+        else if (strncmp(argument, "--min-time=", 11) == 0)
+            options->repetition_nanoseconds = runner_number("--min-time", value) * 1000000u;
+        else if (strcmp(argument, "--no-counters") == 0)
+            options->counters = false;
+        else if (strncmp(argument, "--json=", 7) == 0)
+            options->json = argument + 7;
+        else if (strncmp(argument, "--baseline=", 11) == 0)
+            options->baseline = argument + 11;
+        else if (strncmp(argument, "--compare=", 10) == 0)
+            options->compare = argument + 10;
+        else if (strncmp(argument, "--rounds=", 9) == 0)
+            options->rounds = (udword) runner_number("--rounds", value);
+        else if (strncmp(argument, "--alpha=", 8) == 0)
+            options->alpha = runner_real("--alpha", value);
+        else if (strncmp(argument, "--threshold=", 12) == 0)
+            options->threshold = runner_real("--threshold", value) / 100;
+        else if (strncmp(argument, "--profile=", 10) == 0)
+            options->profile = argument + 10;
+        else if (strncmp(argument, "--profile-hz=", 13) == 0)
+            options->profile_frequency = (udword) runner_number("--profile-hz", value);
+        else
+            fatalf(__func__, "unknown option '%s'\n%s", argument, runner_usage);
+    }
+
+    // without a kind, patterns select either kind and the default is every test
+    if (!kinds) {
+        options->tests = true;
+        options->benchmarks = options->pattern_count != 0;
+    }
+    if (options->repetitions == 0)
+        options->repetitions = 1;
+    if (options->rounds == 0)
+        options->rounds = 1;
+}
+
+bool runner_glob(char const *pattern, char const *name) {
+    for (; *pattern != '\0'; pattern++, name++) {
+        if (*pattern == '*') {
+            // the star matches the shortest prefix after which the rest matches
+            for (char const *rest = name;; rest++) {
+                if (runner_glob(pattern + 1, rest))
+                    return true;
+                if (*rest == '\0')
+                    return false;
+            }
+        }
+        if (*name == '\0' || (*pattern != '?' && *pattern != *name))
+            return false;
+    }
+    return *name == '\0';
+}
+
+static bool runner_selected(runner_entry const *entry, runner_options const *options) {
+    if (!(entry->kind == RUNNER_TEST ? options->tests : options->benchmarks))
+        return false;
+    if (options->pattern_count == 0)
+        return true;
+    for (udword i = 0; i < options->pattern_count; i++)
+        if (runner_glob(options->patterns[i], entry->name))
+            return true;
+    return false;
+}
+
+static int runner_compare(void const *a, void const *b) {
+    double const x = *(double const *) a, y = *(double const *) b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Returns the nearest-rank percentile of sorted samples.
+ */
+static double runner_percentile(double const *sorted, udword count, double percentile) {
+    udword rank = (udword) (percentile / 100 * count + 0.999999);
+    rank = rank == 0 ? 1 : rank > count ? count : rank;
+    return sorted[rank - 1];
+}
+
+static double runner_median(double const *sorted, udword count) {
+    return count & 1u ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+}
+
+static void runner_statistics(runner_result *result) {
+    udword const count  = result->repetitions;
+    double      *sorted = malloc(count * sizeof(double));
+    if (sorted == NULL)
+        fatalf(__func__, "unable to allocate %u samples\n", count);
+
+    memcpy(sorted, result->samples, count * sizeof(double));
+    qsort(sorted, count, sizeof(double), runner_compare);
+    result->median = runner_median(sorted, count);
+    result->p99 = runner_percentile(sorted, count, 99);
+
+    for (udword i = 0; i < count; i++)
+        sorted[i] = result->median > sorted[i] ? result->median - sorted[i] : sorted[i] - result->median;
+    qsort(sorted, count, sizeof(double), runner_compare);
+    result->mad = runner_median(sorted, count);
+    result->throughput = result->median > 0 ? 1e9 / result->median : 0;
+    free(sorted);
+}
+
+static uqword runner_time(runner_entry const *entry, uqword iterations) {
+    uqword const start = p_get_time(NANOSECONDS);
+    entry->benchmark(iterations);
+    return p_get_time(NANOSECONDS) - start;
+}
+
+static void runner_benchmark(runner_result *result, runner_options const *options) {
+    runner_entry const *entry = result->entry;
+    // where the peak can be reset it restarts from the current resident set, and the growth is exact; elsewhere only a
+    // benchmark which raises the process's peak shows any
+    p_reset_peak_resident();
+    uqword const resident = p_get_peak_resident();
+
+    // the smallest power of two of iterations which fills a repetition; the faster of two runs decides, so that a
+    // single preemption does not end the search early
+    uqword iterations = 1;
+    while (iterations < RUNNER_MAX_ITERATIONS) {
+        uqword const first = runner_time(entry, iterations), second = runner_time(entry, iterations);
+        if ((first < second ? first : second) >= options->repetition_nanoseconds)
+            break;
+        iterations <<= 1;
+    }
+
+    for (udword i = 0; i < options->warmup; i++)
+        runner_time(entry, iterations);
+
+    perf_group group;
+    bool const counting = options->counters && perf_group_open(&group);
+
+    result->iterations = iterations;
+    result->repetitions = options->repetitions;
+    result->samples = malloc(options->repetitions * sizeof(double));
+    if (result->samples == NULL)
+        fatalf(__func__, "unable to allocate %u samples\n", options->repetitions);
+
+    uqword elapsed = 0;
+    runner_bytes = runner_items = 0;
+    if (counting)
+        perf_group_begin(&group);
+    for (udword i = 0; i < options->repetitions; i++) {
+        uqword const nanoseconds = runner_time(entry, iterations);
+        result->samples[i] = (double) nanoseconds / (double) iterations;
+        elapsed += nanoseconds;
+    }
+    if (counting) {
+        perf_group_end(&group, &result->counters);
+        perf_group_close(&group);
+        result->counted_iterations = iterations * options->repetitions;
+    }
+
+    if (elapsed != 0) {
+        result->bytes_per_second = (double) runner_bytes * 1e9 / (double) elapsed;
+        result->items_per_second = (double) runner_items * 1e9 / (double) elapsed;
+    }
+    uqword const peak = p_get_peak_resident();
+    result->peak_resident_growth = peak > resident ? peak - resident : 0;
+    runner_statistics(result);
+}
+
+static void runner_report(runner_result const *result) {
+    if (!result->passed) {
+        warnf(__func__, "FAILED %s\n", result->entry->name);
+        return;
+    }
+    if (result->entry->kind == RUNNER_TEST) {
+        infof(__func__, "ok %s (%.3f ms)\n", result->entry->name, (double) result->nanoseconds / 1e6);
+        return;
+    }
+
+    infof(__func__, "%s: median %.3f ns, p99 %.3f ns, mad %.3f ns, %.4g per second (%llu x %u)\n",
+          result->entry->name, result->median, result->p99, result->mad, result->throughput,
+          (unsigned long long) result->iterations,
+          result->repetitions);
+    if (result->bytes_per_second != 0 || result->items_per_second != 0)
+        infof(__func__, "%s: %.2f MB/s, %.4g items per second, peak rss +%.1f MB\n", result->entry->name,
+              result->bytes_per_second / 1e6, result->items_per_second, (double) result->peak_resident_growth / 1e6);
+    for (ubyte counter = 0; counter < PERF_COUNTERS; counter++)
+        if (result->counters.valid[counter])
+            infof(__func__, "%s: %s %.3f per iteration\n", result->entry->name, perf_counter_name(counter),
+                  (double) result->counters.values[counter] / (double) result->counted_iterations);
+}
+
+/*
+ * Runs the selected benchmarks of `build` in a child process and adds its results to `results`.
+ */
+static bool runner_child(char *build, char *path, runner_options const *options, baseline *results) {
+    char repetitions[32], warmup[32], min_time[32], json[4096];
+    snprintf(repetitions, sizeof(repetitions), "--repetitions=%u", options->repetitions);
+    snprintf(warmup, sizeof(warmup), "--warmup=%u", options->warmup);
+    snprintf(min_time, sizeof(min_time), "--min-time=%llu",
+             (unsigned long long) (options->repetition_nanoseconds + 999999) / 1000000);
+    snprintf(json, sizeof(json), "--json=%s", path);
+
+    char *arguments[8 + options->pattern_count];
+    udword count = 0;
+    arguments[count++] = build;
+    arguments[count++] = "--benchmarks";
+    arguments[count++] = "--no-counters";
+    arguments[count++] = repetitions;
+    arguments[count++] = warmup;
+    arguments[count++] = min_time;
+    arguments[count++] = json;
+    for (udword i = 0; i < options->pattern_count; i++)
+        arguments[count++] = options->patterns[i];
+    arguments[count] = NULL;
+
+    int const  status = p_run_process(arguments);
+    bool const read = status == 0 && baseline_read(path, results);
+    // a child which failed may still have written part of the file
+    remove(path);
+    if (status != 0)
+        warnf(__func__, "%s exited with status %d\n", build, status);
+    return read;
+}
+
+/*
+ * Creates a directory only this user can write to, under TMPDIR (or TEMP on Windows), for the files of the children.
+ */
+static bool runner_temporary_directory(char *path, uqword capacity) {
+#if PLATFORM == P_WINDOWS || ENVIRONMENT == P_WINDOWS
+    char *name = _tempnam(NULL, "aquinas-compare-");
+    bool const made = name != NULL && strlen(name) < capacity && _mkdir(name) == 0;
+    if (made)
+        strcpy(path, name);
+    free(name);
+    return made;
+#else
+    char const *parent = getenv("TMPDIR");
+    if (parent == NULL || *parent == '\0')
+        parent = "/tmp";
+    int const length = snprintf(path, capacity, "%s/aquinas-compare-XXXXXX", parent);
+    return length > 0 && (uqword) length < capacity && mkdtemp(path) != NULL;
+#endif
+}
+
+static bool runner_compare_builds(runner_options const *options) {
+    char directory[4000], before[4096], after[4096];
+    if (!runner_temporary_directory(directory, sizeof(directory))) {
+        warnf(__func__, "unable to create a temporary directory for the results of the builds\n");
+        return false;
+    }
+    snprintf(before, sizeof(before), "%s/before.json", directory);
+    snprintf(after, sizeof(after), "%s/after.json", directory);
+
+    char *const paths[2] = {before, after};
+    char *const builds[2] = {options->compare, options->program};
+    baseline    results[2] = {0};
+    bool        completed = true;
+
+    for (udword round = 0; round < options->rounds && completed; round++) {
+        infof(__func__, "round %u of %u\n", round + 1, options->rounds);
+        log_flush();
+        // ABBA order: whichever build ran second runs first in the next round
+        for (udword turn = 0; turn < 2 && completed; turn++) {
+            udword const build = (turn + round) & 1u;
+            completed = runner_child(builds[build], paths[build], options, &results[build]);
+        }
+    }
+
+    // each child's file is removed once read
+    rmdir(directory);
+    bool const passed = completed && baseline_report(&results[0], &results[1], options->alpha, options->threshold);
+    baseline_free(&results[0]);
+    baseline_free(&results[1]);
+    log_flush();
+    return passed;
+}
+
+/*
+ * Compares the benchmark results of this run with the baseline file given by --baseline.
+ */
+static bool runner_compare_baseline(runner_result const *results, udword count, runner_options const *options) {
+    baseline before = {0}, after = {0};
+    bool     passed = baseline_read(options->baseline, &before);
+
+    for (udword i = 0; i < count && passed; i++)
+        if (results[i].entry->kind == RUNNER_BENCHMARK && results[i].passed)
+            baseline_add(&after, results[i].entry->name, results[i].samples, results[i].repetitions);
+    passed = passed && baseline_report(&before, &after, options->alpha, options->threshold);
+
+    baseline_free(&before);
+    baseline_free(&after);
+    return passed;
+}
+
+bool runner_run(runner_entry const *entries, udword count, runner_options const *options) {
+    if (options->compare != NULL && !options->list)
+        return runner_compare_builds(options);
+
+    udword         passed = 0, failed = 0, ran = 0;
+    runner_result *results = calloc(count != 0 ? count : 1, sizeof(runner_result));
+    if (results == NULL)
+        fatalf(__func__, "unable to allocate %u results\n", count);
+
+    for (udword i = 0; i < count; i++) {
+        runner_entry const *entry = &entries[i];
+        if (!runner_selected(entry, options))
+            continue;
+        if (options->list) {
+            infof(__func__, "%s %s\n", entry->kind == RUNNER_TEST ? "test" : "benchmark", entry->name);
+            continue;
+        }
+
+        runner_result *result = &results[ran++];
+        uqword const   warnings = get_warning_count();
+        uqword const   start = p_get_time(NANOSECONDS);
+        result->entry = entry;
+
+        push_context((char *) entry->name);
+        if (entry->kind == RUNNER_TEST)
+            entry->test();
+        else
+            runner_benchmark(result, options);
+        pop_context();
+
+        result->nanoseconds = p_get_time(NANOSECONDS) - start;
+        result->passed = get_warning_count() == warnings;
+        runner_report(result);
+
+        if (result->passed)
+            passed++;
+        else
+            failed++;
+    }
+
+    if (!options->list)
+        infof(__func__, "%u passed, %u failed\n", passed, failed);
+    log_flush();
+    if (options->json != NULL && !options->list && !baseline_write(options->json, results, ran, options))
+        failed++;
+    if (options->baseline != NULL && !options->list && !runner_compare_baseline(results, ran, options))
+        failed++;
+
+    for (udword i = 0; i < ran; i++)
+        free(results[i].samples);
+    free(results);
+    log_flush();
+    return failed == 0;
+}
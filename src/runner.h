@@ -0,0 +1,124 @@
+/*
+ * Module: runner
+ * File: runner.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Runs registered tests and benchmarks selected by name. A test fails if it logs a warning (or exits through fatalf);
+ * a benchmark runs its body for a calibrated number of iterations per repetition, after warm-up repetitions, and
+ * reports the median and 99th percentile time per iteration, the throughput and, where available, hardware counters
+ * per iteration.
+ */
+
+#ifndef PROJECT_AQUINAS_RUNNER_H
+#define PROJECT_AQUINAS_RUNNER_H
+
+#include <stdbool.h>
+#include <platform.h>
+#include "perf.h"
+
+enum runner_kind {
+    RUNNER_TEST,
+    RUNNER_BENCHMARK
+};
+
+typedef struct runner_entry {
+    char const      *name;
+    enum runner_kind kind;
+    union {
+        void (*test)(void);
+        // runs the measured operation `iterations` times
+        void (*benchmark)(uqword iterations);
+    };
+} runner_entry;
+
+#define RUNNER_TEST(name, function) {(name), RUNNER_TEST, {.test = (function)}}
+#define RUNNER_BENCHMARK(name, function) {(name), RUNNER_BENCHMARK, {.benchmark = (function)}}
+
+/*
+ * Hides a value from the optimizer so that the computation which produces it is kept and a value passed through it
+ * is not treated as a constant.
+ */
+#define runner_keep(value) __asm__ volatile ("" : "+r" (value))
+
+typedef struct runner_options {
+    // measured repetitions of each benchmark, and unmeasured ones before them
+    udword repetitions;
+    udword warmup;
+    // nanoseconds one repetition should take at least; the iteration count is doubled until it does
+    uqword repetition_nanoseconds;
+    bool   list;
+    bool   counters;
+    // kinds which may be selected; without --tests, --benchmarks or --all these are every test when there are no
+    // patterns, and both kinds otherwise
+    bool   tests;
+    bool   benchmarks;
+    // globs over entry names ('*' and '?'); an entry runs if it matches any
+    char  **patterns;
+    udword  pattern_count;
+    // the program itself, for running it again in compare mode
+    char   *program;
+    // file to write the benchmark results to as JSON, a baseline to compare them with, or another build to compare
+    // this one with; NULL when not given
+    char   *json;
+    char   *baseline;
+    char   *compare;
+    // compare mode: rounds in which both builds run their benchmarks, alternating which goes first
+    udword  rounds;
+    // significance level and relative slowdown of the median from which a difference is a regression
+    double  alpha;
+    double  threshold;
+    // file to write a sampling profile of the run to, or NULL, and samples per second of CPU time
+    char   *profile;
+    udword  profile_frequency;
+} runner_options;
+
+typedef struct runner_result {
+    runner_entry const *entry;
+    bool                passed;
+    uqword              nanoseconds;
+    // benchmarks only: per iteration
+    uqword              iterations;
+    udword              repetitions;
+    double             *samples;
+    double              median;
+    double              p99;
+    // median absolute deviation of the samples
+    double              mad;
+    double              throughput;
+    perf_sample         counters;
+    // iterations counted by `counters`
+    uqword              counted_iterations;
+    // bytes and items the measured repetitions reported through runner_processed, per second; 0 when none
+    double              bytes_per_second;
+    double              items_per_second;
+    // bytes by which the peak resident set size of the process rose above its resident set when the benchmark began
+    uqword              peak_resident_growth;
+} runner_result;
+
+/*
+ * Called by a benchmark to count the bytes and items (tokens, entries, ...) it processed, so that its throughput is also
+ * reported in those units.
+ */
+void runner_processed(uqword bytes, uqword items);
+
+/*
+ * Parses the command line into `options`; unknown options are fatal. Arguments which are not options are patterns.
+ */
+void runner_parse(runner_options *options, int argc, char **argv);
+
+bool runner_glob(char const *pattern, char const *name);
+
+/*
+ * Runs every selected entry and returns whether all of them passed and, when comparing, none regressed. In compare
+ * mode nothing runs in this process: the benchmarks of this build and of the other one run in child processes,
+ * interleaved round by round so that drift in the machine's state affects both alike.
+ */
+bool runner_run(runner_entry const *entries, udword count, runner_options const *options);
+
+#endif //PROJECT_AQUINAS_RUNNER_H
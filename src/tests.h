@@ -14,26 +14,50 @@
 #ifndef PROJECT_AQUINAS_TESTS_H
 #define PROJECT_AQUINAS_TESTS_H
 
+#include <math.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <sched.h>
 #include <dynarray.h>
+#include <queue.h>
 #include <errhandlingapi.h>
 #include "state.h"
+#include "logger.h"
+#include "trace.h"
+#include "profile.h"
+#include "task.h"
+#include "file_reader.h"
+#include "emitter.h"
+#include "pipeline.h"
+#include "dictionary.h"
+#include "runner.h"
+#include "baseline.h"
+#include "memory/m_profile.h"
+#include "memory/m_epoch.h"
+#include "perf.h"
 #include "compiler.h"
 #include "bit_math.h"
+#include "bit_trie.h"
 #include "memory/memory.h"
 #include "data.h"
+#include "fp_math.h"
+#include "frc_math.h"
+#include "fix_math.h"
+#include "batch_math.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-function"
 
 static void test_expi(void) {
     for (ubyte i = 0; i < 45; i++) {
-        infof(__func__, "expi(%llu): %llu\n", i, expi(i));
+        r_debug("expi(%llu): %llu\n", i, expi(i));
     }
 }
 
 static void test_lni(void) {
     for (ubyte i = 0; i < 45; i++) {
-        infof(__func__, "floor_lni(%llu): %llu\n", expi(i), floor_lni(expi(i)));
+        r_debug("floor_lni(%llu): %llu\n", expi(i), floor_lni(expi(i)));
     }
 }
 
@@ -64,7 +88,7 @@ static void test_log10i(void) {
 
 static void test_sigbits(void) {
     for (uqword i = 0; i < 256; i++) {
-        infof(__func__, "sigbits(%llu): %llu\n", i, sigbits(i));
+        r_debug("sigbits(%llu): %llu\n", i, sigbits(i));
     }
 }
 
@@ -96,7 +120,7 @@ static void test_to_digits(void) {
     ubyte digits[20];
     for (ubyte i = 19; i < 20; i--) {
         digits[i] = (ubyte) get_digit10i(value, i);
-        infof(__func__, "digit[%llu] = %llu\n", i, digits[i]);
+        r_debug("digit[%llu] = %llu\n", i, digits[i]);
     }
 }
 
@@ -119,17 +143,227 @@ static void test_dynarray(void) {
 static void test_map(void) {
 }
 
+static void test_cpu_topology(void) {
+    info(__func__, "beginning CPU topology test\n");
+    static char const *const names[P_CACHE_LEVELS] = {
+            [P_CACHE_L1_DATA] = "L1d", [P_CACHE_L1_INSTRUCTION] = "L1i", [P_CACHE_L2] = "L2", [P_CACHE_L3] = "L3"
+    };
+
+    p_cpu_topology const *topology = p_get_cpu_topology();
+    infof(__func__, "logical cores: %u, physical cores: %u, packages: %u, line size: %u\n", topology->logical_cores,
+          topology->physical_cores, topology->packages, topology->line_size);
+    for (ubyte level = 0; level < P_CACHE_LEVELS; level++) {
+        p_cache_info const *cache = &topology->caches[level];
+        infof(__func__, "%s: %llu bytes, %u byte lines, %u ways, shared by %u\n", names[level], cache->size,
+              cache->line_size, cache->associativity, cache->shared_by);
+    }
+
+    udword siblings[8];
+    for (udword cpu = 0; cpu < topology->logical_cores; cpu++) {
+        udword const count = p_get_cpu_siblings(cpu, siblings, 8);
+        if (count == 0 || count > topology->logical_cores)
+            warnf(__func__, "processor %u has %u siblings\n", cpu, count);
+        r_debug("processor %u: core %u, %u siblings\n", cpu, topology->core_of[cpu], count);
+    }
+
+    p_tuning const *tuning = p_get_tuning();
+    if (tuning->workers == 0 || tuning->workers > topology->physical_cores)
+        warnf(__func__, "%u workers for %u physical cores\n", tuning->workers, topology->physical_cores);
+    infof(__func__, "line size: %u bytes, workers: %u\n", tuning->line_size, tuning->workers);
+    info(__func__, "CPU topology test complete\n");
+}
+
+static void test_timer(void) {
+    info(__func__, "beginning timer test\n");
+    infof(__func__, "cycle frequency: %llu Hz, invariant: %s\n", p_get_cycle_frequency(),
+          p_get_cycles_invariant() ? "yes" : "no");
+
+    uqword const count = 1000000;
+    uqword       previous = p_get_time(NANOSECONDS);
+    uqword const start = previous;
+    for (uqword i = 0; i < count; i++) {
+        uqword const now = p_get_time(NANOSECONDS);
+        if (now < previous)
+            warnf(__func__, "time went backwards by %llu ns\n", previous - now);
+        previous = now;
+    }
+    infof(__func__, "p_get_time: %.2f ns\n", (double) (previous - start) / (double) count);
+
+    uqword overhead = UINT64_MAX;
+    for (uqword i = 0; i < 1000; i++) {
+        uqword const begin = p_get_cycles_begin();
+        uqword const cycles = p_get_cycles_end() - begin;
+        overhead = cycles < overhead ? cycles : overhead;
+    }
+    infof(__func__, "empty region: %llu cycles (%llu ns)\n", overhead, p_cycles_to_nanoseconds(overhead));
+    info(__func__, "timer test complete\n");
+}
+
+static void test_perf_counters(void) {
+    info(__func__, "beginning hardware counter test\n");
+
+    perf_group group;
+    if (!perf_group_open(&group))
+        warnf(__func__, "no hardware counters are available; samples will be empty\n");
+
+    uqword          values[4096];
+    perf_sample     sample;
+    uqword volatile sum = 0;
+    perf_group_begin(&group);
+    for (uqword pass = 0; pass < 256; pass++)
+        for (uqword i = 0; i < 4096; i++)
+            sum += values[(i * 521u) & 4095u] = i ^ pass;
+    perf_group_end(&group, &sample);
+    perf_group_close(&group);
+
+    for (ubyte counter = 0; counter < PERF_COUNTERS; counter++) {
+        if (sample.valid[counter])
+            infof(__func__, "%s: %llu\n", perf_counter_name(counter), sample.values[counter]);
+        else
+            infof(__func__, "%s: unavailable\n", perf_counter_name(counter));
+    }
+    if (sample.valid[PERF_CYCLES] && sample.valid[PERF_INSTRUCTIONS] && sample.values[PERF_CYCLES] != 0)
+        infof(__func__, "instructions per cycle: %.2f (on the processor %.0f%% of the time)\n",
+              (double) sample.values[PERF_INSTRUCTIONS] / (double) sample.values[PERF_CYCLES], sample.running * 100);
+    info(__func__, "hardware counter test complete\n");
+}
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+/*
+ * Returns the exit status of this program listing its entries with `argument`; runner_parse ends the process on a
+ * malformed argument, so it is parsed in a process of its own.
+ */
+static int test_runner_status(char *argument) {
+    char *argv[] = {"/proc/self/exe", "--list", argument, NULL};
+    return p_run_process(argv);
+}
+#endif
+
+static void test_runner(void) {
+    info(__func__, "beginning runner test\n");
+
+    static struct {
+        char const *pattern;
+        char const *name;
+        bool        match;
+    } const globs[] = {
+            {"*", "frc_pack", true},           {"*", "", true},
+            {"frc_*", "frc_pack", true},       {"frc_*", "frc_", true},
+            {"frc_*", "fix_math", false},      {"frc_*", "frc", false},
+            {"*_math", "fix_math", true},      {"*_math", "fix_math_2", false},
+            {"f*_*k", "frc_pack", true},       {"f*_*k", "frc_packs", false},
+            {"l?x", "lex", true},              {"l?x", "lx", false},
+            {"lex", "lex", true},              {"lex", "lexer", false},
+            {"nothing*", "frc_pack", false},   {"", "", true},
+            {"", "lex", false},                {"**", "lex", true},
+    };
+    for (udword i = 0; i < sizeof(globs) / sizeof(globs[0]); i++)
+        if (runner_glob(globs[i].pattern, globs[i].name) != globs[i].match)
+            warnf(__func__, "'%s' %s '%s'\n", globs[i].pattern, globs[i].match ? "does not match" : "matches",
+                  globs[i].name);
+
+    // options and patterns may come in any order; a pattern without a kind selects both
+    runner_options options;
+    char          *patterns[] = {"test_runner", "frc_*", "--repetitions=0", "--min-time=2", "lex", "--no-counters",
+                                 "--threshold=5", NULL};
+    runner_parse(&options, 7, patterns);
+    if (options.pattern_count != 2 || strcmp(options.patterns[0], "frc_*") != 0 ||
+        strcmp(options.patterns[1], "lex") != 0 || !options.tests || !options.benchmarks)
+        warnf(__func__, "parsed %u patterns of tests %d and benchmarks %d; expected frc_* and lex of both\n",
+              options.pattern_count, options.tests, options.benchmarks);
+    if (options.repetitions != 1 || options.repetition_nanoseconds != 2000000 || options.counters ||
+        options.threshold != 0.05)
+        warnf(__func__, "parsed %u repetitions of %llu ns, counters %d and a threshold of %g\n", options.repetitions,
+              (unsigned long long) options.repetition_nanoseconds, options.counters, options.threshold);
+
+    // without patterns or a kind, every test and no benchmark runs
+    char *none[] = {"test_runner", "--json=out.json", NULL};
+    runner_parse(&options, 2, none);
+    if (options.pattern_count != 0 || !options.tests || options.benchmarks || strcmp(options.json, "out.json") != 0)
+        warnf(__func__, "parsed %u patterns of tests %d and benchmarks %d writing to %s; expected every test\n",
+              options.pattern_count, options.tests, options.benchmarks, options.json);
+
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+    // /proc/self/exe is Linux's; elsewhere the program cannot find itself and the malformed arguments go untested
+    char *malformed[] = {"--bogus", "--repetitions=ten", "--repetitions=", "--warmup=3x", "--alpha=-1",
+                         "--threshold=", "--rounds=1.5", "--"};
+    int const status = test_runner_status("--warmup=3");
+    if (status == -1)
+        info(__func__, "unable to run this program again; malformed arguments are not tested\n");
+    else if (status != 0)
+        warnf(__func__, "'--warmup=3' was rejected\n");
+    for (udword i = 0; status == 0 && i < sizeof(malformed) / sizeof(malformed[0]); i++)
+        if (test_runner_status(malformed[i]) != R_FAILURE)
+            warnf(__func__, "'%s' was not rejected\n", malformed[i]);
+#endif
+    info(__func__, "runner test complete\n");
+}
+
+static void test_baseline(void) {
+    info(__func__, "beginning baseline test\n");
+
+    // samples of at most six significant digits survive the %.6g of the file exactly
+    double               parse[] = {120.5, 118.25, 131, 119.75, 2048};
+    double               lex[] = {0.5, 0.25, 1e-3};
+    runner_entry const   entries[] = {RUNNER_BENCHMARK("parse", NULL), RUNNER_BENCHMARK("lex", NULL),
+                                      RUNNER_BENCHMARK("failed", NULL), RUNNER_TEST("test", NULL)};
+    runner_result        results[4] = {
+            {.entry = &entries[0], .passed = true, .repetitions = 5, .samples = parse},
+            {.entry = &entries[1], .passed = true, .repetitions = 3, .samples = lex},
+            {.entry = &entries[2], .passed = false, .repetitions = 3, .samples = lex},
+            {.entry = &entries[3], .passed = true}};
+    runner_options const options = {.repetitions = 5, .warmup = 1};
+
+    // a second read pools its samples with the first
+    baseline read = {0};
+    if (!baseline_write("test_baseline.json", results, 4, &options) || !baseline_read("test_baseline.json", &read) ||
+        !baseline_read("test_baseline.json", &read))
+        warnf(__func__, "unable to write and read test_baseline.json\n");
+    remove("test_baseline.json");
+
+    baseline_entry const *parsed = baseline_find(&read, "parse"), *lexed = baseline_find(&read, "lex");
+    if (read.count != 2 || parsed == NULL || lexed == NULL || parsed->count != 10 || lexed->count != 6)
+        warnf(__func__, "read %u benchmarks; expected parse with 10 samples and lex with 6\n", read.count);
+    else
+        for (udword i = 0; i < 10; i++)
+            if (parsed->samples[i] != parse[i % 5] || (i < 6 && lexed->samples[i] != lex[i % 3]))
+                warnf(__func__, "sample %u differs after the round trip\n", i);
+    baseline_free(&read);
+
+    // before {1, 2, 2, 3} and after {2, 3, 4, 5} rank 1, 3, 3, 3, 5.5, 5.5, 7, 8: the ranks of after sum to 23.5, so
+    // U = 23.5 - 4 * 5 / 2 = 13.5 against a mean of 8; ties of 3 and 2 give a variance of
+    // 16 / 12 * (9 - (24 + 6) / 56) = 11.2857, and with the continuity correction z = 5 / sqrt(11.2857) = 1.48835
+    double         before_samples[] = {1, 2, 2, 3}, after_samples[] = {2, 3, 4, 5};
+    baseline_entry before = {"before", before_samples, 4, 4}, after = {"after", after_samples, 4, 4};
+    baseline_comparison const comparison = baseline_compare(&before, &after);
+    if (comparison.before != 2 || comparison.after != 3.5 || comparison.ratio != 1.75 ||
+        fabs(comparison.p - 0.1366582477) > 1e-9)
+        warnf(__func__, "medians %g and %g (ratio %g, p = %.10f); expected 2 and 3.5 (1.75, p = 0.1366582477)\n",
+              comparison.before, comparison.after, comparison.ratio, comparison.p);
+    if (fabs(baseline_compare(&after, &before).p - comparison.p) > 1e-12)
+        warnf(__func__, "the p-value depends on the order of the samples\n");
+    if (baseline_compare(&before, &before).p != 1)
+        warnf(__func__, "identical samples are significantly different\n");
+    // every sample tied: no variance, so nothing can be told apart
+    after_samples[0] = after_samples[1] = after_samples[2] = after_samples[3] = 7;
+    before_samples[0] = before_samples[1] = before_samples[2] = before_samples[3] = 7;
+    if (baseline_compare(&before, &after).p != 1)
+        warnf(__func__, "tied samples are significantly different\n");
+
+    info(__func__, "baseline test complete\n");
+}
+
 static void test_square_wave(void) {
     info(__func__, "beginning test of square_wave()\n");
 
     for (ubyte i = 0; i < 32; i++) {
-        infof(__func__, "square_wave(period=3, time=loop_index) = %u\n", square_wave(3, i));
+        r_debug("square_wave(period=3, time=loop_index) = %u\n", square_wave(3, i));
     }
 
     info(__func__, "-----------------------\n");
 
     for (ubyte i = 0; i < 32; i++) {
-        infof(__func__, "square_wave_ext(period=2, time=loop_index) = %u\n", square_wave_ext(2, i));
+        r_debug("square_wave_ext(period=2, time=loop_index) = %u\n", square_wave_ext(2, i));
     }
 
     info(__func__, "square_wave() test complete\n");
@@ -159,13 +393,13 @@ static void test_umod(void) {
 
     for (uword i = 1; i < 257; i++) {
         for (uword j = 0; j < 256; j++) {
-            infof(__func__, "umod(): %u %% %u = %u\n", j, i, umodq(j, i));
+            r_debug_every(251, "umod(): %u %% %u = %u\n", j, i, umodq(j, i));
         }
     }
 
-    for (uword i = 0; i < 256; i++) {
+    for (uword i = 1; i < 257; i++) {
         for (uword j = 0; j < 256; j++) {
-            infof(__func__, "using modulus C syntax: %u %% %u = %u\n", j, i, j % i);
+            r_debug_every(251, "using modulus C syntax: %u %% %u = %u\n", j, i, j % i);
         }
     }
 
@@ -173,6 +407,1174 @@ static void test_umod(void) {
 }
 
 static void test_fp_math(void) {
+    info(__func__, "beginning configurable-precision floating point test\n");
+    infof(__func__, "layout: mantissa_bits=%u, exponent_bits=%u, hardware=%s\n", FP_MANTISSA_BITS, FP_EXPONENT_BITS,
+#ifdef FP_HARDWARE_DATATYPE
+          "yes"
+#else
+          "no"
+#endif
+    );
+
+    fp_float a = fp_from_double(1.5);
+    fp_float b = fp_from_double(-2.25);
+    infof(__func__, "1.5 + -2.25 = %g\n", fp_to_double(fp_add(a, b)));
+    infof(__func__, "1.5 - -2.25 = %g\n", fp_to_double(fp_sub(a, b)));
+    infof(__func__, "1.5 * -2.25 = %g\n", fp_to_double(fp_mul(a, b)));
+    infof(__func__, "1.5 / -2.25 = %g\n", fp_to_double(fp_div(a, b)));
+
+    // the software engine must agree bit for bit with the hardware on the IEEE 754 layouts
+    machine_double const values[] = {0.0, -0.0, 1.0, 0.1, -3.75, 1e308, 4.9e-324, 2.2250738585072009e-308, 1.0 / 3.0};
+    uqword const count = sizeof(values) / sizeof(values[0]);
+    uqword mismatches = 0;
+    for (uqword i = 0; i < count; i++) {
+        for (uqword j = 0; j < count; j++) {
+            union { machine_double value; uqword bits; } x = {.value = values[i]}, y = {.value = values[j]};
+            union { machine_double value; uqword bits; } sum = {.value = x.value + y.value};
+            union { machine_double value; uqword bits; } product = {.value = x.value * y.value};
+            mismatches += sum.bits != fp_soft_add(FP_FORMAT_BINARY64, x.bits, y.bits);
+            mismatches += product.bits != fp_soft_mul(FP_FORMAT_BINARY64, x.bits, y.bits);
+            if (y.value != 0.0) {
+                union { machine_double value; uqword bits; } quotient = {.value = x.value / y.value};
+                mismatches += quotient.bits != fp_soft_div(FP_FORMAT_BINARY64, x.bits, y.bits);
+            }
+        }
+    }
+    if (mismatches)
+        warnf(__func__, "software engine disagrees with hardware binary64 in %llu cases\n", mismatches);
+
+    // a bfloat16 layout (7 mantissa bits, 8 exponent bits) has no hardware path
+    fp_format const bfloat16 = {.mantissa_bits = 7, .exponent_bits = 8};
+    uqword const third = fp_soft_div(bfloat16, fp_soft_from_qword(bfloat16, 1), fp_soft_from_qword(bfloat16, 3));
+    union { machine_double value; uqword bits; } widened = {.bits = fp_soft_convert(FP_FORMAT_BINARY64, bfloat16, third)};
+    infof(__func__, "bfloat16 1/3 = %#llx (%g)\n", third, widened.value);
+
+    info(__func__, "floating point test complete\n");
+}
+
+static void test_frc_literals(void) {
+    info(__func__, "beginning floating point literal conversion test\n");
+    char const *literals[] = {"0.1", "1e23", "-2.2250738585072011e-308", "4.9e-324", "1.7976931348623157e308",
+                              "123456789012345678901234567890", "3.4028235e38", "inf", "-0", "nan"};
+    char buffer[FRC_PRINT_BUFFER_SIZE];
+
+    for (uqword i = 0; i < sizeof(literals) / sizeof(literals[0]); i++) {
+        char const *literal = literals[i];
+        char const *last = literal + strlen(literal);
+        ieee_float64 parsed64 = {.bits = 0};
+        ieee_float32 parsed32 = {.bits = 0};
+
+        if (frc_parse_dbl(literal, last, &parsed64) != last || frc_parse_flt(literal, last, &parsed32) != last)
+            warnf(__func__, "literal was not fully consumed: %s\n", literal);
+        if (parsed64.value == parsed64.value && parsed64.value != strtod(literal, NULL))
+            warnf(__func__, "frc_parse_dbl disagrees with strtod: %s\n", literal);
+
+        frc_print_dbl(parsed64, buffer);
+        infof(__func__, "%s -> double %s", literal, buffer);
+        frc_print_flt(parsed32, buffer);
+        infof(__func__, ", float %s\n", buffer);
+    }
+
+    info(__func__, "floating point literal conversion test complete\n");
+}
+
+/*
+ * Terms too wide for the 57 bits of a frac_t: the packed value must stay within the precision left, however the width
+ * is split between numerator and denominator.
+ */
+static void test_frc_pack(void) {
+    info(__func__, "beginning fraction packing test\n");
+    struct {
+        dqword  numerator;
+        udqword denominator;
+    } const cases[] = {
+            {((dqword) 1 << 55) + 7, 7},
+            {-(((dqword) 1 << 55) + 7), 7},
+            {((dqword) 1 << 60) + 1, ((udqword) 1 << 40) + 3},
+            {((dqword) 1 << 40) + 3, ((udqword) 1 << 60) + 1},
+            {((dqword) 1 << 90) + 5, ((udqword) 1 << 45) + 9},
+    };
+    for (uqword i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        frac_t const packed = frc_pack(cases[i].numerator, cases[i].denominator);
+        double const expected = (double) cases[i].numerator / (double) cases[i].denominator;
+        double const actual = (double) frc_rdnum(packed) / (double) frc_rdden(packed);
+        // 57 bits split over two terms leave at least 27 for the narrower one
+        double const error = actual > expected ? actual - expected : expected - actual;
+        if (error > (expected < 0 ? -expected : expected) * 1e-8)
+            warnf(__func__, "case %llu: packed to %.17g, expected %.17g\n", (unsigned long long) i, actual, expected);
+    }
+    info(__func__, "fraction packing test complete\n");
+}
+
+static void test_fix_math(void) {
+    info(__func__, "beginning fixed point test\n");
+    infof(__func__, "layout: Q%u.%u\n", 127 - FIX_FRACTION_BITS, FIX_FRACTION_BITS);
+
+    fix_t const a = fix_from_parts(3, 0x8000000000000000);
+    fix_t const b = fix_from_int(-2);
+    infof(__func__, "3.5 * -2 = %g\n", fix_to_double(fix_mul(a, b)));
+    infof(__func__, "3.5 / -2 = %g\n", fix_to_double(fix_div(a, b)));
+    infof(__func__, "sqrt(2) = %.17g\n", fix_to_double(fix_sqrt(fix_from_int(2))));
+    infof(__func__, "log2(10) = %.17g\n", fix_to_double(fix_log2(fix_from_int(10))));
+    infof(__func__, "exp2(0.5) = %.17g\n", fix_to_double(fix_exp2(fix_from_parts(0, 0x8000000000000000))));
+    infof(__func__, "lerp(-2, 3.5, 0.5) = %g\n", fix_to_double(fix_lerp(b, a, fix_from_parts(0, 0x8000000000000000))));
+
+    // exact identities which hold in every layout and rounding mode
+    uqword failures = 0;
+    failures += fix_mul(fix_sqrt(fix_from_int(16)), fix_from_int(1)) != fix_from_int(4);
+    failures += fix_log2(fix_from_int(1024)) != fix_from_int(10);
+    failures += fix_exp2(fix_from_int(-3)) != fix_div(FIX_ONE, fix_from_int(8));
+    failures += fix_to_int(fix_from_parts(-3, 0x8000000000000000), FIX_ROUND_NEAREST_EVEN) != -2;
+    failures += fix_to_int(fix_from_parts(-3, 0x8000000000000000), FIX_ROUND_NEAREST_AWAY) != -3;
+    failures += fix_to_int(fix_from_parts(-3, 0x8000000000000000), FIX_ROUND_DOWN) != -3;
+    failures += fix_to_int(fix_from_parts(-3, 0x8000000000000000), FIX_ROUND_UP) != -2;
+    failures += fix_add_sat(FIX_MAX, FIX_ONE) != FIX_MAX;
+    failures += fix_mul_sat(FIX_MIN, fix_from_int(2)) != FIX_MIN;
+    failures += fix_div_sat(fix_from_int(-1), 0) != FIX_MIN;
+    if (failures)
+        warnf(__func__, "fixed point test failed: %llu identities do not hold\n", failures);
+
+    info(__func__, "fixed point test complete\n");
+}
+
+static void test_batch_math(void) {
+    info(__func__, "beginning batch arithmetic test\n");
+    // not a multiple of BATCH_LANES so that the scalar tail is exercised
+    enum { count = 4 * BATCH_LANES + 3 };
+    frac_t a[count], b[count], sum[count];
+    fix_t  x[count], y[count], product[count];
+    sbyte  order[count];
+    uqword mismatches = 0;
+
+    for (qword i = 0; i < count; i++) {
+        a[i] = frc((int32_t) (i * 7 - 40), (int32_t) (i + 1));
+        b[i] = frc((int32_t) (3 - i), (int32_t) (2 * i + 3));
+        x[i] = fix_from_parts(i - 9, 0x9E3779B97F4A7C15 * (uqword) i);
+        y[i] = fix_from_int(5 - i);
+    }
+
+    frc_batch_add(sum, a, b, count);
+    frc_batch_cmp(order, a, b, count);
+    for (uqword i = 0; i < count; i++)
+        mismatches += sum[i].value != frc_add(a[i], b[i]).value || order[i] != frc_cmp(a[i], b[i]);
+
+    fix_batch_mul(product, x, y, count);
+    fix_batch_cmp(order, x, y, count);
+    fix_t total = 0;
+    for (uqword i = 0; i < count; i++) {
+        mismatches += product[i] != fix_mul(x[i], y[i]) || order[i] != (x[i] > y[i]) - (x[i] < y[i]);
+        total = fix_add(total, x[i]);
+    }
+    mismatches += total != fix_batch_sum(x, count);
+
+    infof(__func__, "sum of %u fixed point values: %g\n", count, fix_to_double(total));
+    if (mismatches)
+        warnf(__func__, "batch kernels disagree with the scalar operations in %llu cases\n", mismatches);
+
+    info(__func__, "batch arithmetic test complete\n");
+}
+
+static void test_logger(void) {
+    info(__func__, "beginning logger test\n");
+    uqword const count = 100000;
+
+    uqword const start = p_get_time(NANOSECONDS);
+    for (uqword i = 0; i < count; i++)
+        infof(__func__, "record %llu of %llu: %s\n", i, count, i & 1u ? "odd" : "even");
+    uqword const submitted = p_get_time(NANOSECONDS);
+    log_flush();
+    uqword const written = p_get_time(NANOSECONDS);
+
+    infof(__func__, "submit: %.1f ns per record, write: %.1f ns per record\n",
+          (double) (submitted - start) / (double) count, (double) (written - submitted) / (double) count);
+    info(__func__, "logger test complete\n");
+}
+
+static void test_context_stack(void) {
+    info(__func__, "beginning context stack test\n");
+
+    uqword const depth = get_context_depth();
+    char *const  outer = get_context();
+
+    push_context("test_context_stack");
+    push_context("nested");
+    infof(__func__, "context: %s, previous: %s, depth: %llu\n", get_context(), get_previous_context(),
+          get_context_depth() - depth);
+    if (strcmp(get_context(), "nested") != 0 || strcmp(get_previous_context(), "test_context_stack") != 0)
+        warnf(__func__, "nested context test failed\n");
+    pop_context();
+    if (strcmp(get_context(), "test_context_stack") != 0 || strcmp(get_previous_context(), outer) != 0)
+        warnf(__func__, "pop context test failed\n");
+    pop_context();
+    if (get_context() != outer || get_context_depth() != depth)
+        warnf(__func__, "context stack is unbalanced\n");
+
+    uqword const count = 10000000;
+    uqword const start = p_get_time(NANOSECONDS);
+    for (uqword i = 0; i < count; i++) {
+        push_context("iteration");
+        pop_context();
+    }
+    infof(__func__, "push and pop: %.2f ns\n", (double) (p_get_time(NANOSECONDS) - start) / (double) count);
+    info(__func__, "context stack test complete\n");
+}
+
+/*
+ * Counts the back edges a depth-first search over the genus and whatness edges of `image` finds; 0 if it is acyclic.
+ */
+static uqword test_workload_back_edges(dictionary_image const *image) {
+    // 0 unvisited, 1 on the path, 2 finished; the path holds each identifier and the next of its two edges to follow
+    ubyte  *state = calloc(image->count, 1);
+    udword *path = malloc(image->count * 2 * sizeof(udword));
+    uqword  back_edges = 0;
+    for (udword root = 0; root < image->count; root++) {
+        if (state[root] != 0)
+            continue;
+        udword depth = 0;
+        path[0] = root;
+        path[1] = 0;
+        state[root] = 1;
+        while (depth != 0 || path[1] < 2) {
+            udword *const top = &path[2 * depth];
+            if (top[1] == 2) {
+                state[top[0]] = 2;
+                depth--;
+                continue;
+            }
+            dictionary_entry const *entry = &image->entries[top[0]];
+            udword const            next = top[1]++ == 0 ? entry->genus : entry->whatness;
+            if (next == DICTIONARY_NONE || state[next] == 2)
+                continue;
+            if (state[next] == 1) {
+                back_edges++;
+                continue;
+            }
+            state[next] = 1;
+            depth++;
+            path[2 * depth] = next;
+            path[2 * depth + 1] = 0;
+        }
+        state[root] = 2;
+    }
+    free(path);
+    free(state);
+    return back_edges;
+}
+
+static void test_workload(void) {
+    info(__func__, "beginning workload test\n");
+    char const *const lists[] = {"entries=5000,cycles=0", "entries=5000,cycles=50", "entries=5000,cycles=1000"};
+    for (udword i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+        workload_options options;
+        workload_defaults(&options);
+        workload_parse(&options, lists[i]);
+        workload_text text = {0};
+        workload_dictionary(&options, &text);
+        dictionary_image *image = dictionary_build(text.data, text.length);
+
+        // every edge of an ordinary definition points to an earlier identifier, so only the cycles can close one
+        uqword const back_edges = test_workload_back_edges(image);
+        if ((options.cycles == 0) != (back_edges == 0))
+            warnf(__func__, "%s: %llu cycles in the dictionary graph\n", lists[i], (unsigned long long) back_edges);
+        infof(__func__, "%s: %llu cycles\n", lists[i], (unsigned long long) back_edges);
+        dictionary_image_free(image);
+        workload_text_free(&text);
+    }
+    info(__func__, "workload test complete\n");
+}
+
+static void test_pipeline(void) {
+    info(__func__, "beginning pipeline test\n");
+    workload_options options;
+    workload_defaults(&options);
+    workload_parse(&options, "entries=20000,operands=5000");
+    workload_text input = {0};
+    workload_dictionary(&options, &input);
+    workload_text operands = {0};
+    workload_operands(&options, &operands);
+    workload_append(&input, operands.data, operands.length);
+    uqword const tokens = input.tokens + operands.tokens;
+
+    // small batches and a shallow pipeline, so that every stage waits on its neighbours many times over
+    context       metrics;
+    workload_text output = {0};
+    context_init(&metrics);
+    pipeline_text_result const result = pipeline_text(input.data, input.length, 512, 3, &output, &metrics);
+
+    if (result.tokens != tokens || result.statements != options.entries + options.operands)
+        warnf(__func__, "lexed %llu tokens in %llu statements; expected %llu in %llu\n",
+              (unsigned long long) result.tokens, (unsigned long long) result.statements, (unsigned long long) tokens,
+              (unsigned long long) (options.entries + options.operands));
+    if (output.length != input.length || memcmp(output.data, input.data, input.length) != 0)
+        warnf(__func__, "emitted text differs from the input\n");
+
+    c_metrics totals;
+    context_metrics(&metrics, &totals);
+    if (totals.counters[C_TOKENS_LEXED] != tokens || totals.counters[C_BYTES_EMITTED] != input.length)
+        warnf(__func__, "metrics do not match the pipeline\n");
+
+    // tokens longer than a batch are cut into parts, so only the characters outside whitespace survive
+    char const   text[] = "alpha := abcdefghijklmnopqrstuvwxyzabcdefghijklmnop;\nbeta := x;\n";
+    uqword const sizes[] = {2, 16, 17, 40};
+    for (uqword s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        workload_text              cut = {0};
+        pipeline_text_result const parts = pipeline_text(text, sizeof(text) - 1, sizes[s], 3, &cut, NULL);
+        uqword                     j = 0;
+        bool                       same = true;
+        for (uqword i = 0; i < sizeof(text) - 1 && same; i++) {
+            if (isspace((unsigned char) text[i]))
+                continue;
+            while (j < cut.length && isspace((unsigned char) cut.data[j]))
+                j++;
+            same = j < cut.length && cut.data[j++] == text[i];
+        }
+        while (same && j < cut.length && isspace((unsigned char) cut.data[j]))
+            j++;
+        if (!same || j != cut.length || parts.statements != 2)
+            warnf(__func__, "a token longer than a batch of %llu bytes was not cut cleanly\n",
+                  (unsigned long long) sizes[s]);
+        workload_text_free(&cut);
+    }
+
+    context_free(&metrics);
+    workload_text_free(&output);
+    workload_text_free(&operands);
+    workload_text_free(&input);
+    info(__func__, "pipeline test complete\n");
+}
+
+#define TEST_QUEUE_ITEMS 1000000u
+#define TEST_QUEUE_THREADS 4u
+
+static void *test_spsc_producer(void *argument) {
+    spsc_queue *queue = argument;
+    void       *batch[37];
+    for (uqword next = 1; next <= TEST_QUEUE_ITEMS;) {
+        // batches of 1 to 37 items
+        uqword const size = next % 37u + 1u;
+        uqword       count = 0;
+        for (; count < size && next + count <= TEST_QUEUE_ITEMS; count++)
+            batch[count] = (void *) (uintptr_t) (next + count);
+        for (uqword sent = 0; sent < count;) {
+            uqword const moved = spsc_enqueue(queue, batch + sent, count - sent);
+            if (moved == 0)
+                sched_yield();
+            sent += moved;
+        }
+        next += count;
+    }
+    return NULL;
+}
+
+static void *test_mpmc_producer(void *argument) {
+    mpmc_queue *queue = argument;
+    void       *batch[16];
+    for (uqword next = 1; next <= TEST_QUEUE_ITEMS; next += 16) {
+        for (uqword i = 0; i < 16; i++)
+            batch[i] = (void *) (uintptr_t) (next + i);
+        for (uqword sent = 0; sent < 16;) {
+            uqword const moved = mpmc_enqueue(queue, batch + sent, 16 - sent);
+            if (moved == 0)
+                sched_yield();
+            sent += moved;
+        }
+    }
+    return NULL;
+}
+
+typedef struct test_mpmc_consumer_state {
+    mpmc_queue     *queue;
+    _Atomic uqword *received;
+    _Atomic ubyte  *seen;
+} test_mpmc_consumer_state;
+
+static void *test_mpmc_consumer(void *argument) {
+    test_mpmc_consumer_state *state = argument;
+    void                     *batch[16];
+    uqword const              total = (uqword) (TEST_QUEUE_ITEMS + 15u) / 16u * 16u * TEST_QUEUE_THREADS;
+    while (atomic_load(state->received) < total) {
+        uqword const count = mpmc_dequeue(state->queue, batch, 16);
+        if (count == 0) {
+            sched_yield();
+            continue;
+        }
+        for (uqword i = 0; i < count; i++)
+            atomic_fetch_add_explicit(&state->seen[(uintptr_t) batch[i]], 1, memory_order_relaxed);
+        atomic_fetch_add(state->received, count);
+    }
+    return NULL;
+}
+
+static void test_queues(void) {
+    info(__func__, "beginning queue test\n");
+
+    // one producer and one consumer: every item arrives once and in order
+    spsc_queue *spsc = spsc_create(1000);
+    pthread_t   producers[TEST_QUEUE_THREADS], consumers[TEST_QUEUE_THREADS];
+    if (pthread_create(&producers[0], NULL, test_spsc_producer, spsc) != 0) {
+        warnf(__func__, "unable to create a thread\n");
+        return;
+    }
+    uqword expected = 1;
+    void  *batch[64];
+    while (expected <= TEST_QUEUE_ITEMS) {
+        uqword const count = spsc_dequeue(spsc, batch, 1 + expected % 64u);
+        if (count == 0)
+            sched_yield();
+        for (uqword i = 0; i < count; i++, expected++) {
+            if ((uintptr_t) batch[i] != expected) {
+                warnf(__func__, "spsc: received %llu, expected %llu\n", (unsigned long long) (uintptr_t) batch[i],
+                      (unsigned long long) expected);
+                expected = TEST_QUEUE_ITEMS + 1;
+                break;
+            }
+        }
+    }
+    pthread_join(producers[0], NULL);
+    spsc_free(spsc);
+
+    // several of each: every item arrives exactly once per producer
+    mpmc_queue              *mpmc = mpmc_create(256);
+    uqword const             items = (TEST_QUEUE_ITEMS + 15u) / 16u * 16u;
+    _Atomic uqword           received = 0;
+    test_mpmc_consumer_state state = {mpmc, &received, calloc(items + 1, sizeof(_Atomic ubyte))};
+    for (udword i = 0; i < TEST_QUEUE_THREADS; i++) {
+        pthread_create(&producers[i], NULL, test_mpmc_producer, mpmc);
+        pthread_create(&consumers[i], NULL, test_mpmc_consumer, &state);
+    }
+    for (udword i = 0; i < TEST_QUEUE_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+    for (uqword i = 1; i <= items; i++) {
+        if (atomic_load(&state.seen[i]) != TEST_QUEUE_THREADS) {
+            warnf(__func__, "mpmc: item %llu arrived %u times\n", (unsigned long long) i,
+                  (udword) atomic_load(&state.seen[i]));
+            break;
+        }
+    }
+    free(state.seen);
+    mpmc_free(mpmc);
+    info(__func__, "queue test complete\n");
+}
+
+#define TEST_FILE_READER_FILES 64
+
+typedef struct test_file_reader_job {
+    char const *const    *paths;
+    enum file_reader_mode mode;
+    enum file_reader_mode used;
+    mpmc_queue           *queue;
+} test_file_reader_job;
+
+static void *test_file_reader_thread(void *argument) {
+    test_file_reader_job *job = argument;
+    job->used = file_read_all(job->paths, TEST_FILE_READER_FILES + 1, 8, job->mode, job->queue);
+    return NULL;
+}
+
+/*
+ * Lengths from empty to several times the first buffer, so that reads both stop short and grow the buffer.
+ */
+static uqword test_file_reader_length(udword index) {
+    return (uqword) index * 997u % (4u * FILE_READER_BUFFER);
+}
+
+static void test_file_reader(void) {
+    info(__func__, "beginning file reader test\n");
+    char       names[TEST_FILE_READER_FILES + 1][48];
+    char const *paths[TEST_FILE_READER_FILES + 1];
+    char       *data = malloc(4u * FILE_READER_BUFFER);
+    for (udword i = 0; i <= TEST_FILE_READER_FILES; i++) {
+        snprintf(names[i], sizeof(names[i]), "test_file_reader_%u.ad", i);
+        paths[i] = names[i];
+        if (i == TEST_FILE_READER_FILES)
+            break;
+        uqword const length = test_file_reader_length(i);
+        for (uqword j = 0; j < length; j++)
+            data[j] = (char) ('a' + (i + j) % 26u);
+        FILE *file = fopen(names[i], "wb");
+        if (!file || fwrite(data, 1, length, file) != length)
+            fatalf(__func__, "unable to write %s\n", names[i]);
+        fclose(file);
+    }
+
+    // the last path is never written, and must arrive with an error
+    enum file_reader_mode const modes[] = {FILE_READER_AUTO, FILE_READER_THREADS};
+    for (udword m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        mpmc_queue          *queue = mpmc_create(4);
+        test_file_reader_job job = {paths, modes[m], FILE_READER_AUTO, queue};
+        pthread_t            thread;
+        if (pthread_create(&thread, NULL, test_file_reader_thread, &job) != 0)
+            fatalf(__func__, "unable to create a thread\n");
+
+        ubyte seen[TEST_FILE_READER_FILES + 1] = {0};
+        for (udword received = 0; received <= TEST_FILE_READER_FILES;) {
+            void *item;
+            if (mpmc_dequeue(queue, &item, 1) == 0) {
+                sched_yield();
+                continue;
+            }
+            file_buffer *buffer = item;
+            udword const i = buffer->index;
+            received++;
+            seen[i]++;
+            if (i == TEST_FILE_READER_FILES) {
+                if (buffer->error == 0)
+                    warnf(__func__, "read a file which does not exist\n");
+                file_buffer_free(buffer);
+                continue;
+            }
+            bool matches = buffer->error == 0 && buffer->length == test_file_reader_length(i);
+            for (uqword j = 0; matches && j < buffer->length; j++)
+                matches = buffer->data[j] == (char) ('a' + (i + j) % 26u);
+            if (!matches)
+                warnf(__func__, "mode %u: %s arrived with error %d and %llu bytes, or wrong ones\n", (udword) job.mode,
+                      paths[i], buffer->error, (unsigned long long) buffer->length);
+            file_buffer_free(buffer);
+        }
+        pthread_join(thread, NULL);
+        for (udword i = 0; i <= TEST_FILE_READER_FILES; i++)
+            if (seen[i] != 1)
+                warnf(__func__, "file %u arrived %u times\n", i, (udword) seen[i]);
+        info(__func__, "mode %u read through mode %u\n", (udword) modes[m], (udword) job.used);
+        mpmc_free(queue);
+    }
+
+    for (udword i = 0; i < TEST_FILE_READER_FILES; i++)
+        remove(names[i]);
+    free(data);
+
+    // procfs hands out a page or so per read: a read which stops short is not the end of the file
+    char const *procfs[] = {"/proc/kallsyms"};
+    FILE       *file = fopen(procfs[0], "rb");
+    if (file) {
+        char   block[4096];
+        uqword length = 0, read;
+        while ((read = fread(block, 1, sizeof(block), file)) != 0)
+            length += read;
+        fclose(file);
+        for (udword m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+            mpmc_queue *queue = mpmc_create(4);
+            void       *item;
+            file_read_all(procfs, 1, 1, modes[m], queue);
+            if (mpmc_dequeue(queue, &item, 1) == 1) {
+                file_buffer *buffer = item;
+                if (buffer->error != 0 || buffer->length != length)
+                    warnf(__func__, "mode %u: %s arrived with error %d and %llu of %llu bytes\n", (udword) modes[m],
+                          procfs[0], buffer->error, (unsigned long long) buffer->length, (unsigned long long) length);
+                file_buffer_free(buffer);
+            }
+            mpmc_free(queue);
+        }
+    }
+    info(__func__, "file reader test complete\n");
+}
+
+#define TEST_EMITTER_TOKENS 200000
+
+typedef struct test_emitter_writer {
+    emitter  *output;
+    uqword    sum;
+    pthread_t thread;
+} test_emitter_writer;
+
+static uqword test_emitter_token(uqword i, char *token) {
+    uqword const length = 1 + i % 11u;
+    for (uqword j = 0; j < length; j++)
+        token[j] = (char) ('a' + (i + j) % 26u);
+    return length;
+}
+
+static void *test_emitter_thread(void *argument) {
+    test_emitter_writer *writer = argument;
+    emitter_stream      *stream = emitter_stream_create(writer->output);
+    char                 token[16];
+    for (uqword i = 0; i < TEST_EMITTER_TOKENS; i++) {
+        uqword const length = test_emitter_token(i, token);
+        emitter_put(stream, token, length);
+        for (uqword j = 0; j < length; j++)
+            writer->sum += (ubyte) token[j];
+    }
+    emitter_stream_free(stream);
+    return NULL;
+}
+
+static void test_emitter(void) {
+    info(__func__, "beginning emitter test\n");
+    // a slice larger than a stream's buffer, referenced in place between copied tokens
+    uqword const large_length = EMITTER_BUFFER + 4097u;
+    char        *large = malloc(large_length);
+    for (uqword i = 0; i < large_length; i++)
+        large[i] = (char) ('A' + i % 26u);
+
+    enum emitter_mode const modes[] = {EMITTER_WRITEV, EMITTER_MMAP};
+    for (udword m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        // one stream: the file holds exactly what was put, in order
+        emitter *output = emitter_open("test_emitter.out", modes[m]);
+        if (!output) {
+            warnf(__func__, "mode %u: unable to open the output\n", (udword) modes[m]);
+            break;
+        }
+        emitter_stream *stream = emitter_stream_create(output);
+        char            token[16];
+        uqword          expected = 0;
+        for (uqword i = 0; i < TEST_EMITTER_TOKENS; i++) {
+            uqword const length = test_emitter_token(i, token);
+            if (i % 1000u == 0)
+                emitter_put_reference(stream, " ", 1);
+            emitter_put(stream, token, length);
+            expected += length + (i % 1000u == 0);
+            if (i == TEST_EMITTER_TOKENS / 2) {
+                emitter_put(stream, large, large_length);
+                expected += large_length;
+            }
+        }
+        emitter_stream_free(stream);
+        if (!emitter_close(output))
+            warnf(__func__, "mode %u: a write failed\n", (udword) modes[m]);
+
+        FILE *file = fopen("test_emitter.out", "rb");
+        char *data = malloc(expected + 1);
+        uqword const length = file ? fread(data, 1, expected + 1, file) : 0;
+        if (file)
+            fclose(file);
+        bool matches = length == expected;
+        for (uqword i = 0, at = 0; matches && i < TEST_EMITTER_TOKENS; i++) {
+            uqword const token_length = test_emitter_token(i, token);
+            if (i % 1000u == 0)
+                matches = data[at++] == ' ';
+            matches = matches && memcmp(data + at, token, token_length) == 0;
+            at += token_length;
+            if (i == TEST_EMITTER_TOKENS / 2) {
+                matches = matches && memcmp(data + at, large, large_length) == 0;
+                at += large_length;
+            }
+        }
+        if (!matches)
+            warnf(__func__, "mode %u: wrote %llu bytes, expected %llu, or the wrong ones\n", (udword) modes[m],
+                  (unsigned long long) length, (unsigned long long) expected);
+        free(data);
+
+        // two streams on threads of their own: their flushes interleave, but no byte is lost or doubled
+        if (!(output = emitter_open("test_emitter.out", modes[m]))) {
+            warnf(__func__, "mode %u: unable to open the output again\n", (udword) modes[m]);
+            break;
+        }
+        test_emitter_writer writers[2] = {{output}, {output}};
+        for (udword i = 0; i < 2; i++)
+            if (pthread_create(&writers[i].thread, NULL, test_emitter_thread, &writers[i]) != 0)
+                fatalf(__func__, "unable to create a thread\n");
+        for (udword i = 0; i < 2; i++)
+            pthread_join(writers[i].thread, NULL);
+        emitter_close(output);
+
+        uqword sum = 0, bytes = 0;
+        int    c;
+        file = fopen("test_emitter.out", "rb");
+        while (file && (c = fgetc(file)) != EOF) {
+            sum += (ubyte) c;
+            bytes++;
+        }
+        if (file)
+            fclose(file);
+        uqword const tokens = expected - large_length - TEST_EMITTER_TOKENS / 1000u;
+        if (sum != writers[0].sum + writers[1].sum || bytes != 2 * tokens)
+            warnf(__func__, "mode %u: threads wrote %llu bytes with the wrong contents\n", (udword) modes[m],
+                  (unsigned long long) bytes);
+    }
+
+    remove("test_emitter.out");
+    free(large);
+    info(__func__, "emitter test complete\n");
+}
+
+#define TEST_DICTIONARY_READERS 2
+#define TEST_DICTIONARY_SWAPS 20
+
+typedef struct test_dictionary_state {
+    dictionary          *dict;
+    workload_text const *operands;
+    uqword               expected;
+    atomic_bool          done;
+    _Atomic uqword       passes;
+    _Atomic uqword       failures;
+} test_dictionary_state;
+
+static void *test_dictionary_reader(void *argument) {
+    test_dictionary_state *state = argument;
+    while (!atomic_load(&state->done)) {
+        if (dictionary_convert_text(state->dict, state->operands->data, state->operands->length, NULL) !=
+            state->expected)
+            atomic_fetch_add(&state->failures, 1);
+        atomic_fetch_add(&state->passes, 1);
+    }
+    return NULL;
+}
+
+static void test_dictionary(void) {
+    info(__func__, "beginning dictionary test\n");
+    workload_options options;
+    workload_defaults(&options);
+    workload_parse(&options, "entries=5000,operands=1000");
+    workload_text text = {0}, operands = {0};
+    workload_dictionary(&options, &text);
+    workload_operands(&options, &operands);
+
+    dictionary_image *image = dictionary_build(text.data, text.length);
+    if (image->count != options.entries)
+        warnf(__func__, "built %u of %u identifiers\n", image->count, options.entries);
+    if (dictionary_find(image, "zzzzzzzzzz", 10) != DICTIONARY_NONE ||
+        dictionary_convert(image, "zzzzzzzzzz", 10, NULL) != DICTIONARY_NONE)
+        warnf(__func__, "found an undefined identifier\n");
+    // a child is never a root, so an operand which starts from one does not convert
+    for (udword i = 0; i < image->count; i++) {
+        if (image->entries[i].genus == DICTIONARY_NONE)
+            continue;
+        if (dictionary_convert(image, image->names + image->entries[i].name, image->entries[i].length, NULL) !=
+            DICTIONARY_NONE)
+            warnf(__func__, "converted an operand which starts below a root\n");
+        break;
+    }
+
+    // conversions keep running against whichever image they load while new ones are swapped in under them
+    dictionary            dict;
+    context               metrics;
+    test_dictionary_state state = {&dict, &operands, options.operands};
+    dictionary_init(&dict, image);
+    context_init(&metrics);
+    if (dictionary_convert_text(&dict, operands.data, operands.length, &metrics) != options.operands)
+        warnf(__func__, "converted fewer than %u operands\n", options.operands);
+    c_metrics totals;
+    context_metrics(&metrics, &totals);
+    if (totals.counters[C_CONVERSIONS] != options.operands || totals.counters[C_DICTIONARY_MISSES] != 0 ||
+        totals.counters[C_DICTIONARY_HITS] != operands.tokens - options.operands)
+        warnf(__func__, "metrics do not match the conversions\n");
+    context_free(&metrics);
+
+    atomic_init(&state.done, false);
+    pthread_t readers[TEST_DICTIONARY_READERS];
+    for (udword i = 0; i < TEST_DICTIONARY_READERS; i++)
+        if (pthread_create(&readers[i], NULL, test_dictionary_reader, &state) != 0)
+            fatalf(__func__, "unable to create a thread\n");
+    // every publication frees the image it replaces before returning, however busy the readers
+    uqword const images = dictionary_image_count();
+    udword       leaked = 0;
+    for (udword i = 0; i < TEST_DICTIONARY_SWAPS; i++) {
+        dictionary_publish(&dict, dictionary_build(text.data, text.length));
+        leaked += dictionary_image_count() != images;
+        sched_yield();
+    }
+    if (leaked != 0)
+        warnf(__func__, "%u of %u publications left the image they replaced alive\n", leaked, TEST_DICTIONARY_SWAPS);
+    while (atomic_load(&state.passes) < TEST_DICTIONARY_READERS)
+        sched_yield();
+    atomic_store(&state.done, true);
+    for (udword i = 0; i < TEST_DICTIONARY_READERS; i++)
+        pthread_join(readers[i], NULL);
+    if (atomic_load(&state.failures) != 0)
+        warnf(__func__, "%llu of %llu passes failed during swaps\n", (unsigned long long) atomic_load(&state.failures),
+              (unsigned long long) atomic_load(&state.passes));
+
+    dictionary_free(&dict);
+    workload_text_free(&operands);
+    workload_text_free(&text);
+    info(__func__, "dictionary test complete\n");
+}
+
+#define TEST_EPOCH_THREADS 2
+#define TEST_EPOCH_SWAPS 20000
+#define TEST_EPOCH_MAGIC 0x45504f43484e4f44ull
+
+typedef struct test_epoch_node {
+    uqword magic;
+    uqword value;
+} test_epoch_node;
+
+typedef struct test_epoch_state {
+    _Atomic(test_epoch_node *) root;
+    atomic_bool                done;
+    _Atomic uqword             released;
+    _Atomic uqword             faults;
+} test_epoch_state;
+
+static void test_epoch_release(void *owner, void **objects, uqword count) {
+    test_epoch_state *state = owner;
+    if (count == 0 || count > 64)
+        atomic_fetch_add(&state->faults, 1);
+    for (uqword i = 0; i < count; i++) {
+        ((test_epoch_node *) objects[i])->magic = 0;
+        free(objects[i]);
+    }
+    atomic_fetch_add(&state->released, count);
+}
+
+static void test_epoch_release_trie(void *owner, void **tries, uqword count) {
+    for (uqword i = 0; i < count; i++)
+        btt_free(tries[i]);
+    atomic_fetch_add((_Atomic uqword *) owner, count);
+}
+
+static void *test_epoch_writer(void *argument) {
+    test_epoch_state *state = argument;
+    for (uqword i = 0; i < TEST_EPOCH_SWAPS; i++) {
+        test_epoch_node *node = malloc(sizeof(test_epoch_node));
+        *node = (test_epoch_node) {TEST_EPOCH_MAGIC, i};
+        m_epoch_retire(atomic_exchange(&state->root, node), test_epoch_release, state);
+    }
+    return NULL;
+}
+
+/*
+ * Reads the root until the writers are done; odd readers stay in one critical section and declare quiescent states.
+ */
+static void *test_epoch_reader(void *argument) {
+    test_epoch_state *state = ((void **) argument)[0];
+    bool const        long_running = ((uintptr_t) ((void **) argument)[1]) & 1u;
+    if (long_running)
+        m_epoch_enter();
+    while (!atomic_load(&state->done)) {
+        if (!long_running)
+            m_epoch_enter();
+        test_epoch_node const *node = atomic_load(&state->root);
+        if (node->magic != TEST_EPOCH_MAGIC)
+            atomic_fetch_add(&state->faults, 1);
+        if (long_running)
+            m_epoch_quiescent();
+        else
+            m_epoch_exit();
+    }
+    if (long_running)
+        m_epoch_exit();
+    return NULL;
+}
+
+static void test_epoch(void) {
+    info(__func__, "beginning epoch reclamation test\n");
+
+    test_epoch_state state = {.released = 0, .faults = 0};
+    test_epoch_node *first = malloc(sizeof(test_epoch_node));
+    *first = (test_epoch_node) {TEST_EPOCH_MAGIC, 0};
+    atomic_init(&state.root, first);
+    atomic_init(&state.done, false);
+
+    pthread_t writers[TEST_EPOCH_THREADS], readers[TEST_EPOCH_THREADS];
+    void     *arguments[TEST_EPOCH_THREADS][2];
+    for (udword i = 0; i < TEST_EPOCH_THREADS; i++) {
+        arguments[i][0] = &state;
+        arguments[i][1] = (void *) (uintptr_t) i;
+        if (pthread_create(&readers[i], NULL, test_epoch_reader, arguments[i]) != 0 ||
+            pthread_create(&writers[i], NULL, test_epoch_writer, &state) != 0)
+            fatalf(__func__, "unable to create a thread\n");
+    }
+    for (udword i = 0; i < TEST_EPOCH_THREADS; i++)
+        pthread_join(writers[i], NULL);
+    atomic_store(&state.done, true);
+    for (udword i = 0; i < TEST_EPOCH_THREADS; i++)
+        pthread_join(readers[i], NULL);
+
+    // the writers have exited, so what they left in limbo is released here
+    m_epoch_synchronize();
+    uqword const retired = TEST_EPOCH_SWAPS * TEST_EPOCH_THREADS;
+    if (atomic_load(&state.released) != retired)
+        warnf(__func__, "released %llu of %llu retired nodes\n", (unsigned long long) atomic_load(&state.released),
+              (unsigned long long) retired);
+    if (atomic_load(&state.faults) != 0)
+        warnf(__func__, "%llu reads of released nodes or bad batches\n", (unsigned long long) atomic_load(&state.faults));
+    free(atomic_load(&state.root));
+
+    // a single retirement is released by the retiring thread's own critical sections, with no further retirements
+    test_epoch_state rare = {.released = 0, .faults = 0};
+    test_epoch_node *node = malloc(sizeof(test_epoch_node));
+    *node = (test_epoch_node) {TEST_EPOCH_MAGIC, 0};
+    m_epoch_retire(node, test_epoch_release, &rare);
+    for (udword i = 0; i < 4 && atomic_load(&rare.released) == 0; i++) {
+        m_epoch_enter();
+        m_epoch_exit();
+    }
+    if (atomic_load(&rare.released) != 1)
+        warnf(__func__, "a lone retired node was not released by the critical sections after it\n");
+
+    // a few retirements, fewer than a batch, are all released by m_epoch_synchronize
+    for (udword i = 0; i < 5; i++) {
+        node = malloc(sizeof(test_epoch_node));
+        *node = (test_epoch_node) {TEST_EPOCH_MAGIC, i};
+        m_epoch_retire(node, test_epoch_release, &rare);
+    }
+    m_epoch_synchronize();
+    if (atomic_load(&rare.released) != 6)
+        warnf(__func__, "released %llu of 6 retired nodes after synchronizing\n",
+              (unsigned long long) atomic_load(&rare.released));
+
+    // a trie retired inside a critical section outlives it, and is freed once it has ended
+    _Atomic uqword tries = 0;
+    uqword_pair    pair = {1, 1};
+    m_epoch_enter();
+    m_epoch_retire(btt_create(&pair, 16, 1), test_epoch_release_trie, (void *) &tries);
+    btt_retire(btt_create(&pair, 16, 1));
+    if (atomic_load(&tries) != 0)
+        warnf(__func__, "a trie was freed inside the critical section it was retired in\n");
+    m_epoch_exit();
+    m_epoch_synchronize();
+    if (atomic_load(&tries) != 1)
+        warnf(__func__, "a retired trie was not freed after synchronizing\n");
+    info(__func__, "epoch reclamation test complete\n");
+}
+
+typedef struct test_tasks_fibonacci {
+    uqword n;
+    uqword result;
+} test_tasks_fibonacci;
+
+static void test_tasks_fibonacci_task(void *argument) {
+    test_tasks_fibonacci *fibonacci = argument;
+    if (fibonacci->n < 12) {
+        uqword previous = 0, current = 1;
+        for (uqword i = 0; i < fibonacci->n; i++) {
+            uqword const next = previous + current;
+            previous = current;
+            current = next;
+        }
+        fibonacci->result = previous;
+        return;
+    }
+
+    test_tasks_fibonacci first = {fibonacci->n - 1}, second = {fibonacci->n - 2};
+    task_group           group = TASK_GROUP_INIT;
+    task_spawn(&group, test_tasks_fibonacci_task, &first);
+    test_tasks_fibonacci_task(&second);
+    task_sync(&group);
+    fibonacci->result = first.result + second.result;
+}
+
+static void test_tasks_visit(uqword from, uqword to, void *argument) {
+    _Atomic ubyte *visits = argument;
+    for (uqword i = from; i < to; i++)
+        atomic_fetch_add_explicit(&visits[i], 1, memory_order_relaxed);
+}
+
+static void test_tasks(void) {
+    info(__func__, "beginning task test\n");
+    infof(__func__, "%u workers\n", task_workers());
+
+    test_tasks_fibonacci fibonacci = {30};
+    uqword const         start = p_get_time(NANOSECONDS);
+    test_tasks_fibonacci_task(&fibonacci);
+    infof(__func__, "fibonacci(30) by fork-join: %.2f ms\n", (double) (p_get_time(NANOSECONDS) - start) / 1e6);
+    if (fibonacci.result != 832040)
+        warnf(__func__, "fibonacci(30) is %llu, not 832040\n", (unsigned long long) fibonacci.result);
+
+    // every index is visited exactly once, whatever the grain
+    uqword const   count = 1000003;
+    _Atomic ubyte *visits = calloc(count, sizeof(_Atomic ubyte));
+    uqword const   grains[] = {0, 1, 1000, count};
+    for (uqword g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+        task_parallel_for(0, count, grains[g], test_tasks_visit, visits);
+        for (uqword i = 0; i < count; i++) {
+            if (atomic_load(&visits[i]) != g + 1) {
+                warnf(__func__, "grain %llu visited index %llu %u times\n", (unsigned long long) grains[g],
+                      (unsigned long long) i, (udword) atomic_load(&visits[i]) - (udword) g);
+                break;
+            }
+        }
+    }
+    free(visits);
+    info(__func__, "task test complete\n");
+}
+
+static void *test_compiler_metrics_thread(void *argument) {
+    context *c = argument;
+    for (uqword i = 0; i < 500; i++) {
+        context_count(c, C_DICTIONARY_LOOKUPS, 1);
+        context_count(c, i % 5 != 0 ? C_DICTIONARY_HITS : C_DICTIONARY_MISSES, 1);
+        context_time(c, C_PHASE_LOOKUP, 3000);
+    }
+    return NULL;
+}
+
+static void test_compiler_metrics(void) {
+    info(__func__, "beginning compiler metrics test\n");
+    context c;
+    context_init(&c);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, test_compiler_metrics_thread, &c) != 0) {
+        warnf(__func__, "unable to create a thread\n");
+        return;
+    }
+    for (uqword i = 0; i < 1000; i++) {
+        context_count(&c, C_TOKENS_LEXED, 2);
+        context_time(&c, C_PHASE_LEX, i + 1);
+    }
+    pthread_join(thread, NULL);
+
+    c_metrics metrics;
+    context_metrics(&c, &metrics);
+    if (metrics.counters[C_TOKENS_LEXED] != 2000 || metrics.counters[C_DICTIONARY_LOOKUPS] != 500 ||
+        metrics.counters[C_DICTIONARY_HITS] != 400 || metrics.counters[C_DICTIONARY_MISSES] != 100)
+        warnf(__func__, "counters do not add up over threads\n");
+    // 3000 ns is at most 2^12 ns; lexing times of 1 to 1000 ns fill buckets 0 to 10
+    if (metrics.latency[C_PHASE_LOOKUP][12] != 500 || metrics.latency_nanoseconds[C_PHASE_LOOKUP] != 1500000)
+        warnf(__func__, "lookup latencies are in the wrong bucket\n");
+    uqword lexed = 0;
+    for (udword i = 0; i <= 10; i++)
+        lexed += metrics.latency[C_PHASE_LEX][i];
+    if (lexed != 1000 || metrics.latency[C_PHASE_LEX][10] != 488 || metrics.latency_nanoseconds[C_PHASE_LEX] != 500500)
+        warnf(__func__, "lexing latencies are in the wrong buckets\n");
+
+    if (!context_write_prometheus(&c, "test_compiler_metrics.prom")) {
+        warnf(__func__, "unable to write test_compiler_metrics.prom\n");
+    } else {
+        FILE  *file = fopen("test_compiler_metrics.prom", "r");
+        char   line[256];
+        bool   tokens = false, lookups = false;
+        while (file != NULL && fgets(line, sizeof(line), file) != NULL) {
+            tokens |= strcmp(line, "aquinas_tokens_lexed_total 2000\n") == 0;
+            lookups |= strcmp(line, "aquinas_phase_duration_seconds_count{phase=\"lookup\"} 500\n") == 0;
+        }
+        if (file != NULL)
+            fclose(file);
+        if (!tokens || !lookups)
+            warnf(__func__, "test_compiler_metrics.prom is missing samples\n");
+    }
+    context_free(&c);
+    info(__func__, "compiler metrics test complete\n");
+}
+
+static void test_trace(void) {
+    info(__func__, "beginning trace test\n");
+    uqword const count = 100000;
+
+    trace_reset();
+    trace_start();
+    trace_thread_name("main");
+
+    set_context("test_trace");
+    uqword const start = p_get_time(NANOSECONDS);
+    for (uqword i = 0; i < count; i++) {
+        trace_scope("iteration");
+        trace_counter("iteration", (qword) i);
+        if ((i & 0xFFFu) == 0)
+            trace_instant("checkpoint");
+    }
+    uqword const recorded = p_get_time(NANOSECONDS);
+    clear_context();
+    trace_stop();
+
+    // begin, counter and end per iteration
+    infof(__func__, "record: %.1f ns per event\n", (double) (recorded - start) / (double) (3 * count));
+
+    uqword const before_disabled = p_get_time(NANOSECONDS);
+    for (uqword i = 0; i < count; i++) {
+        trace_scope("iteration");
+        trace_counter("iteration", (qword) i);
+    }
+    infof(__func__, "disabled: %.1f ns per event\n",
+          (double) (p_get_time(NANOSECONDS) - before_disabled) / (double) (2 * count));
+
+    if (!trace_write("test_trace.json"))
+        warnf(__func__, "unable to write test_trace.json\n");
+    else
+        info(__func__, "wrote test_trace.json\n");
+    info(__func__, "trace test complete\n");
+}
+
+static void test_allocation_profile(void) {
+    info(__func__, "beginning allocation profile test\n");
+    uqword const count = 1000;
+
+    m_profile_reset();
+    m_profile_start(1);
+    push_context("allocation_profile");
+    for (uqword i = 0; i < count; i++)
+        dynarray_free(dynarray_create((uint32_t) (i + 1)));
+    pop_context();
+    m_profile_stop();
+
+    // allocations after stopping are not recorded
+    dynarray_free(dynarray_create(64));
+
+    if (!m_profile_write("test_allocation_profile.folded")) {
+        warnf(__func__, "unable to write test_allocation_profile.folded\n");
+        return;
+    }
+
+    FILE *file = fopen("test_allocation_profile.folded", "r");
+    if (file == NULL) {
+        warnf(__func__, "unable to read test_allocation_profile.folded\n");
+        return;
+    }
+    char   line[4096];
+    uqword bytes = 0, sites = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char const *weight = strrchr(line, ' ');
+        if (weight == NULL || strstr(line, "allocation_profile;") == NULL || strstr(line, ";dynarray_create;") == NULL) {
+            warnf(__func__, "unexpected site: %s", line);
+            continue;
+        }
+        bytes += strtoull(weight + 1, NULL, 10);
+        sites++;
+    }
+    fclose(file);
+    m_profile_reset();
+
+    // every allocation is sampled with a period of 1, so the weights add up to the bytes allocated
+    uqword expected = 0;
+    for (uqword i = 0; i < count; i++)
+        expected += sizeof(dynarray) + ((i + 1 + sizeof(uqword) - 1) & ~(sizeof(uqword) - 1));
+    if (bytes != expected)
+        warnf(__func__, "profile holds %llu bytes; expected %llu\n", (unsigned long long) bytes,
+              (unsigned long long) expected);
+    infof(__func__, "%llu sites in test_allocation_profile.folded\n", (unsigned long long) sites);
+    info(__func__, "allocation profile test complete\n");
+}
+
+static void test_profile(void) {
+#if PLATFORM == P_LINUX || ENVIRONMENT == P_UNIX
+    info(__func__, "beginning profile test\n");
+    profile_reset();
+    if (!profile_start(4000))
+        return;
+
+    // spin for a quarter of a second of CPU time under a context of its own
+    push_context("profile");
+    uqword const start = p_get_time(NANOSECONDS);
+    uqword       value = 1;
+    while (p_get_time(NANOSECONDS) - start < 250000000u) {
+        for (uqword i = 0; i < 100000; i++)
+            value = value * 6364136223846793005u + 1442695040888963407u;
+        runner_keep(value);
+    }
+    pop_context();
+    profile_stop();
+
+    if (!profile_write("test_profile.folded")) {
+        warnf(__func__, "unable to write test_profile.folded\n");
+        return;
+    }
+    FILE *file = fopen("test_profile.folded", "r");
+    if (file == NULL) {
+        warnf(__func__, "unable to read test_profile.folded\n");
+        return;
+    }
+    char   line[8192];
+    uqword samples = 0, spinning = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char const *weight = strrchr(line, ' ');
+        uqword const count = weight != NULL ? strtoull(weight + 1, NULL, 10) : 0;
+        samples += count;
+        if (strncmp(line, "global;profile;", 15) == 0)
+            spinning += count;
+    }
+    fclose(file);
+    profile_reset();
+
+    // the timer counts CPU time, which a busy VM may hand out sparingly
+    if (spinning == 0)
+        warnf(__func__, "no sample of the spinning loop among %llu samples\n", (unsigned long long) samples);
+    infof(__func__, "%llu samples, %llu in the loop\n", (unsigned long long) samples, (unsigned long long) spinning);
+    info(__func__, "profile test complete\n");
+#endif
 }
 
 static void test_m_pointer_offset(void) {
@@ -0,0 +1,236 @@
+/*
+ * Module: workload
+ * File: workload.c
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "state.h"
+#include "workload.h"
+#include "memory/m_profile.h"
+
+// longest identifier: a letter for every 4.7 bits of a udword
+#define WORKLOAD_NAME_LENGTH 8
+
+void workload_defaults(workload_options *options) {
+    *options = (workload_options) {
+            .seed = 1,
+            .entries = 100000,
+            .depth = 8,
+            .fanout = 4,
+            .cycles = 50,
+            .operands = 10000
+    };
+}
+
+void workload_parse(workload_options *options, char const *list) {
+    static struct {
+        char const *key;
+        uqword      offset;
+    } const keys[] = {
+            {"entries",  offsetof(workload_options, entries)},
+            {"depth",    offsetof(workload_options, depth)},
+            {"fanout",   offsetof(workload_options, fanout)},
+            {"cycles",   offsetof(workload_options, cycles)},
+            {"operands", offsetof(workload_options, operands)},
+    };
+
+    while (*list != '\0') {
+        char const  *equals = strchr(list, '=');
+        char        *end;
+        if (equals == NULL)
+            fatalf(__func__, "expected key=value in '%s'\n", list);
+        uqword const value = strtoull(equals + 1, &end, 10);
+        if (end == equals + 1 || (*end != ',' && *end != '\0'))
+            fatalf(__func__, "expected a number after '%.*s='\n", (int) (equals - list), list);
+
+        uqword const key_length = (uqword) (equals - list);
+        bool         known = key_length == 4 && strncmp(list, "seed", 4) == 0;
+        if (known)
+            options->seed = value;
+        for (uqword i = 0; i < sizeof(keys) / sizeof(keys[0]) && !known; i++) {
+            if (strlen(keys[i].key) != key_length || strncmp(list, keys[i].key, key_length) != 0)
+                continue;
+            *(udword *) ((ubyte *) options + keys[i].offset) = (udword) value;
+            known = true;
+        }
+        if (!known)
+            fatalf(__func__, "unknown workload option '%.*s'\n", (int) key_length, list);
+        list = *end == ',' ? end + 1 : end;
+    }
+
+    if (options->depth == 0)
+        options->depth = 1;
+    if (options->fanout == 0)
+        options->fanout = 1;
+    if (options->cycles > 1000)
+        options->cycles = 1000;
+}
+
+/*
+ * xorshift64*; the state is never zero.
+ */
+static uqword workload_random(uqword *state) {
+    *state ^= *state >> 12u;
+    *state ^= *state << 25u;
+    *state ^= *state >> 27u;
+    return *state * 0x2545F4914F6CDD1Du;
+}
+
+static uqword workload_below(uqword *state, uqword bound) {
+    return bound != 0 ? (uqword) (((udqword) workload_random(state) * bound) >> 64u) : 0;
+}
+
+/*
+ * Writes the name of identifier `index`: a bijective mix of the index and seed in base 26, so that names are unique,
+ * vary in length and do not share long prefixes.
+ */
+static uqword workload_name(uqword seed, udword index, char *name) {
+    udword value = index ^ (udword) seed;
+    value ^= value >> 16u;
+    value *= 0x7FEB352Du;
+    value ^= value >> 15u;
+    value *= 0x846CA68Bu;
+    value ^= value >> 16u;
+
+    uqword length = 0;
+    do {
+        name[length++] = (char) ('a' + value % 26u);
+        value /= 26u;
+    } while (value != 0);
+    return length;
+}
+
+void workload_append(workload_text *text, char const *data, uqword length) {
+    if (text->length + length > text->capacity) {
+        uqword capacity = text->capacity != 0 ? text->capacity : 4096;
+        while (capacity < text->length + length)
+            capacity *= 2;
+        text->data = realloc(text->data, capacity);
+        m_profile_allocation("workload_text", capacity);
+        if (text->data == NULL)
+            fatalf(__func__, "unable to allocate %llu bytes of workload\n", (unsigned long long) capacity);
+        text->capacity = capacity;
+    }
+    memcpy(text->data + text->length, data, length);
+    text->length += length;
+}
+
+static void workload_token(workload_text *text, char const *token, uqword length, bool last) {
+    workload_append(text, token, length);
+    workload_append(text, last ? "\n" : " ", 1);
+    text->tokens++;
+}
+
+static void workload_identifier(workload_text *text, uqword seed, udword index) {
+    char         name[WORKLOAD_NAME_LENGTH];
+    uqword const length = workload_name(seed, index, name);
+    workload_token(text, name, length, false);
+}
+
+/*
+ * Roots of the forest: enough that no tree of `depth` levels holds more than its share of the entries.
+ */
+static udword workload_roots(workload_options const *options) {
+    uqword tree = 0, level = 1;
+    for (udword i = 0; i < options->depth && tree < options->entries; i++) {
+        tree += level;
+        level *= options->fanout;
+    }
+    uqword const roots = tree != 0 ? (options->entries + tree - 1) / tree : 1;
+    return roots != 0 ? (udword) roots : 1;
+}
+
+static udword workload_parent(udword index, udword roots, udword fanout) {
+    return (index - roots) / fanout;
+}
+
+void workload_dictionary(workload_options const *options, workload_text *text) {
+    udword const roots = workload_roots(options);
+    uqword       state = options->seed | 1u;
+    text->length = 0;
+    text->tokens = 0;
+
+    for (udword i = 0; i < options->entries; i++) {
+        workload_identifier(text, options->seed, i);
+        if (i < roots) {
+            workload_token(text, ";", 1, true);
+            continue;
+        }
+
+        udword const parent = workload_parent(i, roots, options->fanout);
+        workload_token(text, ":=", 2, false);
+        workload_identifier(text, options->seed, parent);
+
+        // a descendant, whose genus edges lead back up to this identifier and close a cycle; a leaf has none
+        udword whatness = i;
+        if (workload_below(&state, 1000) < options->cycles) {
+            for (uqword steps = 1 + workload_below(&state, options->depth); steps != 0; steps--) {
+                uqword const first = roots + (uqword) whatness * options->fanout;
+                if (first >= options->entries)
+                    break;
+                uqword const child = first + workload_below(&state, options->fanout);
+                whatness = (udword) (child < options->entries ? child : first);
+            }
+        }
+        if (whatness == i)
+            whatness = (udword) workload_below(&state, i);
+        workload_identifier(text, options->seed, whatness);
+        workload_token(text, ";", 1, true);
+    }
+}
+
+void workload_operands(workload_options const *options, workload_text *text) {
+    udword const roots = workload_roots(options);
+    uqword       state = (options->seed ^ 0x9E3779B97F4A7C15u) | 1u;
+    text->length = 0;
+    text->tokens = 0;
+
+    for (udword i = 0; i < options->operands && options->entries != 0; i++) {
+        uqword node = workload_below(&state, roots);
+        for (;;) {
+            workload_identifier(text, options->seed, (udword) node);
+            uqword const child = roots + node * options->fanout + workload_below(&state, options->fanout);
+            if (child >= options->entries)
+                break;
+            node = child;
+        }
+        workload_token(text, ";", 1, true);
+    }
+}
+
+uqword workload_tokenize(char const *text, uqword length) {
+    uqword tokens = 0;
+    bool   word = false;
+
+    for (uqword i = 0; i < length; i++) {
+        char const c = text[i];
+        if (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+            word = false;
+        } else if (c == ';') {
+            tokens++;
+            word = false;
+        } else if (c == ':' && i + 1 < length && text[i + 1] == '=') {
+            tokens++;
+            word = false;
+            i++;
+        } else if (!word) {
+            tokens++;
+            word = true;
+        }
+    }
+    return tokens;
+}
+
+void workload_text_free(workload_text *text) {
+    free(text->data);
+    *text = (workload_text) {0};
+}
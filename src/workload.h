@@ -0,0 +1,85 @@
+/*
+ * Module: workload
+ * File: workload.h
+ * Created:
+ * October 19, 2026
+ * Author: Andrew Porter [<caritasdedeus@gmail.com>](mailto:caritasdedeus@gmail.com)
+ *
+ * Copyright &copy; 2026 Christi Crucifixi, LLC. All rights reserved.
+ *
+ * License: See LICENSE.txt
+ *
+ * Seeded generator of synthetic Anno Domini dictionaries and operands for end-to-end benchmarks. The same options
+ * always give the same bytes. Identifiers form a forest in which every identifier is defined in terms of its genus (its
+ * parent) and a whatness, an earlier identifier; a share of the definitions instead take a descendant as their whatness,
+ * whose genus edges lead back up to them and make the dictionary graph cyclic. Operands are token strings following the
+ * genus edges from a root downwards, as the convert procedure walks them.
+ *
+ * Until the grammar settles, the terminator is ';' and the definition copula ':=' (see "Anno Domini Syntax and
+ * Semantics"):
+ *
+ *      root ;
+ *      child := root whatness ;
+ */
+
+#ifndef PROJECT_AQUINAS_WORKLOAD_H
+#define PROJECT_AQUINAS_WORKLOAD_H
+
+#include <platform.h>
+
+typedef struct workload_options {
+    uqword seed;
+    // identifiers in the dictionary
+    udword entries;
+    // levels of each genus tree; the forest has as many roots as it needs to hold every entry within them
+    udword depth;
+    // children of every identifier
+    udword fanout;
+    // definitions per thousand, of identifiers with children, whose whatness is a descendant rather than an earlier
+    // identifier, closing a directed cycle
+    udword cycles;
+    // token strings in the operand text
+    udword operands;
+} workload_options;
+
+typedef struct workload_text {
+    char  *data;
+    uqword length;
+    uqword capacity;
+    uqword tokens;
+} workload_text;
+
+/*
+ * Sets the defaults: 100000 entries of depth 8 and fanout 4, 5% cycles and 10000 operands, with seed 1.
+ */
+void workload_defaults(workload_options *options);
+
+/*
+ * Overrides options from a list such as "seed=7,entries=1000000,depth=12,fanout=8,cycles=20,operands=50000"; unknown
+ * keys are fatal.
+ */
+void workload_parse(workload_options *options, char const *list);
+
+/*
+ * Generates the dictionary into `text`, replacing its contents.
+ */
+void workload_dictionary(workload_options const *options, workload_text *text);
+
+/*
+ * Generates the operands into `text`, replacing its contents.
+ */
+void workload_operands(workload_options const *options, workload_text *text);
+
+/*
+ * Counts the tokens of Anno Domini text: words, and ';' and ":=" whether or not they are separated by whitespace.
+ */
+uqword workload_tokenize(char const *text, uqword length);
+
+/*
+ * Appends `length` bytes to `text`, growing it by doubling; the process terminates if it cannot grow.
+ */
+void workload_append(workload_text *text, char const *data, uqword length);
+
+void workload_text_free(workload_text *text);
+
+#endif //PROJECT_AQUINAS_WORKLOAD_H